@@ -0,0 +1,199 @@
+"""Compile-time benchmarks of the refu compiler.
+
+Generates a few synthetic programs, each stressing a different part of the
+compiler, compiles every one of them a number of times with
+`refu --time-passes --report-json` and reports the median time of each
+compilation phase.
+
+Usage:
+    python bench/bench.py --refu PATH [--runs N] [--scale N]
+                          [--save FILE] [--baseline FILE] [--output FILE]
+
+To compare two versions of the compiler save the results of the first one
+with --save and give the file as --baseline when running the second one.
+The report then has before/after columns for every phase.
+
+It is also run by `scons bench`, which writes the report to
+bench_output.txt. `scons bench BENCH_BASELINE=FILE BENCH_SAVE=FILE` passes
+the two files along.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+
+
+def gen_functions(scale):
+    """Many small functions and calls between them"""
+    n = 200 * scale
+    lines = []
+    for i in range(n):
+        lines.append("fn f%d(a:u32, b:u32) -> u32 { return a + b * %d }" % (i, i))
+    lines.append("fn main()->u32{")
+    lines.append("a:u32 = 1")
+    for i in range(0, n, 10):
+        lines.append("a = f%d(a, %d)" % (i, i))
+    lines.append("return 0")
+    lines.append("}")
+    return {"main.rf": "\n".join(lines) + "\n"}
+
+
+def gen_expressions(scale):
+    """Long arithmetic expressions, stressing operator precedence parsing"""
+    lines = ["fn main()->u32{", "a:u32 = 1", "b:u32 = 2", "c:u32 = 3"]
+    for i in range(300 * scale):
+        lines.append("a = a + b * %d - c / 3 + b * 2 - %d" % (i, i))
+    lines.append("return 0")
+    lines.append("}")
+    return {"main.rf": "\n".join(lines) + "\n"}
+
+
+def gen_typedecls(scale):
+    """Chained type declarations, stressing the type sets"""
+    n = 300 * scale
+    lines = ["type t0 { a:i32, b:f32 }"]
+    for i in range(1, n):
+        lines.append("type t%d { a:i32, b:f32, c:t%d }" % (i, i - 1))
+    lines.append("fn main()->u32{ return 0 }")
+    return {"main.rf": "\n".join(lines) + "\n"}
+
+
+def gen_comments(scale):
+    """Mostly whitespace and comments, stressing the lexer's skipping"""
+    lines = []
+    for i in range(2000 * scale):
+        lines.append("    // comment number %d with some text after it" % i)
+        lines.append("")
+    lines.append("fn main()->u32{ return 0 }")
+    return {"main.rf": "\n".join(lines) + "\n"}
+
+
+def gen_modules(scale):
+    """Many modules in their own files, stressing per-module processing"""
+    n = 20 * scale
+    files = {}
+    for m in range(n):
+        body = ["module m%d {" % m]
+        for i in range(10):
+            body.append("fn f%d(a:u32) -> u32 { return a + %d }" % (i, i))
+        body.append("}")
+        files["m%d.rf" % m] = "\n".join(body) + "\n"
+    main = ["import m%d" % m for m in range(n)]
+    main.append("fn main()->u32{ return 0 }")
+    files["main.rf"] = "\n".join(main) + "\n"
+    return files
+
+
+WORKLOADS = [
+    ("functions", gen_functions),
+    ("expressions", gen_expressions),
+    ("typedecls", gen_typedecls),
+    ("comments", gen_comments),
+    ("modules", gen_modules),
+]
+
+
+def read_report(stderr):
+    """Find the JSON report that --report-json prints last on stderr"""
+    for line in reversed(stderr.splitlines()):
+        line = line.strip()
+        if line.startswith("{"):
+            return json.loads(line)
+    raise RuntimeError("no --time-passes report in the compiler's output")
+
+
+def run_workload(refu, files, runs):
+    """Compile a workload `runs` times and return the median ms per phase"""
+    workdir = tempfile.mkdtemp(prefix="refu_bench_")
+    try:
+        for name, contents in files.items():
+            with open(os.path.join(workdir, name), "w") as f:
+                f.write(contents)
+        # the main file goes first, same as in the end to end tests
+        inputs = sorted(files, key=lambda n: n != "main.rf")
+        cmd = [refu, "--time-passes", "--report-json", "-o", "bench.exe"]
+        cmd.extend(inputs)
+        samples = {}
+        for _ in range(runs):
+            proc = subprocess.run(cmd, cwd=workdir, stdout=subprocess.PIPE,
+                                  stderr=subprocess.PIPE,
+                                  universal_newlines=True)
+            if proc.returncode != 0:
+                raise RuntimeError("refu failed with %d:\n%s"
+                                   % (proc.returncode, proc.stderr))
+            for phase in read_report(proc.stderr)["phases"]:
+                samples.setdefault(phase["name"], []).append(
+                    phase["wall_ns"] / 1e6)
+        return {name: statistics.median(ms) for name, ms in samples.items()}
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+
+def format_report(results, baseline):
+    out = []
+    for workload, phases in results.items():
+        before = baseline.get(workload, {})
+        out.append(workload)
+        if before:
+            out.append("  %-22s %12s %12s %9s"
+                       % ("phase", "before (ms)", "after (ms)", "change"))
+        else:
+            out.append("  %-22s %12s" % ("phase", "wall (ms)"))
+        total = sum(phases.values())
+        for name, ms in list(phases.items()) + [("total", total)]:
+            if name == "total":
+                old = sum(before.values()) if before else None
+            else:
+                old = before.get(name)
+            if old is None:
+                out.append("  %-22s %12.3f" % (name, ms))
+            else:
+                change = (ms - old) / old * 100 if old else 0.0
+                out.append("  %-22s %12.3f %12.3f %+8.1f%%"
+                           % (name, old, ms, change))
+        out.append("")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--refu", required=True,
+                        help="the refu executable to benchmark")
+    parser.add_argument("--runs", type=int, default=5,
+                        help="compilations per workload, the median is kept")
+    parser.add_argument("--scale", type=int, default=1,
+                        help="multiplies the size of every workload")
+    parser.add_argument("--save", help="write the results as JSON here")
+    parser.add_argument("--baseline",
+                        help="results saved by an earlier --save to compare with")
+    parser.add_argument("--output", help="also write the report here")
+    args = parser.parse_args()
+
+    refu = os.path.abspath(args.refu)
+    results = {}
+    for name, generate in WORKLOADS:
+        results[name] = run_workload(refu, generate(args.scale), args.runs)
+
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    report = format_report(results, baseline)
+    sys.stdout.write(report)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(report)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
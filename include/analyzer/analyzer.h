@@ -22,6 +22,8 @@ struct module;
 #define TYPES_POOL_CHUNK_SIZE 2048
 //! The size in bytes of the symbol table records memory pool
 #define RECORDS_TABLE_POOL_CHUNK_SIZE 2048
+//! The size in bytes of the memory pool of blocks, functions and other scopes' symbol tables
+#define SYMBOL_TABLES_POOL_CHUNK_SIZE 4096
 
 struct analyzer_traversal_ctx {
     struct module *m;
@@ -14,15 +14,25 @@ struct type;
 struct rir_type;
 struct rir_types_list;
 struct module;
+struct inpfile;
 
 /* -- symbol table record functionality -- */
 
 struct symbol_table_record {
-    //! The identifier string used as the key to the symbol table
+    //! The identifier string used as the key to the symbol table. Points to
+    //! the compiler's identifiers interner.
     const struct RFstring *id;
+    //! The interned ID of @ref id. This is what the symbol table is keyed on.
+    uint32_t interned_id;
+    //! Cached hash of @ref id
+    uint32_t hash;
     //! [optional] The ast node the identifier should point to
     //! Can actually be NULL.
     const struct ast_node *node;
+    //! [optional] The module whose source contains @ref node. Records are
+    //! visible from dependent modules so locations of @ref node should be
+    //! resolved against this module's file.
+    const struct module *module;
     //! Description of the type the identifier refers to
     struct type *data;
     //! The rir object used for this symbol, or NULL if not set
@@ -69,11 +79,19 @@ symbol_table_record_type(struct symbol_table_record *rec)
     return rec->data;
 }
 
+/**
+ * @return the input file that contains the record's node
+ */
+struct inpfile *symbol_table_record_file(const struct symbol_table_record *rec);
+
 /* -- symbol table functionality -- */
 
 struct symbol_table {
-    //! Hash table of symbols
+    //! Hash table of symbols. Allocates nothing until the first record is added
     struct htable table;
+    //! Number of records in @ref table. Most blocks declare nothing, and
+    //! lookups go past such tables without probing them
+    unsigned int records_num;
     //! Pointer to the parent symbol table, or NULL if this is the top table
     struct symbol_table *parent;
     //! Pointer to the module of this symbol table. Used only from the top symbol
@@ -91,6 +109,16 @@ bool symbol_table_init(struct symbol_table *t, struct module *m);
 bool root_symbol_table_init(struct symbol_table *t);
 void symbol_table_deinit(struct symbol_table *t);
 
+/**
+ * Symbol tables as used by the AST nodes that own one. Tables of a module's
+ * scopes come from the module's symbol tables pool, so that the many
+ * blocks without any declarations cost no heap allocation.
+ */
+struct symbol_table *symbol_table_create(struct module *m);
+struct symbol_table *root_symbol_table_create();
+//! Destroy a symbol table created by one of the above. Accepts NULL.
+void symbol_table_destroy(struct symbol_table *t);
+
 /**
  * Add a node to the symbol table and also set its type
  */
@@ -115,6 +143,14 @@ bool symbol_table_add_record(struct symbol_table *t,
 const struct ast_node *symbol_table_lookup_node(struct symbol_table *t,
                                                 const struct RFstring *id,
                                                 bool *at_first_symbol_table);
+/**
+ * Same as symbol_table_lookup_node() but with the key given as in
+ * symbol_table_lookup_record_id()
+ */
+const struct ast_node *symbol_table_lookup_node_id(struct symbol_table *t,
+                                                   uint32_t id,
+                                                   uint32_t hash,
+                                                   bool *at_first_symbol_table);
 /**
  * Lookup a record in a symbol table
  *
@@ -128,6 +164,26 @@ const struct ast_node *symbol_table_lookup_node(struct symbol_table *t,
 struct symbol_table_record *symbol_table_lookup_record(const struct symbol_table *t,
                                                        const struct RFstring *id,
                                                        bool *at_first_symbol_table);
+/**
+ * Arguments are just like @ref symbol_table_lookup_record() but with the
+ * hash of @a id already known. For strings that may never have been
+ * interned, since it has to find the string's ID first. Identifier nodes
+ * should use symbol_table_lookup_record_id() instead.
+ */
+struct symbol_table_record *symbol_table_lookup_record_h(const struct symbol_table *t,
+                                                         const struct RFstring *id,
+                                                         uint32_t hash,
+                                                         bool *at_first_symbol_table);
+/**
+ * Lookup a record in a symbol table by the interned ID of its identifier.
+ * Arguments are just like @ref symbol_table_lookup_record() but the key
+ * is an ID of the compiler's identifiers interner along with its hash, as
+ * cached in identifier nodes by ast_identifier_id() and ast_identifier_hash().
+ */
+struct symbol_table_record *symbol_table_lookup_record_id(const struct symbol_table *t,
+                                                          uint32_t id,
+                                                          uint32_t hash,
+                                                          bool *at_first_symbol_table);
 
 /**
 s * Lookup a typedesc node in a symbol table. This function is to be used only
@@ -6,6 +6,9 @@
 
 struct type;
 struct rir_type;
+struct ast_node;
+struct module;
+struct symbol_table;
 struct rf_fixed_memorypool;
 
 i_INLINE_DECL const void *type_objset_key(const struct type *t)
@@ -44,6 +47,21 @@ struct type *type_objset_has_convertable(const struct rf_objset_type *set,
  */
 struct type *type_objset_has_uid(const struct rf_objset_type *set, size_t uid);
 
+/**
+ * Find the type of a type description in the set through the description's
+ * uid, as given by type_uid_from_ast_node(). Types with the same uid are told
+ * apart by comparing them to the description.
+ *
+ * Arguments after @a uid are just like for type_equals_ast_node()
+ * @return            The type in the set or NULL if there is none
+ */
+struct type *type_objset_has_ast_node(const struct rf_objset_type *set,
+                                      size_t uid,
+                                      const struct ast_node *desc,
+                                      struct module *mod,
+                                      struct symbol_table *st,
+                                      struct ast_node *genrdecl);
+
 /**
  * Check if a type description as a string has a corresponding type in the set
  *
@@ -51,6 +69,10 @@ struct type *type_objset_has_uid(const struct rf_objset_type *set, size_t uid);
  * @param desc        The string description of a type to check if it already
  *                    exists in the set. The string description has to be
  *                    in the canonical way that type_str() would output it.
+ *
+ * @note Type uids are structural and not hashes of the type's string, so
+ *       this compares the string of every type in the set. Prefer
+ *       type_objset_has_uid().
  */
 struct type *type_objset_has_string(const struct rf_objset_type *set, const struct RFstring *desc);
 
@@ -1,9 +1,14 @@
 #ifndef LFR_AST_H
 #define LFR_AST_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <RFintrusive_list.h>
 #include <RFstring.h>
 #include <Utils/bits.h>
+#include <Utils/log.h>
 
 #include <inplocation.h>
 #include <ast/type_decls.h>
@@ -24,6 +29,8 @@
 
 #include <analyzer/symbol_table.h>
 
+struct arena;
+
 /**
  * Performs an assert on the type of the AST node in debug mode
  */
@@ -45,7 +52,8 @@
 #define AST_PRINT_DEPTHMUL 4
 
 struct ast_root {
-    struct symbol_table st;
+    //! Symbol table of the file. Owned, created right after parsing
+    struct symbol_table *st;
 };
 
 enum ast_type {
@@ -93,12 +101,23 @@ enum ast_node_state {
 };
 
 struct ast_node {
-    enum ast_type type;
-    enum ast_node_state state;
+    enum ast_type type:8;
+    enum ast_node_state state:8;
+    //! True if the node lives in an arena and must not be freed on its own
+    bool in_arena:1;
+    //! True if the children array lives in an arena
+    bool children_in_arena:1;
+    //! Number of children of the node
+    uint32_t children_num;
     const struct type *expression_type;
     struct inplocation location;
-    struct RFilist_node lh;
-    struct RFilist_head children;
+    //! Contiguous array of the node's children. Its capacity is implied by
+    //! children_num, see ast_node_add_child()
+    struct ast_node **children;
+    /*
+     * Type specific data. Nodes are allocated only as big as the member
+     * for their type so this must always be the last member of the struct
+     */
     union {
         struct ast_root root;
         struct ast_block block;
@@ -129,6 +148,11 @@ struct ast_node {
     };
 };
 
+/**
+ * @return The number of bytes a node of type @a type occupies. Nodes are
+ * allocated only as big as needed for the data of their type.
+ */
+size_t ast_node_size(enum ast_type type);
 void ast_node_init(struct ast_node *n, enum ast_type type);
 struct ast_node *ast_node_create(enum ast_type type);
 
@@ -141,19 +165,60 @@ struct ast_node *ast_node_create_ptrs(enum ast_type type,
                                       struct inpfile *f,
                                       char *sp, char *ep);
 
+/**
+ * Destroy a node and all of its children.
+ *
+ * Any out of line data owned by the nodes is released. Nodes that were
+ * allocated from an arena are not freed, their memory goes away with
+ * the arena.
+ */
 void ast_node_destroy(struct ast_node *n);
+
+/**
+ * Set the arena from which all subsequently created AST nodes of the calling
+ * thread are allocated
+ *
+ * @param a         The arena to use or NULL to go back to using malloc
+ * @return          The previously set arena, so that it can be restored
+ */
+struct arena *ast_arena_set(struct arena *a);
+
 /**
- * Destroy node if it's a token generated ast node and needs
- * to be destroyed during lexer destruction.
+ * @return          The number of nodes the calling thread created minus the
+ *                  number of nodes it destroyed, counting arena nodes too.
+ *                  Meant for checking that code does not leak nodes.
  */
-void ast_node_destroy_from_lexer(struct ast_node *n);
+int64_t ast_nodes_live();
 
 void ast_node_set_start(struct ast_node *n, const struct inplocation_mark *start);
 void ast_node_set_end(struct ast_node *n, const struct inplocation_mark *end);
 
-void ast_node_add_child(struct ast_node *parent,
+/**
+ * Append @a child to the children of @a parent.
+ *
+ * Children are kept in a contiguous array whose capacity doubles each time
+ * the number of children reaches a power of two.
+ *
+ * @return            true for success and false if the array could not grow.
+ *                    In that case @a parent is unchanged and the caller
+ *                    still owns @a child.
+ */
+bool ast_node_add_child(struct ast_node *parent,
                         struct ast_node *child);
 
+/**
+ * Same as ast_node_add_child() but exits on failure. For nodes that get
+ * their few children at creation, where a half built node can't be undone.
+ */
+i_INLINE_DECL void ast_node_add_child_or_die(struct ast_node *parent,
+                                             struct ast_node *child)
+{
+    if (!ast_node_add_child(parent, child)) {
+        RF_CRITICAL("ast_node_add_child() failure");
+        exit(1);
+    }
+}
+
 /**
  * Depending on the node type, it finds the child node
  * that identifies it and returns the string of the identifier
@@ -171,44 +236,29 @@ const struct RFstring * ast_node_get_name_str(const struct ast_node *n);
 #define ast_node_register_child(parent_, child_, position_) \
     do {                                                    \
         if (child_) {                                       \
-            ast_node_add_child(parent_, child_);            \
+            ast_node_add_child_or_die(parent_, child_);     \
         }                                                   \
         (parent_)->position_ = child_;                      \
     } while (0)
 
+/**
+ * Iterate over all children of node @a n_ assigning each one to @a child_
+ */
+#define ast_node_foreach_child(n_, child_)                              \
+    for (struct ast_node **i_child_it_ = (n_)->children;                \
+         i_child_it_ < (n_)->children + (n_)->children_num &&           \
+             ((child_) = *i_child_it_, true);                           \
+         ++i_child_it_)
+
 i_INLINE_DECL struct ast_node *ast_node_get_child(struct ast_node *n,
                                                   unsigned int num)
 {
-    struct ast_node *child;
-    rf_ilist_for_each(&n->children, child, lh) {
-        if (num == 0) {
-            return child;
-        }
-        num--;
-    }
-
-    return NULL;
+    return num < n->children_num ? n->children[num] : NULL;
 }
 
 i_INLINE_DECL unsigned int ast_node_get_children_number(const struct ast_node *n)
 {
-    struct ast_node *child;
-    unsigned int num = 0;
-    rf_ilist_for_each(&n->children, child, lh) {
-        ++num;
-    }
-
-    return num;
-}
-
-i_INLINE_DECL const char *ast_node_startsp(const struct ast_node *n)
-{
-    return n->location.start.p;
-}
-
-i_INLINE_DECL const char *ast_node_endsp(const struct ast_node *n)
-{
-    return n->location.end.p;
+    return n->children_num;
 }
 
 i_INLINE_DECL const struct inplocation *ast_node_location(const struct ast_node *n)
@@ -278,10 +328,12 @@ struct symbol_table *ast_node_symbol_table_get(struct ast_node *n);
 /* -- ast_root functions -- */
 struct ast_node *ast_root_create(struct inpfile *file);
 
+bool ast_root_symbol_table_init(struct ast_node *n);
+
 i_INLINE_DECL struct symbol_table *ast_root_symbol_table_get(struct ast_node *n)
 {
     AST_NODE_ASSERT_TYPE(n, AST_ROOT);
-    return &n->root.st;
+    return n->root.st;
 }
 
 
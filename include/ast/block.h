@@ -10,18 +10,25 @@ i_INLINE_DECL bool ast_block_symbol_table_init(struct ast_node *n,
                                                struct module *m)
 {
     AST_NODE_ASSERT_TYPE(n, AST_BLOCK);
-    return symbol_table_init(&n->block.st, m);
+    n->block.st = symbol_table_create(m);
+    return n->block.st;
 }
 
 i_INLINE_DECL struct symbol_table* ast_block_symbol_table_get(struct ast_node *n)
 {
     AST_NODE_ASSERT_TYPE(n, AST_BLOCK);
-    return &n->block.st;
+    return n->block.st;
 }
 
-i_INLINE_DECL void ast_block_add_element(struct ast_node *n, struct ast_node *element)
+/**
+ * Add an element to a block
+ *
+ * @return           true for success and false for failure, in which case
+ *                   the caller still owns @a element
+ */
+i_INLINE_DECL bool ast_block_add_element(struct ast_node *n, struct ast_node *element)
 {
     AST_NODE_ASSERT_TYPE(n, AST_BLOCK);
-    ast_node_add_child(n, element);
+    return ast_node_add_child(n, element);
 }
 #endif
@@ -7,7 +7,7 @@ struct inplocation_mark;
 #include <analyzer/symbol_table.h>
 
 struct ast_block {
-    //! The block's symbol table. Only initialized in the analyzer phase
-    struct symbol_table st;
+    //! The block's symbol table. Owned. Only created in the analyzer phase
+    struct symbol_table *st;
 };
 #endif
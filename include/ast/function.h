@@ -29,13 +29,14 @@ i_INLINE_DECL bool ast_fndecl_symbol_table_init(struct ast_node *n,
                                                 struct module *m)
 {
     AST_NODE_ASSERT_TYPE(n, AST_FUNCTION_DECLARATION);
-    return symbol_table_init(&n->fndecl.st, m);
+    n->fndecl.st = symbol_table_create(m);
+    return n->fndecl.st;
 }
 
 i_INLINE_DECL struct symbol_table *ast_fndecl_symbol_table_get(struct ast_node *n)
 {
     AST_NODE_ASSERT_TYPE(n, AST_FUNCTION_DECLARATION);
-    return &n->fndecl.st;
+    return n->fndecl.st;
 }
 
 i_INLINE_DECL struct ast_node *ast_fndecl_genrdecl_get(const struct ast_node *n)
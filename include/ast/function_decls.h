@@ -34,7 +34,8 @@ struct ast_fndecl {
     //! Only initialized in analyzer phase.
     //! Not using top level type descriptions with their own symbol tables since
     //! having it here makes it easier to combine symbol from both args and return
-    struct symbol_table st;
+    //! Owned, and shared with the function's implementation if there is one.
+    struct symbol_table *st;
 };
 
 struct ast_fnimpl {
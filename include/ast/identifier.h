@@ -14,11 +14,28 @@ struct module;
 
 struct ast_identifier {
     struct RFstring string;
+    //! ID of the identifier's string in the compiler's identifiers interner
+    uint32_t id;
+    //! Cached hash of the identifier's string
     uint32_t hash;
 };
 
 
-struct ast_node *ast_identifier_create(struct inplocation *loc);
+struct inpfile;
+
+/**
+ * Create an identifier node whose string points to the location @c loc
+ * inside the input file @c f
+ */
+struct ast_node *ast_identifier_create(struct inplocation *loc,
+                                       struct inpfile *f);
+/**
+ * Same as ast_identifier_create() but for an identifier whose string has
+ * already been interned with ID @c id, for example by the lexer
+ */
+struct ast_node *ast_identifier_create_interned(struct inplocation *loc,
+                                                struct inpfile *f,
+                                                uint32_t id);
 void ast_identifier_print(struct ast_node *n, int depth);
 
 /**
@@ -41,7 +58,20 @@ bool string_is_wildcard(const struct RFstring *s);
  */
 bool ast_identifier_is_wildcard(const struct ast_node *n);
 
-bool ast_identifier_hash_create(struct ast_node *n, struct module *m);
+/**
+ * Point the identifier's string to its interned copy, disassociating
+ * it from the input file
+ */
+void ast_identifier_intern(struct ast_node *n);
+
+/**
+ * @return The interned ID of an identifier or xidentifier's string
+ */
+uint32_t ast_identifier_id(const struct ast_node *n);
+/**
+ * @return The cached hash of an identifier or xidentifier's string
+ */
+uint32_t ast_identifier_hash(const struct ast_node *n);
 
 /* -- xidentifier -- */
 
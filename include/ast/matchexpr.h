@@ -167,11 +167,17 @@ const struct RFstring *ast_matchexpr_matched_value_str(const struct ast_node *n)
  */
 bool ast_matchexpr_cases_indices_set(struct ast_node *n);
 
-void ast_matchexpr_add_case(struct ast_node *n, struct ast_node *mcase);
+/**
+ * Add a case to a match expression
+ *
+ * @return           true for success and false for failure, in which case
+ *                   the caller still owns @a mcase
+ */
+bool ast_matchexpr_add_case(struct ast_node *n, struct ast_node *mcase);
 
 struct ast_matchexpr_it {
-    const struct RFilist_head *lh;
-    const struct RFilist_node *ln;
+    //! Index of the current case among the match expression's children
+    unsigned int idx;
 };
 
 /**
@@ -32,10 +32,18 @@ struct ast_node *ast_module_create(const struct inplocation_mark *start,
                                    struct ast_node *name,
                                    struct ast_node *args);
 
+i_INLINE_DECL bool ast_module_symbol_table_init(struct ast_node *n,
+                                                struct module *m)
+{
+    AST_NODE_ASSERT_TYPE(n, AST_MODULE);
+    n->module.st = symbol_table_create(m);
+    return n->module.st;
+}
+
 i_INLINE_DECL struct symbol_table *ast_module_symbol_table_get(struct ast_node *n)
 {
     AST_NODE_ASSERT_TYPE(n, AST_MODULE);
-    return &n->module.st;
+    return n->module.st;
 }
 
 i_INLINE_DECL const struct RFstring *ast_module_name(const struct ast_node *n)
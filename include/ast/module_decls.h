@@ -18,7 +18,7 @@ struct ast_module {
     struct ast_node *name;
     //! If the module has arguments, this contains their type description. If not NULL.
     struct ast_node *args;
-    //! Symbol table of the module's arguments and of its contents
-    struct symbol_table st;
+    //! Symbol table of the module's arguments and of its contents. Owned.
+    struct symbol_table *st;
 };
 #endif
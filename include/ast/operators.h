@@ -14,7 +14,7 @@ struct ast_node *ast_binaryop_create(const struct inplocation_mark *start,
 i_INLINE_DECL void ast_binaryop_set_right(struct ast_node *op, struct ast_node *r)
 {
     AST_NODE_ASSERT_TYPE(op, AST_BINARY_OPERATOR);
-    ast_node_add_child(op, r);
+    ast_node_add_child_or_die(op, r);
     op->binaryop.right = r;
     ast_node_set_end(op, ast_node_endmark(r));
 }
@@ -42,6 +42,18 @@ const struct RFstring *ast_binaryop_opstr(const struct ast_node *op);
 
 enum binaryop_type binaryop_type_from_token(struct token *tok);
 
+/**
+ * @return           The precedence of a binary operator, from 1 for the
+ *                   loosest to the tightest. All binary operators are left
+ *                   associative.
+ */
+unsigned int ast_binaryop_precedence(enum binaryop_type op);
+/**
+ * @return           The precedence of the binary operator @a tok stands for,
+ *                   or 0 if it is not a binary operator
+ */
+unsigned int binaryop_precedence_from_token(const struct token *tok);
+
 i_INLINE_DECL struct ast_node *ast_binaryop_left(const struct ast_node *op)
 {
     AST_NODE_ASSERT_TYPE(op, AST_BINARY_OPERATOR);
@@ -8,9 +8,15 @@
 
 struct ast_node;
 struct inplocation;
+struct inpfile;
 struct module;
 
-struct ast_node *ast_string_literal_create(struct inplocation *loc);
+/**
+ * Create a string literal node whose string points inside the quotes at
+ * location @c loc of the input file @c f
+ */
+struct ast_node *ast_string_literal_create(struct inplocation *loc,
+                                           struct inpfile *f);
 bool ast_string_literal_hash_create(struct ast_node *lit, struct module *m);
 
 #include <ast/ast.h>
@@ -119,10 +119,18 @@ i_INLINE_DECL struct ast_node *ast_typeop_right(const struct ast_node *n)
 
 struct ast_node *ast_typedesc_create(struct ast_node *desc);
 
+i_INLINE_DECL bool ast_typedesc_symbol_table_init(struct ast_node *n,
+                                                  struct module *m)
+{
+    AST_NODE_ASSERT_TYPE(n, AST_TYPE_DESCRIPTION);
+    n->typedesc.st = symbol_table_create(m);
+    return n->typedesc.st;
+}
+
 i_INLINE_DECL struct symbol_table *ast_typedesc_symbol_table_get(struct ast_node *n)
 {
     AST_NODE_ASSERT_TYPE(n, AST_TYPE_DESCRIPTION);
-    return &n->typedesc.st;
+    return n->typedesc.st;
 }
 
 i_INLINE_DECL struct ast_node *ast_typedesc_desc_get(const struct ast_node *n)
@@ -18,8 +18,8 @@ struct ast_typeop {
  */
 struct ast_typedesc {
     struct ast_node *desc;
-    //! Symbol table of the identifiers inside the type declaration
-    struct symbol_table st;
+    //! Symbol table of the identifiers inside the type declaration. Owned.
+    struct symbol_table *st;
 };
 
 struct ast_typeleaf {
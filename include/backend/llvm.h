@@ -4,8 +4,12 @@
 #include <stdbool.h>
 
 struct RFilist_head;
+struct RFstring;
 struct compiler_args;
+struct front_ctx;
+struct LLVMOpaqueModule;
 struct modules_arr;
+struct module;
 
 
 /**
@@ -18,4 +22,53 @@ struct modules_arr;
  */
 bool bllvm_generate(struct modules_arr *modules, struct compiler_args *args);
 
+/**
+ * Generate only the LLVM IR of the modules, in the "<output>.ll" file
+ *
+ * The stdlib comes from the compiler's stdlib image, if one was loaded, or
+ * is generated from its RIR.
+ *
+ * Each module other than the stdlib gets its own LLVM module, which is
+ * linked into the program at the end. With a compilation cache the LLVM
+ * bitcode of each module is taken from the cache under the module's key,
+ * or stored there after it is generated.
+ */
+bool bllvm_generate_ir(struct modules_arr *modules, struct compiler_args *args);
+
+/**
+ * Write the LLVM bitcode of the standard library module to the file given
+ * with --emit-stdlib-image. When that file exists at the stdlib's location
+ * bllvm_generate_ir() loads it instead of generating the stdlib's IR.
+ *
+ * The image is stamped with bllvm_stdlib_stamp() and is only loaded while
+ * the stamp matches the stdlib source and the compiler version.
+ */
+bool bllvm_emit_stdlib_image(struct module *stdlib, struct compiler_args *args);
+
+/**
+ * Get the stamp of a stdlib image generated from the given stdlib source by
+ * this compiler build. It holds the version, the build identity and a hash
+ * of the source.
+ * Should be enclosed in RFS_PUSH() / RFS_POP()
+ */
+const struct RFstring *bllvm_stdlib_stamp(const struct front_ctx *stdlib_front);
+
+/**
+ * Load the stdlib image if it exists and its stamp matches the given stdlib
+ * source and this compiler build
+ *
+ * @param file       The bitcode file of the image
+ * @return           The LLVM module of the image, to be freed with
+ *                   bllvm_stdlib_image_destroy(), or NULL if there is no
+ *                   usable image
+ */
+struct LLVMOpaqueModule *bllvm_stdlib_image_load(const struct front_ctx *stdlib_front,
+                                                  const char *file);
+void bllvm_stdlib_image_destroy(struct LLVMOpaqueModule *image);
+
+/**
+ * Compile an existing "<output>.ll" LLVM IR file into the executable
+ */
+bool bllvm_compile_ir(struct compiler_args *args);
+
 #endif
@@ -3,12 +3,17 @@
 
 #include <stdbool.h>
 #include <RFintrusive_list.h>
+#include <Data_Structures/htable.h>
 #include <String/rf_str_core.h>
 #include <module.h>
+#include <utils/string_interner.h>
+#include <compiler_cache.h>
+#include <compiler_profile.h>
 
 struct compiler_args;
 struct serializer;
 struct rir;
+struct LLVMOpaqueModule;
 
 struct compiler {
     //! An error buffer for the compiler
@@ -22,23 +27,72 @@ struct compiler {
     struct serializer *serializer;
     //! Dynamic array to hold the memory of all created modules
     struct modules_arr modules;
+    //! Index of @a modules by name, built after parsing
+    struct htable modules_index;
     //! Sorted list of modules, after dependency resolution
     struct RFilist_head sorted_modules;
     //! Should stdlib be used or not? By default for now all main modules are using it
     bool use_stdlib;
     //! Pointer to the main front_ctxs
     struct front_ctx *main_front;
+    //! Interner of all identifiers of all fronts. Filled at lexing time
+    struct string_interner identifiers;
+    //! Interned ID of the main module's name
+    uint32_t main_name_id;
+    //! On-disk cache of compiled programs
+    struct compiler_cache cache;
+    //! Timings of the compilation phases, if requested with --time-passes
+    struct compiler_profile profile;
+    //! The standard library's front, if it was added by compiler_process()
+    struct front_ctx *stdlib_front;
+    //! True once the stdlib got all the way to RIR, which means it can be
+    //! kept for the next program
+    bool stdlib_ready;
+    //! The precompiled stdlib, loaded once by compiler_process() if it
+    //! matches @a stdlib_front. Kept along with the stdlib.
+    struct LLVMOpaqueModule *stdlib_image;
 };
 
-// a compiler will always be a unique singleton so we can get its instance
+/**
+ * Get the compiler the calling thread currently works with.
+ *
+ * Many compilers can exist at the same time, even on different threads.
+ * Every function that is given a compiler makes it the current one of the
+ * calling thread, so that the code it runs can get it from here.
+ */
 struct compiler *compiler_instance_get();
 struct compiler *compiler_alloc();
 bool compiler_init(struct compiler *c, int rf_logtype, bool with_stdlib);
 struct compiler *compiler_create(int rf_logtype, bool with_stdlib);
 struct compiler *compiler_create_with_args(int rf_logtype, bool with_stdlib, int argc, char **argv);
-void compiler_destroy();
+void compiler_destroy(struct compiler *c);
 
-struct module *compiler_module_get(const struct RFstring *name);
+/**
+ * Forget the program the compiler was given so that it can be reused for
+ * another one. Arguments can be passed again with compiler_pass_args().
+ *
+ * @param keep_stdlib    If true and the stdlib was processed by the last
+ *                       compiler_process() then its parsed, analyzed and
+ *                       lowered module is kept and reused for the next one.
+ *                       The identifiers interner is emptied only when the
+ *                       stdlib is not kept, so a kept stdlib is dropped
+ *                       anyway once the interner grows past a quarter of
+ *                       its capacity.
+ */
+bool compiler_reset(struct compiler *c, bool keep_stdlib);
+
+/**
+ * Get a module by name in O(1). Only valid after the fronts have been parsed
+ * by compiler_preprocess_fronts().
+ *
+ * @return The module or NULL if no module has this name
+ */
+struct module *compiler_module_get(struct compiler *c, const struct RFstring *name);
+
+/**
+ * @return The identifiers interner of the current compiler
+ */
+struct string_interner *compiler_identifiers();
 
 struct front_ctx *compiler_new_front(struct compiler *c,
                                      const struct RFstring *input_name);
@@ -47,21 +101,26 @@ struct front_ctx *compiler_new_front_from_source(struct compiler *c,
                                                  const struct RFstring *source);
 
 /**
- * Set a compiler's front as the main front_ctx
+ * Set a front as the main front_ctx of the current compiler
  */
 bool compiler_set_main(struct front_ctx *c);
 
 //! Passes arguments to the compiler and initializes the front end context
-bool compiler_pass_args(int argc, char **argv);
+bool compiler_pass_args(struct compiler *c, int argc, char **argv);
 
-bool compiler_preprocess_fronts();
-bool compiler_analyze();
-bool compiler_process();
+bool compiler_preprocess_fronts(struct compiler *c);
+bool compiler_analyze(struct compiler *c);
+bool compiler_process(struct compiler *c);
 
 //! Query compiler's argument and if help was requested, print help message and
 //! return true. If true, program should exit succesfully
 bool compiler_help_requested(struct compiler *c);
 
+/**
+ * Print the reports requested with --time-passes and --mem-report to stderr
+ */
+void compiler_print_reports(struct compiler *c);
+
 /**
  * Return a string with all the compiler errors/warning from all modules 
  */
@@ -32,6 +32,17 @@ struct compiler_args {
     struct arg_lit *output_ast;
     struct arg_str *output_name;
     struct arg_lit *rir_print;
+    struct arg_lit *mmap_input;
+    struct arg_lit *parser_memo;
+    struct arg_int *jobs;
+    struct arg_str *cache_dir;
+    struct arg_str *emit_stdlib_image;
+    struct arg_str *stdlib_image;
+    struct arg_str *server;
+    struct arg_str *connect;
+    struct arg_lit *time_passes;
+    struct arg_lit *mem_report;
+    struct arg_lit *report_json;
     struct arg_file *positional_file;
     struct arg_end *end;
 };
@@ -66,6 +77,56 @@ bool compiler_args_print_backend_debug(const struct compiler_args *args);
 
 bool compiler_args_print_rir(const struct compiler_args *args);
 
+/**
+ * Should input files be memory mapped instead of read into a buffer?
+ */
+bool compiler_args_mmap_input(const struct compiler_args *args);
+
+/**
+ * Should the parser memoize the productions it tries speculatively?
+ */
+bool compiler_args_parser_memo(const struct compiler_args *args);
+
+/**
+ * Get the number of threads to use for parsing and analysis. At least 1.
+ */
+unsigned compiler_args_jobs(const struct compiler_args *args);
+
+/**
+ * Get the directory of the compilation cache, or NULL if caching is off
+ */
+const char *compiler_args_cache_dir(const struct compiler_args *args);
+
+/**
+ * Get the file to write the precompiled stdlib image to, or NULL if the
+ * image was not requested
+ */
+const char *compiler_args_emit_stdlib_image(const struct compiler_args *args);
+
+/**
+ * Get the precompiled stdlib image file to load
+ */
+const char *compiler_args_stdlib_image(const struct compiler_args *args);
+
+/**
+ * Get the unix socket the compiler server should listen to, or NULL if
+ * the compiler should not run as a server
+ */
+const char *compiler_args_server(const struct compiler_args *args);
+
+/**
+ * Get the unix socket of the compiler server that should perform the
+ * compilation, or NULL if the compiler should perform it itself
+ */
+const char *compiler_args_connect(const struct compiler_args *args);
+
+//! Should the compilation phases be timed and reported?
+bool compiler_args_time_passes(const struct compiler_args *args);
+//! Should the memory pools usage of the modules be reported?
+bool compiler_args_mem_report(const struct compiler_args *args);
+//! Should the reports be printed as JSON?
+bool compiler_args_report_json(const struct compiler_args *args);
+
 /**
  * Should we output the ast?
  *
@@ -0,0 +1,119 @@
+#ifndef LFR_COMPILER_CACHE_H
+#define LFR_COMPILER_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct RFstring;
+struct RFilist_head;
+struct module;
+
+/**
+ * An on-disk cache of the LLVM code generated for a program and for each of
+ * its modules.
+ *
+ * The program entry is keyed on the name and contents of every input file,
+ * standard library included, on the compiler version and build and on the
+ * stdlib image in use. A program whose key is already in the cache skips
+ * scanning, parsing, analysis, RIR and LLVM IR generation and only goes
+ * through the assembler and linker.
+ *
+ * When the program entry misses, the LLVM bitcode of each module is looked
+ * up by the module's own key. That key covers the module's source, the
+ * compiler version and build, the stdlib image and the keys of the modules
+ * it imports, so a change in one file only regenerates the LLVM code of the
+ * modules that depend on it.
+ */
+struct compiler_cache {
+    //! The directory of the cache entries or NULL if caching is disabled.
+    //! Not owned.
+    const char *dir;
+    //! What every key starts from: the compiler version and build and the
+    //! identity of the stdlib image, if one is used
+    uint32_t seed[2];
+    //! The key of the program being compiled
+    uint32_t key[2];
+    //! Number of modules whose LLVM code was taken from the cache
+    unsigned int module_hits;
+};
+
+/**
+ * @param cache      The cache to initialize
+ * @param dir        The cache directory. Created if it does not exist. If
+ *                   NULL then the cache is disabled.
+ */
+void compiler_cache_init(struct compiler_cache *cache, const char *dir);
+
+/**
+ * @return true if the cache was given a directory
+ */
+bool compiler_cache_enabled(const struct compiler_cache *cache);
+
+/**
+ * Make all keys depend on the stdlib image that the backend will use
+ *
+ * @param cache      The cache
+ * @param stamp      The stamp of the stdlib image or NULL if the stdlib is
+ *                   generated from its source. See bllvm_stdlib_stamp()
+ */
+void compiler_cache_set_stdlib_image(struct compiler_cache *cache,
+                                     const struct RFstring *stamp);
+
+/**
+ * Compute the cache key of a program from all of its front_ctxs
+ *
+ * @param cache      The cache
+ * @param fronts     The list of front_ctxs of the program, before scanning
+ */
+void compiler_cache_set_key(struct compiler_cache *cache,
+                            struct RFilist_head *fronts);
+
+/**
+ * Compute the cache key of a module
+ *
+ * The keys of the module's dependencies must have been computed already,
+ * which is the case when going through the modules in sorted order.
+ *
+ * @param cache      The cache
+ * @param m          The module whose key to set, after its dependencies
+ *                   have been determined
+ */
+void compiler_cache_set_module_key(const struct compiler_cache *cache,
+                                   struct module *m);
+
+/**
+ * Get the file name of the cache entry for the current key.
+ * Should be enclosed in RFS_PUSH() / RFS_POP()
+ */
+const struct RFstring *compiler_cache_entry_name(const struct compiler_cache *cache);
+
+/**
+ * Get the file name of the LLVM bitcode cache entry of a module.
+ * Should be enclosed in RFS_PUSH() / RFS_POP()
+ */
+const struct RFstring *compiler_cache_module_entry_name(const struct compiler_cache *cache,
+                                                        const struct module *m);
+
+/**
+ * Get a temporary file name to write a cache entry under before renaming
+ * it to @a entry. The name is unique among all the compilations that share
+ * the cache directory, so none of them sees another's partial writes.
+ * Should be enclosed in RFS_PUSH() / RFS_POP()
+ */
+const struct RFstring *compiler_cache_tmp_name(const struct RFstring *entry);
+
+/**
+ * Copy the cached LLVM IR of the current key into @a ir_file
+ *
+ * @return           true if there was a cache entry and it was copied
+ */
+bool compiler_cache_fetch(const struct compiler_cache *cache,
+                          const struct RFstring *ir_file);
+
+/**
+ * Store the LLVM IR in @a ir_file as the cache entry of the current key
+ */
+bool compiler_cache_store(const struct compiler_cache *cache,
+                          const struct RFstring *ir_file);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef LFR_COMPILER_PROFILE_H
+#define LFR_COMPILER_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <Definitions/inline.h>
+
+struct modules_arr;
+
+//! The phases of a compilation measured by --time-passes
+enum compiler_phase {
+    COMPILER_PHASE_LEXER_SCAN = 0,
+    COMPILER_PHASE_PARSE,
+    COMPILER_PHASE_ANALYZER_FIRST_PASS,
+    COMPILER_PHASE_ANALYZER_TYPECHECK,
+    COMPILER_PHASE_ANALYZER_FINALIZE,
+    COMPILER_PHASE_CREATE_RIR,
+    COMPILER_PHASE_LLVM_IR,
+    COMPILER_PHASE_LLC,
+    COMPILER_PHASE_LINK,
+    COMPILER_PHASES_NUM
+};
+
+//! Totals of all the runs of a phase
+struct compiler_phase_stats {
+    uint64_t wall_ns;
+    //! CPU time of the thread running the phase and of the processes it ran
+    uint64_t cpu_ns;
+    //! Growth of the heap while in the phase. Approximate when other
+    //! threads allocate at the same time.
+    int64_t heap_bytes;
+    unsigned int runs;
+};
+
+//! A point in time, taken at the beginning of a phase
+struct compiler_profile_sample {
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+    int64_t heap_bytes;
+};
+
+/**
+ * Measurements of a compilation's phases. When disabled beginning and
+ * ending a phase costs a single check.
+ */
+struct compiler_profile {
+    bool enabled;
+    struct compiler_phase_stats phases[COMPILER_PHASES_NUM];
+    //! Phases of different fronts and modules may run in parallel
+    pthread_mutex_t lock;
+};
+
+/**
+ * Live and maximum number of elements of a fixed memory pool
+ */
+struct pool_usage {
+    unsigned int live;
+    unsigned int peak;
+};
+
+bool compiler_profile_init(struct compiler_profile *p);
+void compiler_profile_deinit(struct compiler_profile *p);
+//! Forget all measurements
+void compiler_profile_clear(struct compiler_profile *p);
+
+void compiler_profile_take_sample(struct compiler_profile_sample *s);
+void compiler_profile_add(struct compiler_profile *p,
+                          enum compiler_phase phase,
+                          const struct compiler_profile_sample *begin);
+
+i_INLINE_DECL void compiler_profile_begin(const struct compiler_profile *p,
+                                          struct compiler_profile_sample *s)
+{
+    if (p->enabled) {
+        compiler_profile_take_sample(s);
+    }
+}
+
+i_INLINE_DECL void compiler_profile_end(struct compiler_profile *p,
+                                        enum compiler_phase phase,
+                                        const struct compiler_profile_sample *begin)
+{
+    if (p->enabled) {
+        compiler_profile_add(p, phase, begin);
+    }
+}
+
+i_INLINE_DECL void pool_usage_alloc(struct pool_usage *u)
+{
+    if (++u->live > u->peak) {
+        u->peak = u->live;
+    }
+}
+
+i_INLINE_DECL void pool_usage_free(struct pool_usage *u)
+{
+    --u->live;
+}
+
+/**
+ * Print the measurements of a compilation
+ *
+ * @param p              The phase timings to print, or NULL
+ * @param modules        The modules whose memory pools usage to print, or NULL
+ * @param json           If true print a JSON object instead of tables
+ * @param f              Where to print
+ */
+void compiler_profile_report(const struct compiler_profile *p,
+                             const struct modules_arr *modules,
+                             bool json,
+                             FILE *f);
+
+#endif
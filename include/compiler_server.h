@@ -0,0 +1,44 @@
+#ifndef LFR_COMPILER_SERVER_H
+#define LFR_COMPILER_SERVER_H
+
+#include <stdbool.h>
+
+struct compiler;
+
+/**
+ * A long running compiler that serves compile requests over a unix socket.
+ *
+ * Between requests the process, the LLVM initialization and the analyzed
+ * and lowered standard library module stay warm, so a request only pays
+ * for the modules of the program it compiles.
+ *
+ * A request is the client's working directory followed by its command line
+ * arguments, each one terminated by '\0', and ends when the client shuts
+ * down its side of the connection. The reply is a single '0' or '1' for
+ * success or failure followed by the compiler's messages.
+ */
+
+/**
+ * Serve compile requests sent to @a socket_path until the process is
+ * killed.
+ *
+ * @param c              The compiler to serve the requests with. Reset
+ *                       before each one.
+ * @param socket_path    The unix socket to listen to. Replaced if it
+ *                       already exists.
+ * @return               false if the socket could not be set up
+ */
+bool compiler_server_run(struct compiler *c, const char *socket_path);
+
+/**
+ * Send the compilation described by a command line to the server
+ * listening on @a socket_path and print its messages.
+ *
+ * @param argc           The arguments count of the command line
+ * @param argv           The command line. Any --connect argument is not
+ *                       sent to the server.
+ * @return               The exit code for the client process
+ */
+int compiler_server_request(const char *socket_path, int argc, char **argv);
+
+#endif
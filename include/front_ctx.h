@@ -5,6 +5,7 @@
 #include <analyzer/analyzer.h>
 #include <RFintrusive_list.h>
 #include <module.h>
+#include <utils/arena.h>
 
 struct info_ctx;
 struct lexer;
@@ -26,8 +27,17 @@ struct front_ctx {
     struct info_ctx *info;
     //! Denotes whether this file is the starting point of our project, hence the main module
     bool is_main;
+    //! Set by the parser if a main() function was found in the file
+    bool main_found;
+    //! If true the parser memoizes speculatively parsed productions
+    bool parser_memo;
+    //! Kept by compiler_reset() from a previous program. Its modules are
+    //! already analyzed and have their RIR so they are not processed again.
+    bool retained;
     //! Pointer to the root AST node for the file, valid only after parsing is finalized
     struct ast_node *root;
+    //! Arena holding all AST nodes created while parsing the file
+    struct arena ast_arena;
     /* Control for adding to compiler object's linked list */
     struct RFilist_node ln;
 };
@@ -45,7 +55,19 @@ struct RFstring *front_ctx_filename(const struct front_ctx *f);
 
 /**
  * Scan and parse the file of a front_ctx
+ *
+ * Touches no state shared with other fronts so fronts can be parsed
+ * concurrently, as long as each one is parsed by a single thread.
  */
 bool front_ctx_parse(struct front_ctx *ctx);
 
+/**
+ * Create the modules of a parsed front_ctx and register them, and the
+ * front itself if it holds main(), with the compiler.
+ *
+ * Should be called serially for all fronts, in the order they were added
+ * to the compiler, so that module creation order is deterministic.
+ */
+bool front_ctx_register_modules(struct front_ctx *ctx);
+
 #endif
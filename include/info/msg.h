@@ -24,7 +24,7 @@ struct info_msg {
 
 i_INLINE_DECL bool info_msg_has_end_mark(struct info_msg *msg)
 {
-    return msg->end_mark.p != NULL;
+    return !inplocation_mark_empty(&msg->end_mark);
 }
 
 struct info_msg *info_msg_create(enum info_msg_type type,
@@ -18,6 +18,14 @@ struct inpfile {
 
 
 struct inpfile *inpfile_create(const struct RFstring *name);
+/**
+ * Create an input file whose string points straight into a read-only memory
+ * mapping of the file instead of a copy of its contents. The bytes are used
+ * as they are on disk, so no end of line conversion takes place.
+ * Falls back to the same behaviour as @ref inpfile_create() for stdin and for
+ * files that can't be mapped (e.g. empty files).
+ */
+struct inpfile *inpfile_create_mapped(const struct RFstring *name);
 struct inpfile *inpfile_create_from_string(const struct RFstring *name,
                                            const struct RFstring *contents);
 
@@ -31,6 +39,13 @@ void inpfile_destroy(struct inpfile *f);
  * @param f         The file to work with
  */
 void inpfile_acc_ws(struct inpfile *f);
+/**
+ * Like inpfile_acc_ws() but also accepts whole `//` comments, counting
+ * the lines they span in the same pass
+ *
+ * @param f         The file to work with
+ */
+void inpfile_acc_ws_comments(struct inpfile *f);
 /**
  * Move the internal RFstringx pointer of an inpfile
  *
@@ -6,57 +6,92 @@
 
 #include <inpfile.h>
 
+//! Offset of a location mark that does not point anywhere in the file
+#define INPLOCATION_MARK_EMPTY_OFF UINT32_MAX
+
+/**
+ * A position in an input file, stored as a byte offset from the beginning of
+ * the file. Line and column are resolved lazily through the file's line table
+ * and only when needed, e.g. to format a diagnostic.
+ */
 struct inplocation_mark {
-    unsigned int line;
-    unsigned int col;
-    char *p;
+    uint32_t off;
 };
 
 i_INLINE_DECL bool inplocation_mark_equal(const struct inplocation_mark *m1,
                                           const struct inplocation_mark *m2)
 {
-    if (m1->line != m2->line) {
-        return false;
-    }
-    if (m1->col != m2->col) {
-        return false;
-    }
-    if (m1->p != m2->p) {
-        return false;
-    }
-    return true;
+    return m1->off == m2->off;
 }
 
 i_INLINE_DECL bool inplocation_mark_empty(const struct inplocation_mark *m)
 {
-    return m->p == 0;
+    return m->off == INPLOCATION_MARK_EMPTY_OFF;
+}
+
+/**
+ * Get the byte pointer of a location mark inside the file it refers to
+ */
+i_INLINE_DECL char *inplocation_mark_p(const struct inplocation_mark *m,
+                                       const struct inpfile *f)
+{
+    return inpfile_sp(f) + m->off;
 }
 
+/**
+ * Resolve the line and column of a location mark
+ *
+ * @param m             The mark to resolve
+ * @param f             The file the mark refers to
+ * @param line[out]     Returns the line of the mark. 0 for an empty mark.
+ * @param col[out]      Returns the column of the mark. 0 for an empty mark.
+ *
+ * @return              True if the mark is empty or represents a valid
+ *                      position in @c f and false if not
+ */
+bool inplocation_mark_linecol(const struct inplocation_mark *m,
+                              struct inpfile *f,
+                              unsigned int *line,
+                              unsigned int *col);
+
+//! Size of a buffer that can hold the "line:col" string of any mark
+#define INPLOCATION_MARK_LINECOL_STRLEN 24
+
+/**
+ * Write the line and column of a location mark as "line:col", resolving
+ * both with a single inplocation_mark_linecol()
+ *
+ * @param buff          A buffer of INPLOCATION_MARK_LINECOL_STRLEN bytes
+ * @return              @a buff
+ */
+char *inplocation_mark_linecol_str(const struct inplocation_mark *m,
+                                   struct inpfile *f,
+                                   char *buff);
+
+unsigned int inplocation_mark_line(const struct inplocation_mark *m,
+                                   struct inpfile *f);
+unsigned int inplocation_mark_col(const struct inplocation_mark *m,
+                                  struct inpfile *f);
+
 struct inplocation {
     struct inplocation_mark start;
     struct inplocation_mark end;
 };
 
 
-#define LOCMARK_RESET(mark_)                    \
-    do {                                        \
-        (mark_)->line = 0;                      \
-        (mark_)->col = 0;                       \
-        (mark_)->p = 0;                         \
+#define LOCMARK_RESET(mark_)                            \
+    do {                                                \
+        (mark_)->off = INPLOCATION_MARK_EMPTY_OFF;      \
     } while(0)
 
 #define LOCMARK_INIT_ZERO()                     \
     {                                           \
-        .line = 0,                              \
-        .col = 0,                               \
-        .p = 0                                  \
+        .off = INPLOCATION_MARK_EMPTY_OFF       \
     }
 
-#define LOCMARK_INIT(file_, line_, col_)          \
-    {                                             \
-        .line = line_,                            \
-        .col = col_,                              \
-        .p = inpfile_line_p(file_, line_) + col_  \
+#define LOCMARK_INIT(file_, line_, col_)                                \
+    {                                                                   \
+        .off = inpfile_line_p(file_, line_) + col_ - inpfile_sp(file_)  \
     }
 
 /* 2 macros for quick location initialization, mostly used in tests */
@@ -67,19 +102,15 @@ struct inplocation {
         .end = LOCMARK_INIT(file_, el_, ec_)      \
     }
 
-// initialize a location using all attributes. Used if non-ascii chars in line
-#define LOC_INIT_FULL(sl_, sc_, el_, ec_, sp_, ep_)         \
+// initialize a location using byte pointers. Used if non-ascii chars in line
+#define LOC_INIT_FULL(file_, sp_, ep_)                      \
     {                                                       \
         .start = {                                          \
-            .line = sl_,                                    \
-            .col = sc_,                                     \
-            .p = sp_                                        \
+            .off = (sp_) - inpfile_sp(file_)                \
         },                                                  \
                                                             \
         .end = {                                            \
-            .line = el_,                                    \
-            .col = ec_,                                     \
-            .p = ep_                                        \
+            .off = (ep_) - inpfile_sp(file_)                \
         }                                                   \
     }
 
@@ -142,24 +173,31 @@ i_INLINE_DECL bool inplocation_equal(const struct inplocation *l1,
 }
 
 
+// "line:col" of a mark in a buffer that lives until the end of the
+// enclosing block, so that it can be used as a printf argument
+#define INPLOCATION_MARK_LINECOL_ARG(mark_, file_)                      \
+    inplocation_mark_linecol_str(                                       \
+        mark_, file_, (char[INPLOCATION_MARK_LINECOL_STRLEN]){0})
+
 #define INPLOCATION_FMT                         \
-    RF_STR_PF_FMT":%u:%u"
-#define INPLOCATION_ARG(file_, loc_)                                    \
-    RF_STR_PF_ARG(&(file_)->file_name), (loc_)->start.line, (loc_)->start.col
+    RF_STR_PF_FMT":%s"
+#define INPLOCATION_ARG(file_, loc_)                            \
+    RF_STR_PF_ARG(&(file_)->file_name),                         \
+        INPLOCATION_MARK_LINECOL_ARG(&(loc_)->start, file_)
 
 #define INPLOCATION_FMT2                        \
-    RF_STR_PF_FMT":(%u:%u|%u:%u)"
-#define INPLOCATION_ARG2(file_, loc_)           \
-    RF_STR_PF_ARG(&(file_)->file_name),         \
-        (loc_)->start.line, (loc_)->start.col,  \
-        (loc_)->end.line, (loc_)->end.col
+    RF_STR_PF_FMT":(%s|%s)"
+#define INPLOCATION_ARG2(file_, loc_)                           \
+    RF_STR_PF_ARG(&(file_)->file_name),                         \
+        INPLOCATION_MARK_LINECOL_ARG(&(loc_)->start, file_),    \
+        INPLOCATION_MARK_LINECOL_ARG(&(loc_)->end, file_)
 
 #define INPLOCMARKS_FMT                         \
-    RF_STR_PF_FMT":(%u:%u|%u:%u)"
-#define INPLOCMARKS_ARG(file_, start_, end_)    \
-    RF_STR_PF_ARG(&(file_)->file_name),         \
-        (start_)->line, (start_)->col,          \
-        (end_)->line, (end_)->col
+    RF_STR_PF_FMT":(%s|%s)"
+#define INPLOCMARKS_ARG(file_, start_, end_)                    \
+    RF_STR_PF_ARG(&(file_)->file_name),                         \
+        INPLOCATION_MARK_LINECOL_ARG(start_, file_),            \
+        INPLOCATION_MARK_LINECOL_ARG(end_, file_)
 
 
 #endif
@@ -0,0 +1,44 @@
+#ifndef LFR_INPSKIP_H
+#define LFR_INPSKIP_H
+
+#include <stdbool.h>
+
+/**
+ * Fast skipping routines for the lexer's hot loop.
+ *
+ * Where the CPU supports it the routines are vectorized with SSE2/AVX2,
+ * selected at runtime. The scalar versions are always available and all
+ * versions give identical results for any input.
+ */
+
+/**
+ * Skip a run of whitespace (" \t\n\r") and, if requested, whole `//`
+ * comments. A comment extends up to and including its terminating newline.
+ * A comment with no newline extends up to the last byte before @a end, or
+ * up to @a end if it is just the `//`.
+ *
+ * @param p              The position to start skipping from
+ * @param end            One past the last byte of the input
+ * @param comments       If true `//` comments are skipped along with
+ *                       whitespace
+ * @param lines[out]     Incremented by the number of newlines skipped
+ * @return               A pointer to the first byte that was not skipped.
+ *                       Equal to @a end if everything was skipped.
+ */
+const char *inpskip_ws(const char *p, const char *end,
+                       bool comments, unsigned int *lines);
+
+/**
+ * Count the newlines in [@a p, @a end)
+ */
+unsigned int inpskip_count_newlines(const char *p, const char *end);
+
+/**
+ * Scalar reference implementations, regardless of CPU support.
+ * Exposed mainly so that tests can compare them with the dispatched ones.
+ */
+const char *inpskip_ws_scalar(const char *p, const char *end,
+                              bool comments, unsigned int *lines);
+unsigned int inpskip_count_newlines_scalar(const char *p, const char *end);
+
+#endif
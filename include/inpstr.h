@@ -9,6 +9,9 @@ struct inpstr {
     struct RFstringx str;
     uint32_t lines_num;
     uint32_t *lines;
+    //! Size of the read-only file mapping @c str points into, or 0 if
+    //! @c str owns its buffer
+    size_t mapped_size;
 };
 
 /**
@@ -41,6 +44,20 @@ bool inpstr_init(struct inpstr *s,
 bool inpstr_init_from_source(struct inpstr *s,
                              const struct RFstring *input_str);
 
+/**
+ * Initializes an input string directly over a read-only memory mapping of a
+ * file. No bytes are copied and the line offsets are computed in a single
+ * pass over the mapped bytes.
+ *
+ * @param s            The string to initialize
+ * @param map          The start of the mapping. The input string takes
+ *                     ownership of it and will unmap it at deinit.
+ * @param size         The size of the mapping in bytes. Must be non-zero.
+ *
+ * @return             True/false in case of success/failure to initialize
+ */
+bool inpstr_init_mapped(struct inpstr *s, char *map, uint32_t size);
+
 void inpstr_deinit(struct inpstr *s);
 
 /**
@@ -51,7 +51,7 @@ struct RFstring *rir_tostring(struct rir *r);
 struct rir *rir_create();
 void rir_destroy(struct rir* r);
 
-bool compiler_create_rir();
+bool compiler_create_rir(struct compiler *c);
 bool rir_print(struct compiler *c);
 
 struct rir_fndecl *rir_fndecl_byname(const struct rir *r, const struct RFstring *name);
@@ -92,6 +92,8 @@ struct symbol_table *rir_ctx_curr_st(struct rir_ctx *ctx);
 bool rir_ctx_st_newobj(struct rir_ctx *ctx, const struct RFstring *id, struct type *t, struct rir_object *obj);
 bool rir_ctx_st_setobj(struct rir_ctx *ctx, const struct RFstring *id, struct rir_object *obj);
 struct rir_object *rir_ctx_st_getobj(struct rir_ctx *ctx, const struct RFstring *id);
+//! Same as rir_ctx_st_getobj() but with the interned ID and hash of an identifier
+struct rir_object *rir_ctx_st_getobj_id(struct rir_ctx *ctx, uint32_t id, uint32_t hash);
 void rir_ctx_st_create_allocas(struct rir_ctx *ctx);
 void rir_ctx_st_add_allocas(struct rir_ctx *ctx);
 void rir_ctx_st_create_and_add_allocas(struct rir_ctx *ctx);
@@ -8,7 +8,9 @@ extern struct rir_value g_rir_const_1;
 extern struct rir_value g_rir_const_m1;
 
 /**
- * Initialize all the utils needed by all rir functions
+ * Initialize all the utils needed by all rir functions. They are shared
+ * by all compilers so each rir_utils_create() must be matched by a
+ * rir_utils_destroy() and the last one frees them.
  */
 bool rir_utils_create();
 void rir_utils_destroy();
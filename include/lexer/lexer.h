@@ -10,20 +10,30 @@
 
 
 struct inpfile;
+struct string_interner;
 
 struct lexer {
     struct {darray(struct token);} tokens;
+    //! Values of the numeric constant tokens
+    struct {darray(union token_literal);} literals;
     struct {darray(int);} indices;
     unsigned int tok_index;
     struct inpfile *file;
     struct info_ctx *info;
+    //! Interner in which all identifiers are interned at lexing time
+    struct string_interner *identifiers;
     //! Denotes that the lexer has reached the end of its input
     bool at_eof;
 };
 
 
-bool lexer_init(struct lexer *l, struct inpfile *f, struct info_ctx *info);
-struct lexer *lexer_create(struct inpfile *f, struct info_ctx *info);
+bool lexer_init(struct lexer *l,
+                struct inpfile *f,
+                struct info_ctx *info,
+                struct string_interner *identifiers);
+struct lexer *lexer_create(struct inpfile *f,
+                           struct info_ctx *info,
+                           struct string_interner *identifiers);
 void lexer_deinit(struct lexer *l);
 void lexer_destroy(struct lexer *l);
 
@@ -66,4 +76,36 @@ void lexer_push(struct lexer *l);
 void lexer_pop(struct lexer *l);
 void lexer_rollback(struct lexer *l);
 
+/**
+ * @return The index of the next token to be consumed
+ */
+i_INLINE_DECL unsigned int lexer_curr_index(const struct lexer *l)
+{
+    return l->tok_index;
+}
+
+/**
+ * Move the lexer to an index previously acquired with lexer_curr_index()
+ */
+i_INLINE_DECL void lexer_set_index(struct lexer *l, unsigned int idx)
+{
+    l->tok_index = idx;
+}
+
+//! @return The number of tokens the lexer has scanned
+i_INLINE_DECL unsigned int lexer_tokens_num(const struct lexer *l)
+{
+    return darray_size(l->tokens);
+}
+
+/**
+ * Create the AST node for the value of a token. The node is owned by the
+ * caller. Each call creates a new node.
+ *
+ * @param l         The lexer the token belongs to
+ * @param tok       The token. Use only after a token_has_value() check
+ * @return          The new node or NULL in case of memory error
+ */
+struct ast_node *lexer_token_get_value(struct lexer *l, struct token *tok);
+
 #endif
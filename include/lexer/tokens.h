@@ -98,18 +98,24 @@ enum token_type {
 
 
 /*
- * A token's value. Only for tokens that form a full ast_node.
- * Also contains memory ownership semantics
+ * The value of a numeric constant token. Kept in a side table of the lexer
+ * and indexed by @ref token::value_idx
  */
-struct tok_value {
-    struct ast_node *v;
-    bool owned_by_lexer;
+union token_literal {
+    uint64_t integer;
+    double floating;
 };
 
+/*
+ * A token as emitted by the lexer. Tokens own no AST nodes, value nodes are
+ * only created when the parser asks for them with lexer_token_get_value()
+ */
 struct token {
     enum token_type type;
     struct inplocation location;
-    struct tok_value value;
+    //! For numeric constants the index into the lexer's literal table.
+    //! For identifiers the ID of the identifier in the lexer's interner.
+    uint32_t value_idx;
 };
 
 const struct RFstring *tokentype_to_str(enum token_type type);
@@ -170,13 +176,5 @@ i_INLINE_DECL bool token_has_value(const struct token *tok)
         tok->type == TOKEN_CONSTANT_FLOAT;
 }
 
-// gets the value from a token. Use only after a tok->type check
-i_INLINE_DECL struct ast_node *token_get_value(struct token *tok)
-{
-    RF_ASSERT(token_has_value(tok), "Requesting value of illegal token type");
-    tok->value.owned_by_lexer = false;
-    return tok->value.v;
-}
-
 
 #endif
@@ -2,8 +2,10 @@
 #define LFR_MODULE_H
 
 #include <Data_Structures/darray.h>
+#include <Data_Structures/htable.h>
 #include <utils/string_set.h>
 #include <RFintrusive_list.h>
+#include <compiler_profile.h>
 
 struct module;
 struct ast_node;
@@ -25,16 +27,31 @@ struct module {
     struct modules_arr dependencies;
     //! A dynamic array of foreign functions this module needs
     struct {darray(struct ast_node*);} foreignfn_arr;
+    //! Interned ID of the module's name
+    uint32_t name_id;
+    //! Position of the module in the compiler's modules array
+    unsigned int index;
+    //! Key of the module's LLVM code in the compilation cache. Set by
+    //! compiler_cache_set_module_key()
+    uint32_t cache_key[2];
 
     /* -- Members used only for the analysis stage of the module -- */
     /* Memory pools */
     struct rf_fixed_memorypool *symbol_table_records_pool;
+    struct rf_fixed_memorypool *symbol_tables_pool;
     struct rf_fixed_memorypool *types_pool;
     //! A set of all types encountered
     struct rf_objset_type *types_set;
-    /* String sets containing identifiers and string literals found during parsing */
-    struct rf_objset_string identifiers_set;
+    /* String set containing string literals found during parsing */
     struct rf_objset_string string_literals_set;
+    //! Maps each symbol visible through the module's imports to its
+    //! record. Built by module_exports_build() after the first pass.
+    struct htable exports;
+    //! True once @ref exports has been built
+    bool exports_ready;
+    /* Usage of the memory pools, reported by --mem-report */
+    struct pool_usage symbol_records_usage;
+    struct pool_usage types_usage;
     
     //! Control, to add this module into the final sorted list of modules of the compiler
     struct RFilist_node ln;
@@ -104,4 +121,32 @@ bool module_analyze(struct module *m);
 
 bool module_have_errors(const struct module *m);
 
+/**
+ * Index every symbol the module sees through its imports, so that a symbol
+ * missing from the module's own symbol tables is found with a single probe
+ * instead of searching the symbol tables of all the modules it depends on,
+ * and theirs in turn.
+ *
+ * A dependency exports the records of its top symbol table and its parents,
+ * followed by its own exports. The name of the dependency itself is never
+ * exported. For a symbol that more than one dependency exports, the first
+ * dependency in import order wins.
+ *
+ * Should be called after the first pass of the analysis, when all of the
+ * dependencies have built their own index.
+ */
+bool module_exports_build(struct module *m);
+
+/**
+ * Lookup a symbol in the export index of a module
+ *
+ * @param m          The module whose index to search. Its index should be built.
+ * @param id         The interned ID of the symbol
+ * @param hash       The hash of the symbol's string
+ * @return           The record or NULL if no dependency exports the symbol
+ */
+struct symbol_table_record *module_exports_lookup(const struct module *m,
+                                                  uint32_t id,
+                                                  uint32_t hash);
+
 #endif
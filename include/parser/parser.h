@@ -8,6 +8,7 @@ struct info_ctx;
 struct lexer;
 struct inpfile;
 struct front_ctx;
+struct parser_memo;
 
 struct parser {
     //! A pointer to the front_ctx that owns the parser. Needed only by the
@@ -18,6 +19,9 @@ struct parser {
     struct inpfile *file;
     struct ast_node *root;
     bool have_syntax_err;
+    //! Packrat memo table of speculatively parsed productions. NULL if
+    //! memoization is disabled.
+    struct parser_memo *memo;
 };
 
 
@@ -33,6 +37,18 @@ struct parser *parser_create(struct inpfile *f,
 void parser_deinit(struct parser *p);
 void parser_destroy(struct parser *p);
 
+/**
+ * Enable packrat memoization of the productions that the parser tries
+ * speculatively, so that no production is parsed twice at the same token.
+ *
+ * Memoized subtrees can be handed out again after a failed alternative
+ * has destroyed them, so this must only be enabled while AST nodes are
+ * allocated from an arena (see ast_arena_set()) and the tokens
+ * have already been scanned.
+ */
+bool parser_memo_enable(struct parser *p);
+void parser_memo_disable(struct parser *p);
+
 
 /**
  * Performs the scanning and parsing stage on a file
@@ -96,6 +96,12 @@ struct type *type_create_from_operation(enum typeop_type type,
 
 struct type *type_lookup_identifier_string(const struct RFstring *str,
                                            const struct symbol_table *st);
+/**
+ * Same as type_lookup_identifier_string() but for an identifier or
+ * xidentifier node, looked up by its interned ID
+ */
+struct type *type_lookup_identifier(const struct ast_node *n,
+                                    const struct symbol_table *st);
 struct type *type_lookup_xidentifier(const struct ast_node *n,
                                      struct module *mod,
                                      struct symbol_table *st,
@@ -141,15 +147,49 @@ struct RFstring *type_op_create_str(const struct type *t1,
                                     const struct type *t2,
                                     enum typeop_type type);
 
+/**
+ * Get the uid that an operator type of @a type applied to @a t1 and @a t2
+ * would have, without creating it. Used to probe a types set before
+ * creating the operator type.
+ */
+size_t type_op_create_uid(const struct type *t1,
+                          const struct type *t2,
+                          enum typeop_type type);
+
 /**
  * Get a unique id for this type for use as a hash/key in data structures.
  *
- * TODO: Needs improvement
+ * The id is a structural hash, computed from the category of the type and
+ * the uids of its operands, so types with the same structure get the same
+ * id. It is cached in the type by type_cache_uid() and computed on the fly
+ * for types whose uid has not been cached.
  *
  * @param t              The type whose unique key to get.
  */
 size_t type_get_uid(const struct type *t);
 
+/**
+ * Compute the uid that the type created for a type description would have,
+ * without creating the type.
+ *
+ * @param desc           The type description
+ * @param st             The symbol table to lookup identifiers in
+ * @param uid[out]       The uid of the type
+ * @return               false if the uid can't be determined without creating
+ *                       the type, for example if the description refers to
+ *                       an undefined or generic type
+ */
+bool type_uid_from_ast_node(const struct ast_node *desc,
+                            const struct symbol_table *st,
+                            size_t *uid);
+
+/**
+ * Compute and remember the uid of a type. Operator types get extended in
+ * place while they are built, so this must be called again, and the type
+ * moved to its new bucket of the types set, whenever its operands change.
+ */
+void type_cache_uid(struct type *t);
+
 /**
  * Query a unique type name for a type. If type is defined, its contents are used
  * in determining the unique string.
@@ -2,6 +2,7 @@
 #define LFR_TYPES_DECL_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <String/rf_str_decl.h>
 #include <ast/operators_decls.h> // for binary operations enum
 #include <Data_Structures/intrusive_list.h>
@@ -83,5 +84,8 @@ struct type {
         struct type_foreignfn foreignfn;
         struct type_module module;
     };
+    //! Structural hash of the type, cached once the type is complete.
+    //! 0 if not cached yet. @see type_get_uid()
+    uint32_t uid;
 };
 #endif
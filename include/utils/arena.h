@@ -0,0 +1,57 @@
+#ifndef LFR_UTILS_ARENA_H
+#define LFR_UTILS_ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <Definitions/inline.h>
+
+//! Default size in bytes of a single arena chunk
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+struct arena_chunk;
+
+/**
+ * A bump allocator.
+ *
+ * Memory is carved out of big chunks and is never freed individually. All
+ * of it is released at once by arena_deinit(), at a cost proportional to
+ * the number of chunks and not to the number of allocations.
+ */
+struct arena {
+    //! The chunk currently being allocated from. Chunks form a linked list.
+    struct arena_chunk *chunks;
+    //! Next free byte of the current chunk
+    char *ptr;
+    //! One past the last byte of the current chunk
+    char *end;
+    //! Size of a newly created chunk
+    size_t chunk_size;
+    //! Number of allocations served by the arena
+    size_t allocations;
+    //! Number of bytes handed out by the arena
+    size_t bytes;
+    //! Number of chunks malloc'ed by the arena
+    size_t chunks_num;
+};
+
+void arena_init(struct arena *a, size_t chunk_size);
+void arena_deinit(struct arena *a);
+
+/**
+ * Allocate @a size bytes from the arena, aligned for any object type
+ *
+ * @return          The allocated memory or NULL in case of memory failure
+ */
+void *arena_alloc(struct arena *a, size_t size);
+
+i_INLINE_DECL size_t arena_allocations(const struct arena *a)
+{
+    return a->allocations;
+}
+
+i_INLINE_DECL size_t arena_chunks(const struct arena *a)
+{
+    return a->chunks_num;
+}
+
+#endif
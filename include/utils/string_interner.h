@@ -0,0 +1,133 @@
+#ifndef LFR_UTILS_STRING_INTERNER_H
+#define LFR_UTILS_STRING_INTERNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <Definitions/inline.h>
+#include <String/rf_str_decl.h>
+
+//! Returned for strings that are not interned (or on memory failure)
+#define STRING_INTERNER_INVALID_ID UINT32_MAX
+
+//! Interned strings are kept in chunks of (1 << SHIFT) entries
+#define STRING_INTERNER_CHUNK_SHIFT 10
+#define STRING_INTERNER_CHUNK_SIZE (1u << STRING_INTERNER_CHUNK_SHIFT)
+//! Maximum number of chunks, which bounds the number of distinct strings
+#define STRING_INTERNER_MAX_CHUNKS 4096
+
+/**
+ * A string owned by the interner, along with its ID and its cached hash
+ */
+struct interned_string {
+    struct RFstring str;
+    uint32_t hash;
+    uint32_t id;
+};
+
+/**
+ * An open addressing table from string hashes to interned string IDs.
+ *
+ * Each slot packs a hash and an ID in 64 bits so that a slot is published
+ * with a single atomic store. Zero marks an empty slot.
+ */
+struct string_interner_table {
+    //! Number of slots minus one. The number of slots is a power of 2.
+    uint32_t mask;
+    //! The smaller table this one replaced. Readers may still be probing it
+    //! so it is only freed along with the interner.
+    struct string_interner_table *prev;
+    uint64_t slots[];
+};
+
+/**
+ * Maps every distinct string given to it to a dense 32-bit ID.
+ *
+ * Interned strings are copied into interner owned memory so they stay valid
+ * for the whole lifetime of the interner, regardless of the source buffer
+ * they came from. Two strings are equal iff their IDs are equal.
+ *
+ * The interner can be used by many threads at once. Only adding a new string
+ * takes a lock. Lookups never do: slots are published after the string they
+ * point to, and a grown table replaces the old one with a single pointer
+ * store while the old one stays readable.
+ */
+struct string_interner {
+    //! The current lookup table. Loaded with acquire semantics.
+    struct string_interner_table *table;
+    //! ID -> interned string, split in chunks of STRING_INTERNER_CHUNK_SIZE
+    struct interned_string **chunks[STRING_INTERNER_MAX_CHUNKS];
+    //! Number of interned strings
+    uint32_t size;
+    //! Serializes additions
+    pthread_mutex_t lock;
+};
+
+bool string_interner_init(struct string_interner *in);
+void string_interner_deinit(struct string_interner *in);
+
+/**
+ * Forget all interned strings. IDs start again from 0 and the memory of the
+ * strings is freed, so nothing may refer to them anymore. Must not be called
+ * while other threads use the interner.
+ */
+void string_interner_clear(struct string_interner *in);
+
+/**
+ * Intern a string
+ *
+ * @param in         The interner
+ * @param s          The string to intern. Is copied if not already interned.
+ * @return           The ID of the string or STRING_INTERNER_INVALID_ID
+ *                   in case of memory failure
+ */
+uint32_t string_interner_add(struct string_interner *in,
+                             const struct RFstring *s);
+
+/**
+ * Get the ID of a string without interning it
+ *
+ * @return           The ID of the string or STRING_INTERNER_INVALID_ID
+ *                   if the string has never been interned
+ */
+uint32_t string_interner_get_id(const struct string_interner *in,
+                                const struct RFstring *s);
+/**
+ * Same as string_interner_get_id() but with the string's hash, as given by
+ * rf_hash_str_stable(s, 0), already known
+ */
+uint32_t string_interner_get_id_h(const struct string_interner *in,
+                                  const struct RFstring *s,
+                                  uint32_t hash);
+
+i_INLINE_DECL const struct interned_string *
+string_interner_get(const struct string_interner *in, uint32_t id)
+{
+    return in->chunks[id >> STRING_INTERNER_CHUNK_SHIFT]
+        [id & (STRING_INTERNER_CHUNK_SIZE - 1)];
+}
+
+/**
+ * @return The interned string with ID @a id
+ */
+i_INLINE_DECL const struct RFstring *
+string_interner_str(const struct string_interner *in, uint32_t id)
+{
+    return &string_interner_get(in, id)->str;
+}
+
+/**
+ * @return The cached hash of the interned string with ID @a id
+ */
+i_INLINE_DECL uint32_t string_interner_hash(const struct string_interner *in,
+                                            uint32_t id)
+{
+    return string_interner_get(in, id)->hash;
+}
+
+i_INLINE_DECL unsigned int string_interner_size(const struct string_interner *in)
+{
+    return __atomic_load_n(&in->size, __ATOMIC_ACQUIRE);
+}
+
+#endif
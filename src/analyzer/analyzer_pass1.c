@@ -106,9 +106,10 @@ static bool analyzer_populate_symbol_table_typeleaf(struct analyzer_traversal_ct
 
     left = ast_typeleaf_left(n);
     id_name = ast_identifier_str(left);
-    search_node = symbol_table_lookup_node(ctx->current_st,
-                                           id_name,
-                                           &symbol_found_at_first_st);
+    search_node = symbol_table_lookup_node_id(ctx->current_st,
+                                              ast_identifier_id(left),
+                                              ast_identifier_hash(left),
+                                              &symbol_found_at_first_st);
 
     if (search_node && symbol_found_at_first_st) {
         analyzer_err(ctx->m, ast_node_startmark(n),
@@ -192,8 +193,9 @@ static bool analyzer_symbol_table_add_fndecl(struct analyzer_traversal_ctx *ctx,
                      "Function \""RF_STR_PF_FMT"\" was already declared "
                      "at "INPLOCATION_FMT,
                      RF_STR_PF_ARG(fn_name),
+                     // the function may come from a dependency's file
                      INPLOCATION_ARG(
-                         module_get_file(ctx->m),
+                         symbol_table_record_file(rec),
                          ast_node_location(symbol_table_record_node(rec))));
         return false;
     }
@@ -222,6 +224,7 @@ static bool analyzer_create_symbol_table_fndecl(struct analyzer_traversal_ctx *c
 static bool analyzer_first_pass_do(struct ast_node *n, void *user_arg)
 {
     struct analyzer_traversal_ctx *ctx = user_arg;
+    struct ast_node *parent;
     analyzer_traversal_ctx_push_parent(ctx, n);
     // act depending on the node type
     switch(n->type) {
@@ -246,22 +249,24 @@ static bool analyzer_first_pass_do(struct ast_node *n, void *user_arg)
         }
         symbol_table_swap_current(&ctx->current_st, ast_fndecl_symbol_table_get(n));
         symbol_table_set_fndecl(ctx->current_st, n);
-        break;
-    case AST_FUNCTION_IMPLEMENTATION:
-        // function implementation symbol table should point to its decl table
-        ast_fnimpl_symbol_table_set(n, ast_fndecl_symbol_table_get(n->fnimpl.decl));
-        break;
-    case AST_MATCH_CASE:
-        // match case symbol table should point to its pattern typedesc table
-        ast_matchcase_symbol_table_set(n, ast_typedesc_symbol_table_get(n->matchcase.pattern));
+        parent = analyzer_traversal_ctx_get_nth_parent(0, ctx);
+        if (parent && parent->type == AST_FUNCTION_IMPLEMENTATION) {
+            // function implementation symbol table should point to its decl table
+            ast_fnimpl_symbol_table_set(parent, ast_fndecl_symbol_table_get(n));
+        }
         break;
     case AST_TYPE_DESCRIPTION:
         // initialize the type description's symbol table
-        if (!symbol_table_init(&n->typedesc.st, ctx->m)) {
+        if (!ast_typedesc_symbol_table_init(n, ctx->m)) {
             RF_ERROR("Could not initialize symbol table for top level type description node");
             return false;
         }
         symbol_table_swap_current(&ctx->current_st, ast_typedesc_symbol_table_get(n));
+        parent = analyzer_traversal_ctx_get_nth_parent(0, ctx);
+        if (parent && parent->type == AST_MATCH_CASE) {
+            // match case symbol table should point to its pattern typedesc table
+            ast_matchcase_symbol_table_set(parent, ast_typedesc_symbol_table_get(n));
+        }
         // also populate the type description's symbol table
         if (!analyzer_populate_symbol_table_typedesc(ctx, n)) {
             RF_ERROR("Could not populate symbol table for top level type description node");
@@ -282,13 +287,11 @@ static bool analyzer_first_pass_do(struct ast_node *n, void *user_arg)
         }
         break;
     case AST_IDENTIFIER:
-        // create identifier hash and dissasociate from the file
+        // point to the interned string and dissasociate from the file
         RF_ASSERT(n->state == AST_NODE_STATE_AFTER_PARSING,
-                  "Attempting to create identifier hash for node in a wrong "
+                  "Attempting to intern identifier for node in a wrong "
                   "state of processing");
-        if (!ast_identifier_hash_create(n, ctx->m)) {
-            return false;
-        }
+        ast_identifier_intern(n);
         break;
     case AST_STRING_LITERAL:
         // create literal hash and dissasociate from the file
@@ -396,7 +399,7 @@ bool analyzer_first_pass(struct module *m)
     struct analyzer_traversal_ctx ctx;
     analyzer_traversal_ctx_init(&ctx, m);
     // set the starting symbol_table
-    ctx.current_st = &m->front->root->root.st;
+    ctx.current_st = ast_root_symbol_table_get(m->front->root);
 
     bool ret = ast_traverse_tree(
         m->node,
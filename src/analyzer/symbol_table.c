@@ -6,6 +6,8 @@
 #include <Utils/fixed_memory_pool.h>
 
 #include <module.h>
+#include <compiler.h>
+#include <utils/string_interner.h>
 #include <ast/ast.h>
 #include <ast/identifier.h>
 #include <ast/type.h>
@@ -20,15 +22,35 @@
 static struct symbol_table_record *symbol_table_record_alloc(
     struct symbol_table *st)
 {
+    if (st->mod) {
+        pool_usage_alloc(&st->mod->symbol_records_usage);
+    }
     return rf_fixed_memorypool_alloc_element(st->pool);
 }
 
 static void symbol_table_record_free(struct symbol_table_record *rec,
                                      struct symbol_table *st)
 {
+    if (st->mod) {
+        pool_usage_free(&st->mod->symbol_records_usage);
+    }
     rf_fixed_memorypool_free_element(st->pool, rec);
 }
 
+// key the record on the interned copy of its identifier
+static bool symbol_table_record_set_id(struct symbol_table_record *rec,
+                                       const struct RFstring *id)
+{
+    struct string_interner *identifiers = compiler_identifiers();
+    rec->interned_id = string_interner_add(identifiers, id);
+    if (rec->interned_id == STRING_INTERNER_INVALID_ID) {
+        return false;
+    }
+    rec->id = string_interner_str(identifiers, rec->interned_id);
+    rec->hash = string_interner_hash(identifiers, rec->interned_id);
+    return true;
+}
+
 bool symbol_table_record_init(struct symbol_table_record *rec,
                               struct module *mod,
                               struct symbol_table *st,
@@ -37,7 +59,10 @@ bool symbol_table_record_init(struct symbol_table_record *rec,
 {
     RF_STRUCT_ZERO(rec);
     rec->node = node;
-    rec->id = id;
+    rec->module = mod;
+    if (!symbol_table_record_set_id(rec, id)) {
+        return false;
+    }
     switch (node->type) {
     case AST_MODULE:
         rec->data = type_module_create(mod, id);
@@ -81,9 +106,8 @@ static bool symbol_table_record_init_from_type(struct symbol_table_record *rec,
                                                struct type *t)
 {
     RF_STRUCT_ZERO(rec);
-    rec->id = id;
     rec->data = t;
-    return true;
+    return symbol_table_record_set_id(rec, id);
 }
 
 struct symbol_table_record *symbol_table_record_create(struct symbol_table *st,
@@ -145,13 +169,13 @@ symbol_table_record_type(struct symbol_table_record *rec);
 static size_t rehash_fn(const void *e, void *user_arg)
 {
     struct symbol_table_record *rec = (struct symbol_table_record*)e;
-    return rf_hash_str_stable(rec->id, 0);
+    return rec->hash;
 }
 
-static bool cmp_fn(const void *e, void *str)
+static bool cmp_fn(const void *e, void *id)
 {
     struct symbol_table_record *rec = (struct symbol_table_record*)e;
-    return rf_string_equal(rec->id, str);
+    return rec->interned_id == *(uint32_t*)id;
 }
 
 bool symbol_table_init(struct symbol_table *t, struct module *m)
@@ -184,6 +208,44 @@ void symbol_table_deinit(struct symbol_table *t)
     }
 }
 
+struct symbol_table *symbol_table_create(struct module *m)
+{
+    struct symbol_table *ret = rf_fixed_memorypool_alloc_element(m->symbol_tables_pool);
+    if (!ret) {
+        return NULL;
+    }
+    if (!symbol_table_init(ret, m)) {
+        rf_fixed_memorypool_free_element(m->symbol_tables_pool, ret);
+        return NULL;
+    }
+    return ret;
+}
+
+struct symbol_table *root_symbol_table_create()
+{
+    struct symbol_table *ret;
+    RF_MALLOC(ret, sizeof(*ret), return NULL);
+    if (!root_symbol_table_init(ret)) {
+        free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+void symbol_table_destroy(struct symbol_table *t)
+{
+    struct module *m;
+    if (t) {
+        m = t->mod;
+        symbol_table_deinit(t);
+        if (m) {
+            rf_fixed_memorypool_free_element(m->symbol_tables_pool, t);
+        } else {
+            free(t);
+        }
+    }
+}
+
 bool symbol_table_add_node(struct symbol_table *t,
                            struct module *mod,
                            const struct RFstring *id,
@@ -219,10 +281,10 @@ bool symbol_table_add_node(struct symbol_table *t,
 bool symbol_table_add_record(struct symbol_table *t,
                              struct symbol_table_record *rec)
 {
-    if (!htable_add(&t->table, rf_hash_str_stable(rec->id, 0), rec)) {
+    if (!htable_add(&t->table, rec->hash, rec)) {
         return false;
     }
-
+    t->records_num++;
     return true;
 }
 
@@ -243,7 +305,7 @@ bool symbol_table_add_type(struct symbol_table *st,
                      "Identifier \""RF_STR_PF_FMT"\" was already declared in scope "
                      "at "INPLOCATION_FMT,
                      RF_STR_PF_ARG(id),
-                     INPLOCATION_ARG(module_get_file(mod),
+                     INPLOCATION_ARG(symbol_table_record_file(rec),
                                      ast_node_location(rec->node)));
         return false;
     }
@@ -254,6 +316,7 @@ bool symbol_table_add_type(struct symbol_table *st,
         return false;
     }
     rec->node = node_desc;
+    rec->module = mod;
 
     if (!symbol_table_add_record(st, rec)) {
         symbol_table_record_destroy(rec, st);
@@ -263,6 +326,12 @@ bool symbol_table_add_type(struct symbol_table *st,
     return true;
 }
 
+struct inpfile *symbol_table_record_file(const struct symbol_table_record *rec)
+{
+    RF_ASSERT(rec->module, "Asked for the file of a record with no module");
+    return module_get_file(rec->module);
+}
+
 void symbol_table_record_print(const struct symbol_table_record *rec)
 {
     printf("Symbol table record\n");
@@ -282,9 +351,11 @@ void symbol_table_record_print(const struct symbol_table_record *rec)
     RFS_POP();
 }
 
-struct symbol_table_record *symbol_table_lookup_record(const struct symbol_table *t,
-                                                       const struct RFstring *id,
-                                                       bool *at_first_symbol_table)
+static struct symbol_table_record *symbol_table_lookup_record_do(
+    const struct symbol_table *t,
+    uint32_t id,
+    uint32_t hash,
+    bool *at_first_symbol_table)
 {
     struct symbol_table_record *rec;
     const struct symbol_table *lp_table = t;
@@ -294,28 +365,33 @@ struct symbol_table_record *symbol_table_lookup_record(const struct symbol_table
     }
 
     // search this symbol table
-    rec = htable_get(&t->table, rf_hash_str_stable(id, 0), cmp_fn, id);
-    if (rec) {
+    if (t->records_num != 0 && (rec = htable_get(&t->table, hash, cmp_fn, &id))) {
         if (at_first_symbol_table) {
             *at_first_symbol_table = true;
         }
         return rec;
     }
-    // search all parents until we get to root
+    // search all parents until we get to root, skipping the empty ones
+    rec = NULL;
     while (!rec && lp_table->parent) {
         lp_table = lp_table->parent;
-        rec = htable_get(&lp_table->table, rf_hash_str_stable(id, 0), cmp_fn, id);
+        if (lp_table->records_num != 0) {
+            rec = htable_get(&lp_table->table, hash, cmp_fn, &id);
+        }
     }
 
-    // if we reach the root and we got nothing then check modules we depend on
-    // TODO: this is not very well written. Don't like how I have an exception for
-    //       module names here. Also need to think how to handle specific inclusions
-    //       from modules.
+    // if we reach the root and we got nothing then check modules we depend on,
+    // through the module's export index if the first pass has built it
+    if (!rec && t->mod && t->mod->exports_ready) {
+        return module_exports_lookup(t->mod, id, hash);
+    }
+    // else through each dependency's own symbol tables and export index
+    // TODO: Need to think how to handle specific inclusions from modules.
     if (!rec && t->mod) {
         struct module **mod;
         darray_foreach(mod, t->mod->dependencies) {
-            if ((rec = symbol_table_lookup_record(module_symbol_table(*mod), id, NULL)) &&
-                !rf_string_equal(id, module_name(*mod))) {
+            if ((rec = symbol_table_lookup_record_do(module_symbol_table(*mod), id, hash, NULL)) &&
+                id != (*mod)->name_id) {
                 return rec;
             }
             rec = NULL;
@@ -325,6 +401,37 @@ struct symbol_table_record *symbol_table_lookup_record(const struct symbol_table
     return rec;
 }
 
+struct symbol_table_record *symbol_table_lookup_record(const struct symbol_table *t,
+                                                       const struct RFstring *id,
+                                                       bool *at_first_symbol_table)
+{
+    return symbol_table_lookup_record_h(t, id, rf_hash_str_stable(id, 0), at_first_symbol_table);
+}
+
+struct symbol_table_record *symbol_table_lookup_record_h(const struct symbol_table *t,
+                                                         const struct RFstring *id,
+                                                         uint32_t hash,
+                                                         bool *at_first_symbol_table)
+{
+    uint32_t interned_id = string_interner_get_id_h(compiler_identifiers(), id, hash);
+    if (interned_id == STRING_INTERNER_INVALID_ID) {
+        // never interned, so no symbol table can contain it
+        if (at_first_symbol_table) {
+            *at_first_symbol_table = false;
+        }
+        return NULL;
+    }
+    return symbol_table_lookup_record_do(t, interned_id, hash, at_first_symbol_table);
+}
+
+struct symbol_table_record *symbol_table_lookup_record_id(const struct symbol_table *t,
+                                                          uint32_t id,
+                                                          uint32_t hash,
+                                                          bool *at_first_symbol_table)
+{
+    return symbol_table_lookup_record_do(t, id, hash, at_first_symbol_table);
+}
+
 // This function should be enclosed in RFS_PUSH() / RFS_POP()
 static const struct RFstring *symbol_table_extract_string_from_typedesc(const struct ast_node *typedesc)
 {
@@ -367,6 +474,16 @@ const struct ast_node *symbol_table_lookup_node(struct symbol_table *t,
     return rec ? rec->node : NULL;
 }
 
+const struct ast_node *symbol_table_lookup_node_id(struct symbol_table *t,
+                                                   uint32_t id,
+                                                   uint32_t hash,
+                                                   bool *at_first_symbol_table)
+{
+    struct symbol_table_record *rec;
+    rec = symbol_table_lookup_record_id(t, id, hash, at_first_symbol_table);
+    return rec ? rec->node : NULL;
+}
+
 void symbol_table_iterate(struct symbol_table *t, htable_iter_cb cb, void *user)
 {
     htable_iterate_records(&t->table, cb, user);
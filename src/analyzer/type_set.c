@@ -1,4 +1,8 @@
 #include <analyzer/type_set.h>
+
+#include <Persistent/buffers.h>
+#include <String/rf_str_core.h>
+
 #include <types/type.h>
 #include <types/type_comparisons.h>
 
@@ -13,7 +17,7 @@ size_t type_objset_hashfn(const struct type *t)
 bool type_objset_eqfn(const struct type *t1,
                       const struct type *t2)
 {
-    return type_compare(t1, t2, TYPECMP_IDENTICAL);
+    return t1 == t2 || type_compare(t1, t2, TYPECMP_IDENTICAL);
 }
 
 struct type *type_objset_has_convertable(const struct rf_objset_type *set, const struct type *type)
@@ -42,9 +46,50 @@ struct type *type_objset_has_uid(const struct rf_objset_type *set, size_t uid)
                       &uid);
 }
 
+struct type_objset_ast_cmp_ctx {
+    size_t uid;
+    const struct ast_node *desc;
+    struct module *mod;
+    struct symbol_table *st;
+    struct ast_node *genrdecl;
+};
+
+static bool ast_cmp_fn(struct type *t, struct type_objset_ast_cmp_ctx *ctx)
+{
+    return type_get_uid(t) == ctx->uid &&
+        type_equals_ast_node(t, ctx->desc, ctx->mod, ctx->st, ctx->genrdecl, TYPECMP_IDENTICAL);
+}
+
+struct type *type_objset_has_ast_node(const struct rf_objset_type *set,
+                                      size_t uid,
+                                      const struct ast_node *desc,
+                                      struct module *mod,
+                                      struct symbol_table *st,
+                                      struct ast_node *genrdecl)
+{
+    struct type_objset_ast_cmp_ctx ctx = {
+        .uid = uid, .desc = desc, .mod = mod, .st = st, .genrdecl = genrdecl
+    };
+    return htable_get(&set->raw.ht,
+                      uid,
+                      (bool (*)(const void *, void *))ast_cmp_fn,
+                      &ctx);
+}
+
 struct type *type_objset_has_string(const struct rf_objset_type *set, const struct RFstring *desc)
 {
-    return type_objset_has_uid(set, rf_hash_str_stable(desc, 0));
+    struct rf_objset_iter it;
+    struct type *t;
+    bool found;
+    rf_objset_foreach(set, &it, t) {
+        RFS_PUSH();
+        found = rf_string_equal(type_str_or_die(t, TSTR_DEFINED_CONTENTS), desc);
+        RFS_POP();
+        if (found) {
+            return t;
+        }
+    }
+    return NULL;
 }
 
 void type_objset_destroy(struct rf_objset_type *set,
@@ -281,13 +281,19 @@ static enum traversal_cb_res typecheck_member_access(struct ast_node *n,
     }
 
     // get ast type description of the left member
-    const struct ast_node *desc = symbol_table_lookup_node(ctx->current_st, ast_identifier_str(left), NULL);
+    const struct ast_node *desc = symbol_table_lookup_node_id(ctx->current_st,
+                                                              ast_identifier_id(left),
+                                                              ast_identifier_hash(left),
+                                                              NULL);
     if (desc->type == AST_TYPE_LEAF) {
         // if it's a typeleaf we need the type description of it's right member
         desc = ast_typeleaf_right(desc);
         if (desc->type == AST_XIDENTIFIER) {
             // if it's an identifier we need to look it up again
-            desc = symbol_table_lookup_node(ctx->current_st, ast_identifier_str(desc), NULL);
+            desc = symbol_table_lookup_node_id(ctx->current_st,
+                                               ast_identifier_id(desc),
+                                               ast_identifier_hash(desc),
+                                               NULL);
         }
     }
     if (!desc) {
@@ -350,8 +356,7 @@ static enum traversal_cb_res typecheck_identifier(struct ast_node *n,
     }
 
     traversal_node_set_type(n,
-                            type_lookup_identifier_string(ast_identifier_str(n),
-                                                          ctx->current_st),
+                            type_lookup_identifier(n, ctx->current_st),
                             ctx);
 
     const struct type *id_type = ast_node_get_type(n);
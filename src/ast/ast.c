@@ -1,5 +1,8 @@
 #include <ast/ast.h>
 
+#include <stddef.h>
+#include <string.h>
+
 #include <ast/block.h>
 #include <ast/function.h>
 #include <ast/type.h>
@@ -8,7 +11,9 @@
 
 #include <Utils/sanity.h>
 #include <Utils/build_assert.h>
+#include <Definitions/threadspecific.h>
 #include <RFmemory.h>
+#include <utils/arena.h>
 
 static const struct RFstring ast_type_strings[] = {
     [AST_ROOT] = RF_STRING_STATIC_INIT("root"),
@@ -51,29 +56,106 @@ static const struct RFstring ast_state_strings[] = {
 
 #define AST_NODE_IS_LEAF(node_) ((node_)->type >= AST_STRING_LITERAL)
 
+#define AST_NODE_SIZE(member_)                                          \
+    (offsetof(struct ast_node, member_) +                               \
+     sizeof(((struct ast_node*)0)->member_))
+//! Nodes of types with no type specific data only need the common part
+#define AST_NODE_SIZE_COMMON (offsetof(struct ast_node, root))
+
+static const size_t ast_node_sizes[] = {
+    [AST_ROOT] = AST_NODE_SIZE(root),
+    [AST_BLOCK] = AST_NODE_SIZE(block),
+    [AST_VARIABLE_DECLARATION] = AST_NODE_SIZE(vardecl),
+    [AST_RETURN_STATEMENT] = AST_NODE_SIZE(returnstmt),
+    [AST_TYPE_DECLARATION] = AST_NODE_SIZE(typedecl),
+    [AST_TYPE_OPERATOR] = AST_NODE_SIZE(typeop),
+    [AST_TYPE_LEAF] = AST_NODE_SIZE(typeleaf),
+    [AST_TYPE_DESCRIPTION] = AST_NODE_SIZE(typedesc),
+    [AST_TYPECLASS_DECLARATION] = AST_NODE_SIZE(typeclass),
+    [AST_TYPECLASS_INSTANCE] = AST_NODE_SIZE(typeinstance),
+    [AST_GENERIC_DECLARATION] = AST_NODE_SIZE_COMMON,
+    [AST_GENERIC_TYPE] = AST_NODE_SIZE(genrtype),
+    [AST_GENERIC_ATTRIBUTE] = AST_NODE_SIZE_COMMON,
+    [AST_FUNCTION_DECLARATION] = AST_NODE_SIZE(fndecl),
+    [AST_FUNCTION_IMPLEMENTATION] = AST_NODE_SIZE(fnimpl),
+    [AST_FUNCTION_CALL] = AST_NODE_SIZE(fncall),
+    [AST_ARRAY_REFERENCE] = AST_NODE_SIZE_COMMON,
+    [AST_CONDITIONAL_BRANCH] = AST_NODE_SIZE(condbranch),
+    [AST_IF_EXPRESSION] = AST_NODE_SIZE(ifexpr),
+    [AST_MATCH_EXPRESSION] = AST_NODE_SIZE(matchexpr),
+    [AST_MATCH_CASE] = AST_NODE_SIZE(matchcase),
+    [AST_MODULE] = AST_NODE_SIZE(module),
+    [AST_IMPORT] = AST_NODE_SIZE(import),
+    [AST_XIDENTIFIER] = AST_NODE_SIZE(xidentifier),
+    [AST_BINARY_OPERATOR] = AST_NODE_SIZE(binaryop),
+    [AST_UNARY_OPERATOR] = AST_NODE_SIZE(unaryop),
+    [AST_STRING_LITERAL] = AST_NODE_SIZE(string_literal),
+    [AST_IDENTIFIER] = AST_NODE_SIZE(identifier),
+    [AST_CONSTANT] = AST_NODE_SIZE(constant),
+};
+
+size_t ast_node_size(enum ast_type type)
+{
+    return ast_node_sizes[type];
+}
+
 void ast_node_init(struct ast_node * n, enum ast_type type)
 {
-    RF_STRUCT_ZERO(n);
+    memset(n, 0, ast_node_size(type));
     n->state = AST_NODE_STATE_CREATED;
     n->type = type;
-    rf_ilist_head_init(&n->children);
+}
+
+//! The arena new nodes are allocated from. If NULL nodes are malloc'ed.
+//! Thread local since each parsing thread fills its own front's arena.
+static i_THREAD__ struct arena *i_ast_arena = NULL;
+
+struct arena *ast_arena_set(struct arena *a)
+{
+    struct arena *prev = i_ast_arena;
+    i_ast_arena = a;
+    return prev;
+}
+
+//! Nodes created minus nodes destroyed by the calling thread
+static i_THREAD__ int64_t i_ast_nodes_live = 0;
+
+int64_t ast_nodes_live()
+{
+    return i_ast_nodes_live;
+}
+
+static struct ast_node *ast_node_alloc(enum ast_type type)
+{
+    struct ast_node *ret;
+    if (i_ast_arena) {
+        ret = arena_alloc(i_ast_arena, ast_node_size(type));
+        if (!ret) {
+            RF_ERRNOMEM();
+            return NULL;
+        }
+        ast_node_init(ret, type);
+        ret->in_arena = true;
+    } else {
+        RF_MALLOC(ret, ast_node_size(type), return NULL);
+        ast_node_init(ret, type);
+    }
+    ++i_ast_nodes_live;
+    return ret;
 }
 
 struct ast_node *ast_node_create(enum ast_type type)
 {
-   struct ast_node *ret;
-   RF_MALLOC(ret, sizeof(struct ast_node), return NULL);
-   ast_node_init(ret, type);
-   return ret;
+    return ast_node_alloc(type);
 }
 
 struct ast_node *ast_node_create_loc(enum ast_type type,
                                      const struct inplocation *loc)
 {
-    struct ast_node *ret;
-    RF_MALLOC(ret, sizeof(struct ast_node), return NULL);
-
-    ast_node_init(ret, type);
+    struct ast_node *ret = ast_node_alloc(type);
+    if (!ret) {
+        return NULL;
+    }
     inplocation_copy(&ret->location, loc);
 
     return ret;
@@ -83,11 +165,10 @@ struct ast_node *ast_node_create_marks(enum ast_type type,
                                        const struct inplocation_mark *start,
                                        const struct inplocation_mark *end)
 {
-
-    struct ast_node *ret;
-    RF_MALLOC(ret, sizeof(struct ast_node), return NULL);
-
-    ast_node_init(ret, type);
+    struct ast_node *ret = ast_node_alloc(type);
+    if (!ret) {
+        return NULL;
+    }
     inplocation_init_marks(&ret->location, start, end);
 
     return ret;
@@ -97,10 +178,10 @@ struct ast_node *ast_node_create_ptrs(enum ast_type type,
                                       struct inpfile *f,
                                       char *sp, char *ep)
 {
-    struct ast_node *ret;
-    RF_MALLOC(ret, sizeof(struct ast_node), return NULL);
-
-    ast_node_init(ret, type);
+    struct ast_node *ret = ast_node_alloc(type);
+    if (!ret) {
+        return NULL;
+    }
     if (!inplocation_init(&ret->location, f, sp, ep)) {
         return NULL;
     }
@@ -112,47 +193,41 @@ struct ast_node *ast_node_create_ptrs(enum ast_type type,
 void ast_node_destroy(struct ast_node *n)
 {
     struct ast_node *child;
-    struct ast_node *tmp;
-
-    /* type specific destruction  -- only if owned by analyzer and after */
-    if (n->state >= AST_NODE_STATE_ANALYZER_PASS1) {
-        switch(n->type) {
-        case AST_ROOT:
-            symbol_table_deinit(ast_root_symbol_table_get(n));
-            break;
-        case AST_BLOCK:
-            symbol_table_deinit(ast_block_symbol_table_get(n));
-            break;
-        case AST_FUNCTION_IMPLEMENTATION:
-            symbol_table_deinit(ast_fnimpl_symbol_table_get(n));
-            break;
-        case AST_TYPE_DESCRIPTION:
-            symbol_table_deinit(ast_typedesc_symbol_table_get(n));
-            break;
-        case AST_MODULE:
-            symbol_table_deinit(ast_module_symbol_table_get(n));
-            break;
-        default:
-            // no type specific destruction for the rest
-            break;
-        }
+
+    /* type specific destruction. Symbol tables are only created by the analyzer */
+    switch(n->type) {
+    case AST_ROOT:
+        symbol_table_destroy(n->root.st);
+        break;
+    case AST_BLOCK:
+        symbol_table_destroy(n->block.st);
+        break;
+    case AST_FUNCTION_DECLARATION:
+        symbol_table_destroy(n->fndecl.st);
+        break;
+    case AST_TYPE_DESCRIPTION:
+        symbol_table_destroy(n->typedesc.st);
+        break;
+    case AST_MODULE:
+        symbol_table_destroy(n->module.st);
+        break;
+    default:
+        // no type specific destruction for the rest
+        break;
     }
 
-    rf_ilist_for_each_safe(&n->children, child, tmp, lh) {
+    ast_node_foreach_child(n, child) {
         ast_node_destroy(child);
     }
+    if (!n->children_in_arena) {
+        free(n->children);
+    }
 
-    // free node unless it's a value node still at lexing/parsing phase
-    if (!(n->state == AST_NODE_STATE_CREATED && ast_node_has_value(n))) {
+    // arena nodes are released all together with their arena
+    if (!n->in_arena) {
         free(n);
     }
-}
-
-void ast_node_destroy_from_lexer(struct ast_node *n)
-{
-    RF_ASSERT(ast_node_has_value(n), "Requested to destroy a non value node from lexer");
-    n->state = AST_NODE_STATE_AFTER_PARSING; // just make sure it's deleteable
-    ast_node_destroy(n);
+    --i_ast_nodes_live;
 }
 
 void ast_node_set_start(struct ast_node *n, const struct inplocation_mark *start)
@@ -165,10 +240,44 @@ void ast_node_set_end(struct ast_node *n, const struct inplocation_mark *end)
     inplocation_set_end(&n->location, end);
 }
 
-void ast_node_add_child(struct ast_node *parent,
+static bool ast_node_grow_children(struct ast_node *parent)
+{
+    struct ast_node **children;
+    uint32_t num = parent->children_num;
+    size_t size = sizeof(*children) * (num == 0 ? 2 : num * 2);
+    if (i_ast_arena) {
+        children = arena_alloc(i_ast_arena, size);
+        if (!children) {
+            RF_ERRNOMEM();
+            return false;
+        }
+    } else {
+        RF_MALLOC(children, size, return false);
+    }
+    if (num != 0) {
+        memcpy(children, parent->children, sizeof(*children) * num);
+    }
+    // an old array in an arena just stays there until the arena goes away
+    if (!parent->children_in_arena) {
+        free(parent->children);
+    }
+    parent->children = children;
+    parent->children_in_arena = i_ast_arena != NULL;
+    return true;
+}
+
+bool ast_node_add_child(struct ast_node *parent,
                         struct ast_node *child)
 {
-    rf_ilist_add_tail(&parent->children, &child->lh);
+    uint32_t num = parent->children_num;
+    // the array is full when its size reaches a new power of two
+    if (num == 0 || (num >= 2 && (num & (num - 1)) == 0)) {
+        if (!ast_node_grow_children(parent)) {
+            return false;
+        }
+    }
+    parent->children[parent->children_num++] = child;
+    return true;
 }
 
 const struct RFstring *ast_node_get_name_str(const struct ast_node *n)
@@ -188,11 +297,11 @@ const struct RFstring *ast_node_get_name_str(const struct ast_node *n)
     }
 }
 
+i_INLINE_INS void ast_node_add_child_or_die(struct ast_node *parent,
+                                            struct ast_node *child);
 i_INLINE_INS struct ast_node *ast_node_get_child(struct ast_node *n,
                                                   unsigned int num);
 i_INLINE_INS unsigned int ast_node_get_children_number(const struct ast_node *n);
-i_INLINE_INS const char *ast_node_startsp(const struct ast_node *n);
-i_INLINE_INS const char *ast_node_endsp(const struct ast_node *n);
 i_INLINE_INS const struct inplocation *ast_node_location(const struct ast_node *n);
 i_INLINE_INS const struct inplocation_mark *ast_node_startmark(const struct ast_node *n);
 i_INLINE_INS const struct inplocation_mark *ast_node_endmark(const struct ast_node *n);
@@ -289,6 +398,13 @@ struct ast_node *ast_root_create(struct inpfile *file)
     return n;
 }
 
+bool ast_root_symbol_table_init(struct ast_node *n)
+{
+    AST_NODE_ASSERT_TYPE(n, AST_ROOT);
+    n->root.st = root_symbol_table_create();
+    return n->root.st;
+}
+
 i_INLINE_INS struct symbol_table *ast_root_symbol_table_get(struct ast_node *n);
 
 void ast_print(struct ast_node *n, struct inpfile *f, int depth)
@@ -302,7 +418,7 @@ void ast_print(struct ast_node *n, struct inpfile *f, int depth)
         break;
     default:
         printf(RF_STR_PF_FMT"\n", RF_STR_PF_ARG(ast_node_str(n)));
-        rf_ilist_for_each(&n->children, c, lh) {
+        ast_node_foreach_child(n, c) {
             ast_print(c, f, depth + 1);
         }
         break;
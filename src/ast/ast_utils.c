@@ -12,7 +12,7 @@ bool ast_pre_traverse_tree(struct ast_node *n,
         return false;
     }
 
-    rf_ilist_for_each(&n->children, child, lh) {
+    ast_node_foreach_child(n, child) {
         if (!ast_pre_traverse_tree(child, cb, user_arg)) {
             return false;
         }
@@ -27,7 +27,7 @@ bool ast_post_traverse_tree(struct ast_node *n,
 {
     struct ast_node *child;
 
-    rf_ilist_for_each(&n->children, child, lh) {
+    ast_node_foreach_child(n, child) {
         if (!ast_post_traverse_tree(child, cb, user_arg)) {
             return false;
         }
@@ -51,7 +51,7 @@ bool ast_traverse_tree(struct ast_node *n,
         return false;
     }
 
-    rf_ilist_for_each(&n->children, child, lh) {
+    ast_node_foreach_child(n, child) {
         if (!ast_traverse_tree(child, pre_cb, pre_user_arg,
                                post_cb, post_user_arg)) {
             return false;
@@ -79,7 +79,7 @@ enum traversal_cb_res ast_traverse_tree_nostop_post_cb(struct ast_node *n,
         return false;
     }
 
-    rf_ilist_for_each(&n->children, child, lh) {
+    ast_node_foreach_child(n, child) {
         rc = ast_traverse_tree_nostop_post_cb(child, pre_cb, pre_user_arg, post_cb, post_user_arg);
         if (rc == TRAVERSAL_CB_FATAL_ERROR) {
             return rc;
@@ -17,4 +17,4 @@ struct ast_node *ast_block_create()
 i_INLINE_INS bool ast_block_symbol_table_init(struct ast_node *n,
                                               struct module *m);
 i_INLINE_INS struct symbol_table* ast_block_symbol_table_get(struct ast_node *n);
-i_INLINE_INS void ast_block_add_element(struct ast_node *n, struct ast_node *element);
+i_INLINE_INS bool ast_block_add_element(struct ast_node *n, struct ast_node *element);
@@ -15,9 +15,9 @@ struct ast_node *ast_genrtype_create(struct ast_node *type, struct ast_node *id)
         return NULL;
     }
 
-    ast_node_add_child(ret, type);
+    ast_node_add_child_or_die(ret, type);
     ret->genrtype.type = type;
-    ast_node_add_child(ret, id);
+    ast_node_add_child_or_die(ret, id);
     ret->genrtype.id = id;
     return ret;
 }
@@ -43,7 +43,7 @@ struct ast_node *ast_genrdecl_string_is_genr(struct ast_node *n,
     struct ast_node *child;
 
     AST_NODE_ASSERT_TYPE(n, AST_GENERIC_DECLARATION);
-    rf_ilist_for_each(&n->children, child, lh) {
+    ast_node_foreach_child(n, child) {
         if (rf_string_equal(id, ast_genrtype_id_str(child))) {
             return child;
         }
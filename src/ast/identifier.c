@@ -2,24 +2,46 @@
 
 #include <ast/ast.h>
 #include <module.h>
+#include <compiler.h>
+#include <utils/string_interner.h>
 #include <types/type.h>
 
 #include <Utils/sanity.h>
 
 
-struct ast_node *ast_identifier_create(struct inplocation *loc)
+struct ast_node *ast_identifier_create_interned(struct inplocation *loc,
+                                                struct inpfile *f,
+                                                uint32_t id)
 {
     struct ast_node *ret;
     ret = ast_node_create_loc(AST_IDENTIFIER, loc);
     if (!ret) {
         return NULL;
     }
-    RF_STRING_SHALLOW_INIT(&ret->identifier.string, loc->start.p,
-                           loc->end.p - loc->start.p + 1);
+    RF_STRING_SHALLOW_INIT(&ret->identifier.string,
+                           inplocation_mark_p(&loc->start, f),
+                           loc->end.off - loc->start.off + 1);
+    ret->identifier.id = id;
+    ret->identifier.hash = string_interner_hash(compiler_identifiers(), id);
 
     return ret;
 }
 
+struct ast_node *ast_identifier_create(struct inplocation *loc,
+                                       struct inpfile *f)
+{
+    struct RFstring s;
+    uint32_t id;
+    RF_STRING_SHALLOW_INIT(&s,
+                           inplocation_mark_p(&loc->start, f),
+                           loc->end.off - loc->start.off + 1);
+    id = string_interner_add(compiler_identifiers(), &s);
+    if (id == STRING_INTERNER_INVALID_ID) {
+        return NULL;
+    }
+    return ast_identifier_create_interned(loc, f, id);
+}
+
 void ast_identifier_print(struct ast_node *n, int depth)
 {
     AST_NODE_ASSERT_TYPE(n, AST_IDENTIFIER);
@@ -56,9 +78,31 @@ const struct RFstring *ast_identifier_analyzed_str(const struct ast_node *n)
 #endif
 }
 
-bool ast_identifier_hash_create(struct ast_node *n, struct module *m)
+void ast_identifier_intern(struct ast_node *n)
+{
+    AST_NODE_ASSERT_TYPE(n, AST_IDENTIFIER);
+    n->identifier.string = *string_interner_str(compiler_identifiers(),
+                                                n->identifier.id);
+}
+
+uint32_t ast_identifier_id(const struct ast_node *n)
 {
-    return rf_objset_add(&m->identifiers_set, string, &n->identifier.string);
+    RF_ASSERT(n->type == AST_IDENTIFIER || n->type == AST_XIDENTIFIER,
+              "Unexpected ast node type");
+    if (n->type == AST_XIDENTIFIER) {
+        n = n->xidentifier.id;
+    }
+    return n->identifier.id;
+}
+
+uint32_t ast_identifier_hash(const struct ast_node *n)
+{
+    RF_ASSERT(n->type == AST_IDENTIFIER || n->type == AST_XIDENTIFIER,
+              "Unexpected ast node type");
+    if (n->type == AST_XIDENTIFIER) {
+        n = n->xidentifier.id;
+    }
+    return n->identifier.hash;
 }
 
 bool string_is_wildcard(const struct RFstring *s)
@@ -85,12 +129,12 @@ struct ast_node *ast_xidentifier_create(const struct inplocation_mark *start,
         return NULL;
     }
 
-    ast_node_add_child(ret, id);
+    ast_node_add_child_or_die(ret, id);
     ret->xidentifier.is_constant = is_constant;
     ret->xidentifier.id = id;
     ret->xidentifier.genr = genr;
     if (genr) {
-        ast_node_add_child(ret, genr);
+        ast_node_add_child_or_die(ret, genr);
     }
 
     return ret;
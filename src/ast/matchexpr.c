@@ -74,8 +74,8 @@ const struct type *ast_matchexpr_matched_type_compute(struct ast_node *n,
     // make sure we don't get two times in here
     RF_ASSERT(!n->matchexpr.matching_type, "A match expression's matching type has already been computed");
     const struct type *matching_type = ast_matchexpr_has_header(n)
-       ? matching_type = type_lookup_identifier_string(
-           ast_identifier_str(n->matchexpr.identifier_or_fnargtype),
+       ? matching_type = type_lookup_identifier(
+           n->matchexpr.identifier_or_fnargtype,
            st
        )
        :
@@ -153,61 +153,45 @@ end:
     return ret;
 }
 
-void ast_matchexpr_add_case(struct ast_node *n, struct ast_node *mcase)
+bool ast_matchexpr_add_case(struct ast_node *n, struct ast_node *mcase)
 {
-    ast_node_add_child(n, mcase);
+    if (!ast_node_add_child(n, mcase)) {
+        return false;
+    }
     ++n->matchexpr.match_cases_num;
+    return true;
 }
 
 struct ast_node *ast_matchexpr_first_case(const struct ast_node *n,
                                           struct ast_matchexpr_it *it)
 {
     AST_NODE_ASSERT_TYPE(n, AST_MATCH_EXPRESSION);
-    unsigned int i = 0;
-    struct ast_node *child;
     // ugly way to get second child if we have a matched identifier so that we
     // start from the first matchase
-    unsigned int start = ast_matchexpr_has_header(n) ? 1 : 0;
-    rf_ilist_for_each(&n->children, child, lh) {
-        if (i >= start) {
-            it->lh = &n->children;
-            it->ln = &child->lh;
-            return child;
-        }
-        ++i;
-    }
-    return NULL;
+    it->idx = ast_matchexpr_has_header(n) ? 1 : 0;
+    return it->idx < n->children_num ? n->children[it->idx] : NULL;
 }
 
 bool ast_match_expr_next_case_is_last(const struct ast_node *matchexpr,
                                       struct ast_matchexpr_it *it)
 {
     AST_NODE_ASSERT_TYPE(matchexpr, AST_MATCH_EXPRESSION);
-    return it->ln->next == &it->lh->n;
+    return it->idx + 1 >= matchexpr->children_num;
 }
 
 struct ast_node *ast_matchexpr_next_case(const struct ast_node *n,
                                          struct ast_matchexpr_it *it)
 {
-    struct ast_node *ret;
     AST_NODE_ASSERT_TYPE(n, AST_MATCH_EXPRESSION);
-    if (it->ln->next == &it->lh->n) {
+    if (it->idx + 1 >= n->children_num) {
         return NULL;
     }
-    it->ln = it->ln->next;
-    return rf_ilist_node_to_off(it->ln, rf_ilist_off_var(ret, lh));
+    return n->children[++it->idx];
 }
 
 struct ast_node *ast_matchexpr_get_case(const struct ast_node *n, unsigned int i)
 {
     AST_NODE_ASSERT_TYPE(n, AST_MATCH_EXPRESSION);
-    struct ast_matchexpr_it it;
-    unsigned int count = 0;
-    struct ast_node *mcase;
-    ast_matchexpr_foreach(n, &it, mcase) {
-        if (count++ == i) {
-            return mcase;
-        }
-    }
-    return NULL;
+    i += ast_matchexpr_has_header(n) ? 1 : 0;
+    return i < n->children_num ? n->children[i] : NULL;
 }
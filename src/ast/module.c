@@ -34,5 +34,7 @@ struct ast_node *ast_module_create(const struct inplocation_mark *start,
     return ret;
 }
 
+i_INLINE_INS bool ast_module_symbol_table_init(struct ast_node *n,
+                                               struct module *m);
 i_INLINE_INS struct symbol_table *ast_module_symbol_table_get(struct ast_node *n);
 i_INLINE_INS const struct RFstring *ast_module_name(const struct ast_node *n);
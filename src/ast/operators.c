@@ -96,6 +96,49 @@ enum binaryop_type binaryop_type_from_token(struct token *tok)
     return bop_type_lookup[tok->type];
 }
 
+/**
+ * Binding power of the binary operators, from the loosest to the tightest.
+ * All binary operators are left associative.
+ */
+static const uint8_t binaryop_precedence[] = {
+    [BINARYOP_COMMA]              = 1,
+    [BINARYOP_ASSIGN]             = 2,
+    [BINARYOP_LOGIC_OR]           = 3,
+    [BINARYOP_LOGIC_AND]          = 4,
+    [BINARYOP_BITWISE_OR]         = 5,
+    [BINARYOP_BITWISE_XOR]        = 6,
+    [BINARYOP_BITWISE_AND]        = 7,
+    [BINARYOP_CMP_EQ]             = 8,
+    [BINARYOP_CMP_NEQ]            = 8,
+    [BINARYOP_CMP_GT]             = 9,
+    [BINARYOP_CMP_GTEQ]           = 9,
+    [BINARYOP_CMP_LT]             = 9,
+    [BINARYOP_CMP_LTEQ]           = 9,
+    [BINARYOP_ADD]                = 10,
+    [BINARYOP_SUB]                = 10,
+    [BINARYOP_MUL]                = 11,
+    [BINARYOP_DIV]                = 11,
+    [BINARYOP_MEMBER_ACCESS]      = 12,
+    [BINARYOP_ARRAY_REFERENCE]    = 12,
+};
+
+unsigned int ast_binaryop_precedence(enum binaryop_type op)
+{
+    return binaryop_precedence[op];
+}
+
+unsigned int binaryop_precedence_from_token(const struct token *tok)
+{
+    // bitwise OR/AND tokens are never lexed, their symbols give the
+    // typesum/ampersand tokens
+    if (!token_is_binaryop(tok) ||
+        tok->type == TOKEN_OP_BITWISE_OR ||
+        tok->type == TOKEN_OP_BITWISE_AND) {
+        return 0;
+    }
+    return binaryop_precedence[bop_type_lookup[tok->type]];
+}
+
 static const enum token_type  token_type_from_bop_lookup[] = {
     [BINARYOP_ADD]                =   TOKEN_OP_PLUS,
     [BINARYOP_SUB]                =   TOKEN_OP_MINUS,
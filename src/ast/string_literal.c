@@ -4,15 +4,17 @@
 
 #include <module.h>
 
-struct ast_node *ast_string_literal_create(struct inplocation *loc)
+struct ast_node *ast_string_literal_create(struct inplocation *loc,
+                                           struct inpfile *f)
 {
     struct ast_node *ret;
     ret = ast_node_create_loc(AST_STRING_LITERAL, loc);
     if (!ret) {
         return NULL;
     }
-    RF_STRING_SHALLOW_INIT(&ret->string_literal.string, loc->start.p + 1,
-                           loc->end.p - loc->start.p - 1);
+    RF_STRING_SHALLOW_INIT(&ret->string_literal.string,
+                           inplocation_mark_p(&loc->start, f) + 1,
+                           loc->end.off - loc->start.off - 1);
     ret->string_literal.hash = rf_hash_str_stable(&ret->string_literal.string, 0);
 
     return ret;
@@ -58,7 +58,7 @@ struct ast_node *ast_typeop_create(const struct inplocation_mark *start,
     }
 
     ret->typeop.type = type;
-    ast_node_add_child(ret, left);
+    ast_node_add_child_or_die(ret, left);
     ret->typeop.left = left;
     if (right) {
     RF_ASSERT(right->type == AST_TYPE_DESCRIPTION ||
@@ -66,7 +66,7 @@ struct ast_node *ast_typeop_create(const struct inplocation_mark *start,
               right->type == AST_TYPE_LEAF ||
               right->type == AST_XIDENTIFIER,
               "Unexpected ast node type");
-        ast_node_add_child(ret, right);
+        ast_node_add_child_or_die(ret, right);
         ret->typeop.right = right;
     }
 
@@ -76,7 +76,7 @@ struct ast_node *ast_typeop_create(const struct inplocation_mark *start,
 void ast_typeop_set_right(struct ast_node *op, struct ast_node *r)
 {
     AST_NODE_ASSERT_TYPE(op, AST_TYPE_OPERATOR);
-    ast_node_add_child(op, r);
+    ast_node_add_child_or_die(op, r);
     op->typeop.right = r;
     ast_node_set_end(op, ast_node_endmark(r));
 }
@@ -122,6 +122,8 @@ struct ast_node *ast_typedesc_create(struct ast_node *desc)
     ast_node_register_child(ret, desc, typedesc.desc);
     return ret;
 }
+i_INLINE_INS bool ast_typedesc_symbol_table_init(struct ast_node *n,
+                                                 struct module *m);
 i_INLINE_INS struct symbol_table *ast_typedesc_symbol_table_get(struct ast_node *n);
 i_INLINE_INS struct ast_node *ast_typedesc_desc_get(const struct ast_node *n);
 
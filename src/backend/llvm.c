@@ -1,24 +1,36 @@
 #include <backend/llvm.h>
 
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
 #include <llvm-c/Core.h>
 #include <llvm-c/Analysis.h>
+#include <llvm-c/BitReader.h>
+#include <llvm-c/BitWriter.h>
 #include <llvm-c/ExecutionEngine.h>
 #include <llvm-c/Target.h>
 #include <llvm-c/Transforms/Scalar.h>
 
 #include <String/rf_str_core.h>
 #include <System/rf_system.h>
+#include <Utils/hash.h>
 #include <Persistent/buffers.h>
 
 #include <info/info.h>
 #include <analyzer/analyzer.h>
+#include <compiler.h>
 #include <compiler_args.h>
+#include <compiler_cache.h>
 #include <front_ctx.h>
+#include <inpfile.h>
 #include <module.h>
 #include <utils/common_strings.h>
 
 #include "llvm_ast.h"
 #include "llvm_utils.h"
+#include "../build_id.h" /* include the generated build identity */
 
 
 static inline void llvm_traversal_ctx_init(struct llvm_traversal_ctx *ctx,
@@ -35,12 +47,6 @@ static inline void llvm_traversal_ctx_init(struct llvm_traversal_ctx *ctx,
     strmap_init(&ctx->valmap);
 }
 
-static inline void llvm_traversal_ctx_deinit(struct llvm_traversal_ctx *ctx)
-{
-    LLVMDisposeBuilder(ctx->builder);
-    LLVMDisposeModule(ctx->llvm_mod);
-}
-
 static inline void llvm_traversal_ctx_set_singlepass(struct llvm_traversal_ctx *ctx,
                                                      struct module *m)
 {
@@ -64,64 +70,368 @@ static inline void llvm_traversal_ctx_reset_singlepass(struct llvm_traversal_ctx
     strmap_clear(&ctx->valmap);
 }
 
-static bool bllvm_ir_generate(struct modules_arr *modules, struct compiler_args *args)
+static pthread_once_t s_llvm_init_once = PTHREAD_ONCE_INIT;
+
+static void bllvm_init_once()
+{
+    LLVMInitializeCore(LLVMGetGlobalPassRegistry());
+    LLVMInitializeNativeTarget();
+}
+
+/**
+ * Initialize LLVM once for the whole process. It is never shut down since
+ * LLVM can't be initialized again after LLVMShutdown() and a process may
+ * compile many programs.
+ */
+static inline void bllvm_init()
+{
+    pthread_once(&s_llvm_init_once, bllvm_init_once);
+}
+
+static struct LLVMOpaqueModule *bllvm_load_bitcode(const char *file)
+{
+    LLVMMemoryBufferRef buff;
+    LLVMModuleRef llvm_module;
+    char *error = NULL;
+    if (LLVMCreateMemoryBufferWithContentsOfFile(file, &buff, &error)) {
+        bllvm_error("Could not read an LLVM bitcode file", &error);
+        return NULL;
+    }
+    if (LLVMParseBitcode(buff, &llvm_module, &error)) {
+        bllvm_error("Could not parse an LLVM bitcode file", &error);
+        llvm_module = NULL;
+    }
+    LLVMDisposeMemoryBuffer(buff);
+    return llvm_module;
+}
+
+//! Named metadata holding the stamp of the stdlib image
+#define STDLIB_IMAGE_STAMP_MD "refu.stdlib.stamp"
+
+const struct RFstring *bllvm_stdlib_stamp(const struct front_ctx *stdlib_front)
+{
+    struct RFstring contents;
+    RF_STRING_SHALLOW_INIT(&contents,
+                           inpfile_sp(stdlib_front->file),
+                           inpstr_len_from_beg(&stdlib_front->file->str));
+    return RFS_NT_OR_DIE("%d.%d.%d %s %08"PRIx32"%08"PRIx32,
+                         RF_LANG_MAJOR_VERSION,
+                         RF_LANG_MINOR_VERSION,
+                         RF_LANG_PATCH_VERSION,
+                         RF_LANG_BUILD_ID,
+                         rf_hash_str_stable(&contents, 0),
+                         rf_hash_str_stable(&contents, UINT32_MAX));
+}
+
+static void bllvm_module_set_stamp(struct LLVMOpaqueModule *llvm_module,
+                                   const struct RFstring *stamp)
+{
+    LLVMValueRef md = LLVMMDString(rf_string_data(stamp), rf_string_length_bytes(stamp));
+    LLVMAddNamedMetadataOperand(llvm_module, STDLIB_IMAGE_STAMP_MD, LLVMMDNode(&md, 1));
+}
+
+static bool bllvm_module_has_stamp(struct LLVMOpaqueModule *llvm_module,
+                                   const struct RFstring *stamp)
+{
+    LLVMValueRef node;
+    LLVMValueRef md;
+    const char *s;
+    unsigned int len;
+    struct RFstring found;
+    if (LLVMGetNamedMetadataNumOperands(llvm_module, STDLIB_IMAGE_STAMP_MD) != 1) {
+        return false;
+    }
+    LLVMGetNamedMetadataOperands(llvm_module, STDLIB_IMAGE_STAMP_MD, &node);
+    if (LLVMGetMDNodeNumOperands(node) != 1) {
+        return false;
+    }
+    LLVMGetMDNodeOperands(node, &md);
+    if (!(s = LLVMGetMDString(md, &len))) {
+        return false;
+    }
+    RF_STRING_SHALLOW_INIT(&found, s, len);
+    return rf_string_equal(&found, stamp);
+}
+
+struct LLVMOpaqueModule *bllvm_stdlib_image_load(const struct front_ctx *stdlib_front,
+                                                  const char *file)
+{
+    struct LLVMOpaqueModule *llvm_module;
+    struct RFstring file_str;
+    bllvm_init();
+    RF_STRING_SHALLOW_INIT(&file_str, file, strlen(file));
+    if (!rf_system_file_exists(&file_str) ||
+        !(llvm_module = bllvm_load_bitcode(file))) {
+        return NULL;
+    }
+    // an out of date image is ignored and the stdlib generated from its RIR
+    RFS_PUSH();
+    if (!bllvm_module_has_stamp(llvm_module, bllvm_stdlib_stamp(stdlib_front))) {
+        LLVMDisposeModule(llvm_module);
+        llvm_module = NULL;
+    }
+    RFS_POP();
+    return llvm_module;
+}
+
+void bllvm_stdlib_image_destroy(struct LLVMOpaqueModule *image)
+{
+    LLVMDisposeModule(image);
+}
+
+bool bllvm_emit_stdlib_image(struct module *stdlib, struct compiler_args *args)
 {
     struct llvm_traversal_ctx ctx;
     struct LLVMOpaqueModule *llvm_module;
-    struct LLVMOpaqueModule *stdlib_module;
-    const struct RFstring s_main = RF_STRING_STATIC_INIT("mainmodule");
+    char *error = NULL;
     bool ret = false;
-    char *error = NULL; // Used to retrieve messages from functions
 
-    LLVMInitializeCore(LLVMGetGlobalPassRegistry());
-    LLVMInitializeNativeTarget();
+    bllvm_init();
 
+    llvm_traversal_ctx_init(&ctx, args);
+    llvm_traversal_ctx_set_singlepass(&ctx, stdlib);
+    llvm_module = blvm_create_module(stdlib->rir, &ctx, &g_str_stdlib, NULL);
+    if (!llvm_module) {
+        ERROR("Failed to form the LLVM IR ast of the stdlib");
+        goto end;
+    }
+    if (LLVMVerifyModule(llvm_module, LLVMPrintMessageAction, &error) == 1) {
+        bllvm_error("Could not verify the stdlib LLVM module", &error);
+        goto end;
+    }
+    bllvm_error_dispose(&error);
+
+    // so that an image left over from another stdlib or compiler is not used
+    RFS_PUSH();
+    bllvm_module_set_stamp(llvm_module, bllvm_stdlib_stamp(stdlib->front));
+    RFS_POP();
+
+    if (0 != LLVMWriteBitcodeToFile(llvm_module, compiler_args_emit_stdlib_image(args))) {
+        ERROR("Could not write the stdlib image to \"%s\"",
+              compiler_args_emit_stdlib_image(args));
+        goto end;
+    }
+    ret = true;
+
+end:
+    llvm_traversal_ctx_reset_singlepass(&ctx);
+    LLVMDisposeBuilder(ctx.builder);
+    if (llvm_module) {
+        LLVMDisposeModule(llvm_module);
+    }
+    return ret;
+}
+
+//! Create the LLVM module of the stdlib from its RIR
+static struct LLVMOpaqueModule *bllvm_create_stdlib(struct module *stdlib,
+                                                    struct llvm_traversal_ctx *ctx)
+{
+    struct LLVMOpaqueModule *llvm_module;
+    char *error = NULL;
+    llvm_traversal_ctx_set_singlepass(ctx, stdlib);
+    llvm_module = blvm_create_module(stdlib->rir, ctx, &g_str_stdlib, NULL);
+    if (!llvm_module) {
+        ERROR("Failed to form the LLVM IR ast of the stdlib");
+    } else if (LLVMVerifyModule(llvm_module, LLVMPrintMessageAction, &error) == 1) {
+        bllvm_error("Could not verify the stdlib LLVM module", &error);
+        LLVMDisposeModule(llvm_module);
+        llvm_module = NULL;
+    }
+    bllvm_error_dispose(&error);
+    llvm_traversal_ctx_reset_singlepass(ctx);
+    return llvm_module;
+}
+
+/**
+ * Turn the definitions a module's LLVM code got from linking in the stdlib
+ * into declarations, so that it can be linked into the program next to the
+ * stdlib and to the other modules.
+ */
+static void bllvm_unit_declare_stdlib(struct LLVMOpaqueModule *unit,
+                                      struct LLVMOpaqueModule *stdlib_module)
+{
+    LLVMValueRef fn;
+    LLVMValueRef unit_fn;
+    LLVMValueRef decl;
+    LLVMValueRef g;
+    LLVMValueRef unit_g;
+    for (fn = LLVMGetFirstFunction(stdlib_module); fn; fn = LLVMGetNextFunction(fn)) {
+        if (LLVMIsDeclaration(fn) ||
+            !(unit_fn = LLVMGetNamedFunction(unit, LLVMGetValueName(fn)))) {
+            continue;
+        }
+        // the C API can't drop a function's body so replace the function
+        LLVMSetValueName(unit_fn, "");
+        decl = LLVMAddFunction(unit, LLVMGetValueName(fn),
+                               LLVMGetElementType(LLVMTypeOf(unit_fn)));
+        LLVMReplaceAllUsesWith(unit_fn, decl);
+        LLVMDeleteFunction(unit_fn);
+    }
+    for (g = LLVMGetFirstGlobal(stdlib_module); g; g = LLVMGetNextGlobal(g)) {
+        if (LLVMIsDeclaration(g) || LLVMGetLinkage(g) == LLVMPrivateLinkage ||
+            !(unit_g = LLVMGetNamedGlobal(unit, LLVMGetValueName(g)))) {
+            continue;
+        }
+        LLVMSetInitializer(unit_g, NULL);
+        LLVMSetLinkage(unit_g, LLVMExternalLinkage);
+    }
+    // what remains are the module's own string literals, which other
+    // modules may define too
+    for (g = LLVMGetFirstGlobal(unit); g; g = LLVMGetNextGlobal(g)) {
+        if (!LLVMIsDeclaration(g) && LLVMGetLinkage(g) == LLVMExternalLinkage) {
+            LLVMSetLinkage(g, LLVMLinkOnceODRLinkage);
+        }
+    }
+}
+
+//! Create the LLVM code of a single non-stdlib module
+static struct LLVMOpaqueModule *bllvm_create_unit(struct module *m,
+                                                  struct LLVMOpaqueModule *stdlib_module,
+                                                  struct llvm_traversal_ctx *ctx)
+{
+    static const struct RFstring s_main = RF_STRING_STATIC_INIT("mainmodule");
+    struct LLVMOpaqueModule *unit;
+    struct LLVMOpaqueModule *stdlib_copy;
+    char *error = NULL;
+
+    // linking consumes the stdlib so give it a copy
+    stdlib_copy = LLVMCloneModule(stdlib_module);
+    llvm_traversal_ctx_set_singlepass(ctx, m);
+    unit = blvm_create_module(m->rir, ctx, &s_main, stdlib_copy);
+    llvm_traversal_ctx_reset_singlepass(ctx);
+    LLVMDisposeModule(stdlib_copy);
+    if (!unit) {
+        ERROR("Failed to form the LLVM IR ast");
+        return NULL;
+    }
+
+    bllvm_unit_declare_stdlib(unit, stdlib_module);
+    if (LLVMVerifyModule(unit, LLVMPrintMessageAction, &error) == 1) {
+        bllvm_error("Could not verify LLVM module", &error);
+        LLVMDisposeModule(unit);
+        return NULL;
+    }
+    bllvm_error_dispose(&error);
+    return unit;
+}
+
+static struct LLVMOpaqueModule *bllvm_cache_fetch_unit(struct compiler_cache *cache,
+                                                       const struct module *m)
+{
+    const struct RFstring *entry;
+    struct LLVMOpaqueModule *unit = NULL;
+    if (!compiler_cache_enabled(cache)) {
+        return NULL;
+    }
+    RFS_PUSH();
+    entry = compiler_cache_module_entry_name(cache, m);
+    if (rf_system_file_exists(entry) &&
+        (unit = bllvm_load_bitcode(rf_string_data(entry)))) {
+        ++cache->module_hits;
+    }
+    RFS_POP();
+    return unit;
+}
+
+static void bllvm_cache_store_unit(const struct compiler_cache *cache,
+                                   const struct module *m,
+                                   struct LLVMOpaqueModule *unit)
+{
+    const struct RFstring *entry;
+    const struct RFstring *tmp;
+    if (!compiler_cache_enabled(cache)) {
+        return;
+    }
+    RFS_PUSH();
+    entry = compiler_cache_module_entry_name(cache, m);
+    tmp = compiler_cache_tmp_name(entry);
+    // same as compiler_cache_store(), never expose a partially written entry
+    if (0 != LLVMWriteBitcodeToFile(unit, rf_string_data(tmp)) ||
+        0 != rename(rf_string_data(tmp), rf_string_data(entry))) {
+        // not fatal, the next compilation will just miss the cache
+        remove(rf_string_data(tmp));
+        RF_ERROR("Failed to store the LLVM bitcode of module \""RF_STR_PF_FMT"\" "
+                 "in the compilation cache", RF_STR_PF_ARG(module_name(m)));
+    }
+    RFS_POP();
+}
+
+bool bllvm_generate_ir(struct modules_arr *modules, struct compiler_args *args)
+{
+    struct llvm_traversal_ctx ctx;
+    struct LLVMOpaqueModule *stdlib_module = NULL;
+    struct LLVMOpaqueModule *program = NULL;
+    struct LLVMOpaqueModule *unit;
+    struct compiler *c = compiler_instance_get();
+    struct compiler_cache *cache = &c->cache;
     struct module **mod;
-    bool index = 0;
+    bool ret = false;
+    char *error = NULL; // Used to retrieve messages from functions
+
+    bllvm_init();
+
     llvm_traversal_ctx_init(&ctx, args);
     darray_foreach(mod, *modules) {
-        llvm_traversal_ctx_set_singlepass(&ctx, *mod);
-        llvm_module = blvm_create_module((*mod)->rir, &ctx,
-                                         index == 0 ? &g_str_stdlib : &s_main,
-                                         index == 0 ? NULL : stdlib_module);
-        if (!llvm_module) {
-            ERROR("Failed to form the LLVM IR ast");
-            llvm_traversal_ctx_reset_singlepass(&ctx);
-            goto end;
+        // first module should be stdlib module
+        if (!stdlib_module) {
+            // the image is only read, so it can be used without a copy
+            stdlib_module = c->stdlib_image ? c->stdlib_image : bllvm_create_stdlib(*mod, &ctx);
+            if (!stdlib_module) {
+                goto end;
+            }
+            program = LLVMCloneModule(stdlib_module);
+            continue;
         }
 
-        // verify each module
-        if (LLVMVerifyModule(llvm_module, LLVMPrintMessageAction, &error) == 1) {
-            bllvm_error("Could not verify LLVM module", &error);
-            llvm_traversal_ctx_reset_singlepass(&ctx);
+        // each module gets its own LLVM module which is linked into the
+        // program, so that an unchanged module's code can come from the cache
+        if (!(unit = bllvm_cache_fetch_unit(cache, *mod))) {
+            if (!(unit = bllvm_create_unit(*mod, stdlib_module, &ctx))) {
+                goto end;
+            }
+            bllvm_cache_store_unit(cache, *mod, unit);
+        }
+        // if an error occurs LLVMLinkModules() returns true ...
+        if (true == LLVMLinkModules(program, unit, LLVMLinkerDestroySource, &error)) {
+            bllvm_error("Could not link LLVM modules", &error);
+            LLVMDisposeModule(unit);
             goto end;
         }
         bllvm_error_dispose(&error);
+        LLVMDisposeModule(unit);
+    }
 
-        // first module should be stdlib module
-        if (index == 0) {
-            stdlib_module = llvm_module;
-        }
-        llvm_traversal_ctx_reset_singlepass(&ctx);
-        ++index;
+    if (!program) {
+        ERROR("No modules to generate LLVM IR for");
+        goto end;
+    }
+    if (LLVMVerifyModule(program, LLVMPrintMessageAction, &error) == 1) {
+        bllvm_error("Could not verify the linked LLVM module", &error);
+        goto end;
     }
+    bllvm_error_dispose(&error);
 
     RFS_PUSH();
     struct RFstring *temp_s = RFS_NT_OR_DIE(
         RF_STR_PF_FMT".ll",
         RF_STR_PF_ARG(compiler_args_get_executable_name(args)));
-    if (0 != LLVMPrintModuleToFile(llvm_module, rf_string_data(temp_s), &error)) {
+    if (0 != LLVMPrintModuleToFile(program, rf_string_data(temp_s), &error)) {
         bllvm_error("Could not output LLVM module to file", &error);
         goto end_pop_rfs;
     }
     bllvm_error_dispose(&error);
-    llvm_traversal_ctx_deinit(&ctx);
     ret = true;
 
 end_pop_rfs:
     RFS_POP();
 end:
-    LLVMShutdown();
+    LLVMDisposeBuilder(ctx.builder);
+    if (program) {
+        LLVMDisposeModule(program);
+    }
+    if (stdlib_module && stdlib_module != c->stdlib_image) {
+        LLVMDisposeModule(stdlib_module);
+    }
     return ret;
 }
 
@@ -179,22 +489,28 @@ static bool backend_asm_to_exec(struct compiler_args *args)
     return transformation_step_do(args, "gcc", "s", "exe", "-L"RF_CLIB_ROOT" -lrefu -static");
 }
 
-bool bllvm_generate(struct modules_arr *modules, struct compiler_args *args)
+bool bllvm_compile_ir(struct compiler_args *args)
 {
-
-    if (!bllvm_ir_generate(modules, args)) {
-        return false;
-    }
-
+    struct compiler_profile *profile = &compiler_instance_get()->profile;
+    struct compiler_profile_sample sample;
+    compiler_profile_begin(profile, &sample);
     if (!bllvm_ir_to_asm(args)) {
         ERROR("Failed to generate assembly from LLVM IR code");
         return false;
     }
+    compiler_profile_end(profile, COMPILER_PHASE_LLC, &sample);
 
+    compiler_profile_begin(profile, &sample);
     if (!backend_asm_to_exec(args)) {
         ERROR("Failed to generate executable from assembly machine code");
         return false;
     }
+    compiler_profile_end(profile, COMPILER_PHASE_LINK, &sample);
 
     return true;
 }
+
+bool bllvm_generate(struct modules_arr *modules, struct compiler_args *args)
+{
+    return bllvm_generate_ir(modules, args) && bllvm_compile_ir(args);
+}
@@ -1,9 +1,14 @@
 #include "compiler.h"
 
+#include <limits.h>
+#include <pthread.h>
+
 #include <refu.h>
+#include <Definitions/threadspecific.h>
 #include <Utils/memory.h>
+#include <Persistent/buffers.h>
 
-#include <utils/string_set.h>
+#include <utils/common_strings.h>
 #include <info/info.h>
 #include <types/type_comparisons.h>
 #include <module.h>
@@ -16,28 +21,93 @@
 #include <ir/rir_utils.h>
 
 struct rir_module;
-static struct compiler *g_compiler_instance = NULL;
+//! The compiler the current thread works with
+static i_THREAD__ struct compiler *i_compiler_instance = NULL;
+
+//! Number of compilers alive in the process, guarded by @ref i_runtime_lock
+static unsigned int i_runtime_users = 0;
+static pthread_mutex_t i_runtime_lock = PTHREAD_MUTEX_INITIALIZER;
+//! Number of compilers alive that were created by the current thread
+static i_THREAD__ unsigned int i_thread_users = 0;
+
+static inline void compiler_bind(struct compiler *c)
+{
+    i_compiler_instance = c;
+}
+
+/**
+ * The refu library is initialized by the first compiler of the process and
+ * its thread specific data by the first compiler of each thread
+ */
+static bool compiler_runtime_acquire(int rf_logtype)
+{
+    bool ret = true;
+    pthread_mutex_lock(&i_runtime_lock);
+    if (i_runtime_users == 0) {
+        rf_init(rf_logtype,
+                "refu.log",
+                LOG_WARNING,
+                RF_DEFAULT_TS_MBUFF_INITIAL_SIZE,
+                RF_DEFAULT_TS_SBUFF_INITIAL_SIZE
+        );
+    } else if (i_thread_users == 0) {
+        ret = rf_init_thread_specific();
+    }
+    if (ret) {
+        ++i_runtime_users;
+    }
+    pthread_mutex_unlock(&i_runtime_lock);
+    if (!ret) {
+        return false;
+    }
+
+    // the type comparison context is thread local
+    if (i_thread_users == 0 && !typecmp_ctx_init()) {
+        return false;
+    }
+    ++i_thread_users;
+    return true;
+}
+
+static void compiler_runtime_release()
+{
+    if (--i_thread_users == 0) {
+        typecmp_ctx_deinit();
+    }
+    pthread_mutex_lock(&i_runtime_lock);
+    if (--i_runtime_users == 0) {
+        rf_deinit();
+    } else if (i_thread_users == 0) {
+        rf_deinit_thread_specific();
+    }
+    pthread_mutex_unlock(&i_runtime_lock);
+}
+
+static size_t modules_index_rehash(const void *e, void *user_arg)
+{
+    const struct module *m = e;
+    return string_interner_hash(&((struct compiler*)user_arg)->identifiers, m->name_id);
+}
 
 bool compiler_init(struct compiler *c, int rf_logtype, bool with_stdlib)
 {
     RF_STRUCT_ZERO(c);
+    compiler_bind(c);
 
-    // initialize Refu library
-    rf_init(rf_logtype,
-            "refu.log",
-            LOG_WARNING,
-            RF_DEFAULT_TS_MBUFF_INITIAL_SIZE,
-            RF_DEFAULT_TS_SBUFF_INITIAL_SIZE
-    );
+    // initialize Refu library and the type comparison thread local context
+    if (!compiler_runtime_acquire(rf_logtype)) {
+        return false;
+    }
 
     darray_init(c->modules);
+    htable_init(&c->modules_index, modules_index_rehash, c);
 
     // initialize an error buffer string
     if (!rf_stringx_init_buff(&c->err_buff, 1024, "")) {
         return false;
     }
-    // initialize the type comparison thread local context
-    if (!typecmp_ctx_init()) {
+    // create some utilities needed by all the rir modules
+    if (!rir_utils_create()) {
         return false;
     }
 
@@ -51,6 +121,17 @@ bool compiler_init(struct compiler *c, int rf_logtype, bool with_stdlib)
     rf_ilist_head_init(&c->front_ctxs);
     c->use_stdlib = with_stdlib;
 
+    if (!string_interner_init(&c->identifiers)) {
+        return false;
+    }
+    if (!compiler_profile_init(&c->profile)) {
+        return false;
+    }
+    c->main_name_id = string_interner_add(&c->identifiers, &g_str_main);
+    if (c->main_name_id == STRING_INTERNER_INVALID_ID) {
+        return false;
+    }
+
     return true;
 }
 
@@ -58,17 +139,13 @@ struct compiler *compiler_alloc()
 {
     struct compiler *ret;
     RF_MALLOC(ret, sizeof(*ret), return NULL);
-    g_compiler_instance = ret;
     return ret;
 }
 
 struct compiler *compiler_create(int rf_logtype, bool with_stdlib)
 {
-
-    RF_ASSERT_OR_EXIT(!g_compiler_instance, 
-                      "compiler_create() was called a second time");
     struct compiler *compiler = compiler_alloc();
-    return compiler_init(compiler, rf_logtype, with_stdlib) ? compiler : NULL;
+    return compiler && compiler_init(compiler, rf_logtype, with_stdlib) ? compiler : NULL;
 }
 
 static bool compiler_init_with_args(struct compiler *c, int rf_logtype, bool with_stdlib, int argc, char **argv)
@@ -77,15 +154,13 @@ static bool compiler_init_with_args(struct compiler *c, int rf_logtype, bool wit
         return false;
     }
 
-    return compiler_pass_args(argc, argv);
+    return compiler_pass_args(c, argc, argv);
 }
 
 struct compiler *compiler_create_with_args(int rf_logtype, bool with_stdlib, int argc, char **argv)
 {
-    RF_ASSERT_OR_EXIT(!g_compiler_instance, 
-                      "compiler_create() was called a second time");
     struct compiler *ret = compiler_alloc();
-    if (!compiler_init_with_args(ret, rf_logtype, with_stdlib, argc, argv)) {
+    if (ret && !compiler_init_with_args(ret, rf_logtype, with_stdlib, argc, argv)) {
         free(ret);
         ret = NULL;
     }
@@ -94,7 +169,7 @@ struct compiler *compiler_create_with_args(int rf_logtype, bool with_stdlib, int
 
 struct compiler *compiler_instance_get()
 {
-    return g_compiler_instance;
+    return i_compiler_instance;
 }
 
 
@@ -102,6 +177,7 @@ struct front_ctx *compiler_new_front(struct compiler *c,
                                      const struct RFstring *input_name)
 {
     struct front_ctx *front;
+    compiler_bind(c);
     if (!(front = front_ctx_create(c->args, input_name))) {
         RF_ERROR("Failure at frontend context initialization");
         return NULL;
@@ -116,6 +192,7 @@ struct front_ctx *compiler_new_front_from_source(struct compiler *c,
                                                  const struct RFstring *source)
 {
     struct front_ctx *front;
+    compiler_bind(c);
     if (!(front = front_ctx_create_from_source(c->args, name, source))) {
         RF_ERROR("Failure at frontend context initialization");
         return NULL;
@@ -125,40 +202,109 @@ struct front_ctx *compiler_new_front_from_source(struct compiler *c,
     return front;
 }
 
-static void compiler_deinit(struct compiler *c)
+/**
+ * Free everything that was created for the program being compiled. If
+ * @a keep_stdlib is true and the stdlib was fully processed then its front
+ * and module are kept, as the first ones, for the next program.
+ */
+static void compiler_clear_program(struct compiler *c, bool keep_stdlib)
 {
     struct front_ctx *front;
     struct front_ctx *tmp;
     struct module **mod;
+    struct modules_arr kept;
+    struct front_ctx *kept_front = keep_stdlib && c->stdlib_ready ? c->stdlib_front : NULL;
     rf_ilist_for_each_safe(&c->front_ctxs, front, tmp, ln) {
-        front_ctx_destroy(front);
+        if (front != kept_front) {
+            front_ctx_destroy(front);
+        }
     }
-    
+    rf_ilist_head_init(&c->front_ctxs);
+
+    darray_init(kept);
     darray_foreach(mod, c->modules) {
-        module_destroy(*mod);
+        if (kept_front && (*mod)->front == kept_front) {
+            (*mod)->index = darray_size(kept);
+            darray_append(kept, *mod);
+        } else {
+            module_destroy(*mod);
+        }
     }
-    // free rir utilities created at rir_process for all rir modules
     darray_free(c->modules);
-    rir_utils_destroy();
+    c->modules = kept;
+    htable_clear(&c->modules_index);
+    htable_init(&c->modules_index, modules_index_rehash, c);
+    rf_ilist_head_init(&c->sorted_modules);
+    c->main_front = NULL;
+
+    if (kept_front) {
+        kept_front->retained = true;
+        rf_ilist_add(&c->front_ctxs, &kept_front->ln);
+    } else {
+        c->stdlib_front = NULL;
+        c->stdlib_ready = false;
+        if (c->stdlib_image) {
+            bllvm_stdlib_image_destroy(c->stdlib_image);
+            c->stdlib_image = NULL;
+        }
+    }
+}
 
+static void compiler_deinit(struct compiler *c)
+{
+    // another compiler of this thread may be in the middle of its work
+    struct compiler *previous = compiler_instance_get();
+    compiler_bind(c);
+    compiler_clear_program(c, false);
+    htable_clear(&c->modules_index);
+    rir_utils_destroy();
 
     serializer_destroy(c->serializer);
     compiler_args_destroy(c->args);
-    typecmp_ctx_deinit();
+    string_interner_deinit(&c->identifiers);
+    compiler_profile_deinit(&c->profile);
     rf_stringx_deinit(&c->err_buff);
-    rf_deinit();
+    compiler_runtime_release();
+    compiler_bind(previous != c ? previous : NULL);
+}
+
+/**
+ * Number of identifiers after which a kept stdlib is dropped by
+ * compiler_reset(). The kept stdlib refers to interned identifiers so the
+ * interner can only be emptied along with it.
+ */
+#define COMPILER_RESET_IDENTIFIERS_BOUND \
+    (STRING_INTERNER_MAX_CHUNKS * STRING_INTERNER_CHUNK_SIZE / 4)
+
+bool compiler_reset(struct compiler *c, bool keep_stdlib)
+{
+    compiler_bind(c);
+    if (string_interner_size(&c->identifiers) > COMPILER_RESET_IDENTIFIERS_BOUND) {
+        keep_stdlib = false;
+    }
+    compiler_clear_program(c, keep_stdlib);
+    // without a kept stdlib nothing refers to the identifiers anymore
+    if (!c->stdlib_front) {
+        string_interner_clear(&c->identifiers);
+        c->main_name_id = string_interner_add(&c->identifiers, &g_str_main);
+        if (c->main_name_id == STRING_INTERNER_INVALID_ID) {
+            return false;
+        }
+    }
+    compiler_profile_clear(&c->profile);
+    rf_stringx_deinit(&c->err_buff);
+    return rf_stringx_init_buff(&c->err_buff, 1024, "");
 }
 
 void compiler_destroy(struct compiler *c)
 {
     compiler_deinit(c);
     free(c);
-    g_compiler_instance = NULL;
 }
 
 bool compiler_set_main(struct front_ctx *front)
 {
-    struct compiler *c = g_compiler_instance;
+    struct compiler *c = compiler_instance_get();
     if (c->main_front) {
         // TODO: maybe change this? Not very elegant. Could somehow try to provide main's location
         // set the error location as the beginning of the file
@@ -179,18 +325,27 @@ bool compiler_set_main(struct front_ctx *front)
     return true;
 }
 
-bool compiler_pass_args(int argc, char **argv)
+bool compiler_pass_args(struct compiler *c, int argc, char **argv)
 {
-    struct compiler *c = g_compiler_instance;
+    compiler_bind(c);
     if (!compiler_args_parse(c->args, argc, argv)) {
         return false;
     }
+    c->profile.enabled = compiler_args_time_passes(c->args);
 
     // do not proceed any further if we got request for help
     if (compiler_args_help_is_requested(c->args)) {
         return true;
     }
 
+    // the stdlib image is built from the stdlib alone and the input files
+    // of a compiler server or its clients come with each request
+    if (compiler_args_emit_stdlib_image(c->args) ||
+        compiler_args_server(c->args) ||
+        compiler_args_connect(c->args)) {
+        return true;
+    }
+
     // add all input files as new fronts
     unsigned i;
     for (i = 0; i < compiler_args_get_input_num(c->args); ++i) {
@@ -201,34 +356,53 @@ bool compiler_pass_args(int argc, char **argv)
     return true;
 }
 
-struct module *compiler_module_get(const struct RFstring *name)
+static bool modules_index_cmp(const void *e, void *name_id)
+{
+    return ((const struct module*)e)->name_id == *(uint32_t*)name_id;
+}
+
+static struct module *compiler_modules_index_get(struct compiler *c, uint32_t name_id)
+{
+    return htable_get(&c->modules_index,
+                      string_interner_hash(&c->identifiers, name_id),
+                      modules_index_cmp,
+                      &name_id);
+}
+
+/**
+ * Index all modules by name. If many modules share a name only the first
+ * one is indexed.
+ */
+static bool compiler_modules_index_build(struct compiler *c)
 {
     struct module **mod;
-    struct compiler *c = g_compiler_instance;
+    htable_clear(&c->modules_index);
+    htable_init(&c->modules_index, modules_index_rehash, c);
     darray_foreach(mod, c->modules) {
-        if (rf_string_equal(module_name(*mod), name)) {
-            return *mod;
+        if (!compiler_modules_index_get(c, (*mod)->name_id) &&
+            !htable_add(&c->modules_index,
+                        string_interner_hash(&c->identifiers, (*mod)->name_id),
+                        *mod)) {
+            RF_ERRNOMEM();
+            return false;
         }
     }
-    return NULL;
+    return true;
 }
 
-static unsigned compiler_get_module_index(struct module *m)
+struct module *compiler_module_get(struct compiler *c, const struct RFstring *name)
 {
-    struct module **mod;
-    unsigned found_index = 0;
-    bool found = false;
-    darray_foreach(mod, compiler_instance_get()->modules) {
-        if (*mod == m) {
-            found = true;
-            break;
-        }
-        found_index ++;
+    uint32_t name_id = string_interner_get_id(&c->identifiers, name);
+    if (name_id == STRING_INTERNER_INVALID_ID) {
+        return NULL;
     }
-    RF_ASSERT(found, "A module must have been found at this point");
-    return found_index;
+    return compiler_modules_index_get(c, name_id);
 }
 
+struct string_interner *compiler_identifiers()
+{
+    return &i_compiler_instance->identifiers;
+}
 
 // Algorithm for topological sorting as seen here: https://en.wikipedia.org/wiki/Topological_sorting
 // One main difference is the direction of the edges. Each module has edges towards
@@ -241,7 +415,10 @@ enum mark_states {
     STATE_MARKED
 };
 
-static bool compiler_visit_unmarked_module(struct module *m, unsigned i, enum mark_states *marks)
+static bool compiler_visit_unmarked_module(struct compiler *c,
+                                           struct module *m,
+                                           unsigned i,
+                                           enum mark_states *marks)
 {
     if (marks[i] == STATE_MARKED) {
         return true;
@@ -263,44 +440,34 @@ static bool compiler_visit_unmarked_module(struct module *m, unsigned i, enum ma
     marks[i] = STATE_TEMP_MARK;
     struct module **dependency;
     darray_foreach(dependency, m->dependencies) {
-        // find index of dependency in marks
-        unsigned found_index = compiler_get_module_index(*dependency);
         // visit the module
-        if (!compiler_visit_unmarked_module(*dependency, found_index, marks)) {
+        if (!compiler_visit_unmarked_module(c, *dependency, (*dependency)->index, marks)) {
             return false;
         }
     }
     marks[i] = STATE_MARKED;
 
     // add module m to the end of the sorted list.
-    rf_ilist_add_tail(&compiler_instance_get()->sorted_modules, &m->ln);
+    rf_ilist_add_tail(&c->sorted_modules, &m->ln);
     return true;
 }
 
-static bool compiler_resolve_dependencies()
+static bool compiler_resolve_dependencies(struct compiler *c)
 {
-    struct compiler *c = g_compiler_instance;
     struct module **mod;
     rf_ilist_head_init(&c->sorted_modules);
-    // topologically sort the dependency DAG
-    unsigned int i;
+    // topologically sort the dependency DAG. Each visit marks every module
+    // reachable from it so a single pass over the modules is enough, for a
+    // total of O(modules + dependencies)
     enum mark_states *marks;
     RF_CALLOC(marks, darray_size(c->modules), sizeof(*marks), return false);
 
-    bool unmarked_found = true;
-    while (unmarked_found) {
-        i = 0;
-        unmarked_found = false;
-        darray_foreach(mod, c->modules) {
-            // if module is unmarked
-            if (marks[i] != STATE_MARKED) {
-                unmarked_found = true;
-                if (!compiler_visit_unmarked_module(*mod, i, marks)) {
-                    free(marks);
-                    return false;
-                }
-            }
-            i++;
+    darray_foreach(mod, c->modules) {
+        // if module is unmarked
+        if (marks[(*mod)->index] != STATE_MARKED &&
+            !compiler_visit_unmarked_module(c, *mod, (*mod)->index, marks)) {
+            free(marks);
+            return false;
         }
     }
 
@@ -308,86 +475,463 @@ static bool compiler_resolve_dependencies()
     return true;
 }
 
-bool compiler_preprocess_fronts()
+//! Work shared by the threads that parse the fronts in parallel
+struct compiler_parse_jobs {
+    struct compiler *compiler;
+    struct front_ctx **fronts;
+    //! Parsing result of each front
+    bool *results;
+    unsigned int fronts_num;
+    //! Index of the next front to be parsed
+    unsigned int next;
+    pthread_mutex_t lock;
+};
+
+static void compiler_parse_jobs_run(struct compiler_parse_jobs *jobs)
+{
+    unsigned int i;
+    while (true) {
+        pthread_mutex_lock(&jobs->lock);
+        i = jobs->next++;
+        pthread_mutex_unlock(&jobs->lock);
+        if (i >= jobs->fronts_num) {
+            return;
+        }
+        jobs->results[i] = front_ctx_parse(jobs->fronts[i]);
+    }
+}
+
+static void *compiler_parse_thread(void *arg)
+{
+    // the refu library's temporary string buffers are thread specific.
+    // If they can't be created leave the work to the other threads.
+    if (!rf_init_thread_specific()) {
+        return NULL;
+    }
+    compiler_bind(((struct compiler_parse_jobs*)arg)->compiler);
+    compiler_parse_jobs_run(arg);
+    rf_deinit_thread_specific();
+    return NULL;
+}
+
+static bool compiler_parse_fronts_parallel(struct compiler *c, unsigned int threads_num)
 {
-    struct compiler *c = g_compiler_instance;
+    struct compiler_parse_jobs jobs;
     struct front_ctx *front;
+    pthread_t *threads;
+    unsigned int threads_created = 0;
+    unsigned int i;
     bool ret = false;
-    // make sure all files are parsed
+
+    RF_STRUCT_ZERO(&jobs);
+    jobs.compiler = c;
+    rf_ilist_for_each(&c->front_ctxs, front, ln) {
+        if (!front->retained) {
+            ++jobs.fronts_num;
+        }
+    }
+    if (jobs.fronts_num == 0) {
+        return true;
+    }
+    if (jobs.fronts_num < threads_num) {
+        threads_num = jobs.fronts_num;
+    }
+    RF_MALLOC(jobs.fronts, sizeof(*jobs.fronts) * jobs.fronts_num, return false);
+    RF_CALLOC(jobs.results, jobs.fronts_num, sizeof(*jobs.results), goto free_fronts);
+    RF_MALLOC(threads, sizeof(*threads) * threads_num, goto free_results);
+    if (0 != pthread_mutex_init(&jobs.lock, NULL)) {
+        goto free_threads;
+    }
+    i = 0;
     rf_ilist_for_each(&c->front_ctxs, front, ln) {
-        if (!front_ctx_parse(front)) {
+        if (!front->retained) {
+            jobs.fronts[i++] = front;
+        }
+    }
+
+    // the calling thread is also one of the workers
+    for (i = 1; i < threads_num; ++i) {
+        if (0 == pthread_create(&threads[threads_created], NULL,
+                                compiler_parse_thread, &jobs)) {
+            ++threads_created;
+        }
+    }
+    compiler_parse_jobs_run(&jobs);
+    for (i = 0; i < threads_created; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // register modules in the order the fronts were added so that it does not
+    // depend on which thread finished first
+    for (i = 0; i < jobs.fronts_num; ++i) {
+        if (!jobs.results[i] || !front_ctx_register_modules(jobs.fronts[i])) {
+            goto destroy_lock;
+        }
+    }
+    ret = true;
+
+destroy_lock:
+    pthread_mutex_destroy(&jobs.lock);
+free_threads:
+    free(threads);
+free_results:
+    free(jobs.results);
+free_fronts:
+    free(jobs.fronts);
+    return ret;
+}
+
+static bool compiler_parse_fronts(struct compiler *c)
+{
+    struct front_ctx *front;
+    unsigned int jobs = compiler_args_jobs(c->args);
+    if (jobs > 1) {
+        return compiler_parse_fronts_parallel(c, jobs);
+    }
+
+    rf_ilist_for_each(&c->front_ctxs, front, ln) {
+        if (front->retained) {
+            continue;
+        }
+        if (!front_ctx_parse(front) || !front_ctx_register_modules(front)) {
             return false;
         }
     }
+    return true;
+}
+
+bool compiler_preprocess_fronts(struct compiler *c)
+{
+    compiler_bind(c);
+    // make sure all files are parsed
+    if (!compiler_parse_fronts(c)) {
+        return false;
+    }
+
+    // index the modules by name so that imports can be resolved in O(1)
+    if (!compiler_modules_index_build(c)) {
+        return false;
+    }
 
     // determine the dependencies of all the modules
-    struct rf_objset_string mod_names_set;
-    rf_objset_init(&mod_names_set, string);
     struct module **mod;
     darray_foreach(mod, c->modules) {
-        const struct RFstring *mname = module_name(*mod);
-        // First check if a module with same name is in the string set
-        if (rf_objset_get(&mod_names_set, string, mname)) {
+        // only the first module with a given name is indexed
+        if (compiler_modules_index_get(c, (*mod)->name_id) != *mod) {
             i_info_ctx_add_msg((*mod)->front->info,   
                                MESSAGE_SEMANTIC_ERROR,
                                ast_node_startmark((*mod)->node),
                                ast_node_endmark((*mod)->node),
                                "Module \""RF_STR_PF_FMT"\" already declared",
-                               RF_STR_PF_ARG(mname));
-            goto end_free_names;
+                               RF_STR_PF_ARG(module_name(*mod)));
+            return false;
+        }
+
+        // kept from a previous program, its dependencies are known
+        if ((*mod)->front->retained) {
+            continue;
         }
-        // add this module's name to the set
-        rf_objset_add(&mod_names_set, string, mname);
-        
+
         if (!module_determine_dependencies(*mod, c->use_stdlib)) {
             // syntactic errors should have been added inside the above function
-            goto end_free_names;
+            return false;
         }
     }
 
     // resolve dependencies and figure out analysis order
-    if (!compiler_resolve_dependencies()) {
+    if (!compiler_resolve_dependencies(c)) {
         // cyclic module dependency (error already reported in the function)
-        goto end_free_names;
+        return false;
+    }
+    return true;
+}
+
+//! An array of module indices
+struct module_indices {darray(unsigned int);};
+#define NO_MODULE_INDEX UINT_MAX
+
+/**
+ * Work shared by the threads that analyze the modules in parallel.
+ *
+ * Modules are indexed by their position in the compiler's modules array.
+ * A module becomes ready once all of its prerequisites are done. Its
+ * prerequisites are its dependencies and, in order to keep the messages of
+ * a front_ctx deterministic, the module of the same front that precedes it
+ * in the sorted modules list.
+ */
+struct compiler_analyze_jobs {
+    struct compiler *compiler;
+    struct module **modules;
+    unsigned int modules_num;
+    //! Number of unfinished prerequisites of each module
+    unsigned int *pending;
+    //! True for each module that failed or had a prerequisite fail
+    bool *failed;
+    //! The modules that have each module as a prerequisite
+    struct module_indices *dependents;
+    //! FIFO of ready modules. Each module goes through it at most once.
+    unsigned int *ready;
+    unsigned int ready_head;
+    unsigned int ready_tail;
+    unsigned int finished_num;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+// must be called with the jobs lock held
+static void compiler_analyze_jobs_complete(struct compiler_analyze_jobs *jobs,
+                                           unsigned int i)
+{
+    unsigned int *d;
+    ++jobs->finished_num;
+    darray_foreach(d, jobs->dependents[i]) {
+        if (jobs->failed[i]) {
+            jobs->failed[*d] = true;
+        }
+        if (--jobs->pending[*d] == 0) {
+            if (jobs->failed[*d]) {
+                // skipped, same as the serial analysis never reaching it
+                compiler_analyze_jobs_complete(jobs, *d);
+            } else {
+                jobs->ready[jobs->ready_tail++] = *d;
+            }
+        }
+    }
+}
+
+//! Analyze a module, unless it was already analyzed for a previous program
+static inline bool compiler_module_analyze(struct module *m)
+{
+    return m->front->retained || module_analyze(m);
+}
+
+static void compiler_analyze_jobs_run(struct compiler_analyze_jobs *jobs)
+{
+    unsigned int i;
+    bool ok;
+    pthread_mutex_lock(&jobs->lock);
+    while (true) {
+        while (jobs->ready_head == jobs->ready_tail &&
+               jobs->finished_num != jobs->modules_num) {
+            pthread_cond_wait(&jobs->cond, &jobs->lock);
+        }
+        if (jobs->ready_head == jobs->ready_tail) {
+            break;
+        }
+        i = jobs->ready[jobs->ready_head++];
+        pthread_mutex_unlock(&jobs->lock);
+
+        ok = compiler_module_analyze(jobs->modules[i]);
+
+        pthread_mutex_lock(&jobs->lock);
+        jobs->failed[i] = !ok;
+        compiler_analyze_jobs_complete(jobs, i);
+        pthread_cond_broadcast(&jobs->cond);
+    }
+    pthread_mutex_unlock(&jobs->lock);
+}
+
+static void *compiler_analyze_thread(void *arg)
+{
+    // the calling thread's thread specific data are initialized by
+    // compiler_init(). New threads need their own.
+    if (!rf_init_thread_specific()) {
+        return NULL;
+    }
+    if (typecmp_ctx_init()) {
+        compiler_bind(((struct compiler_analyze_jobs*)arg)->compiler);
+        compiler_analyze_jobs_run(arg);
+        typecmp_ctx_deinit();
+    }
+    rf_deinit_thread_specific();
+    return NULL;
+}
+
+static bool compiler_analyze_parallel(struct compiler *c, unsigned int threads_num)
+{
+    struct compiler_analyze_jobs jobs;
+    struct module *mod;
+    struct module **dep;
+    unsigned int *front_first;
+    unsigned int *front_last;
+    pthread_t *threads;
+    unsigned int threads_created = 0;
+    unsigned int i;
+    unsigned int prev;
+    bool ret = false;
+
+    RF_STRUCT_ZERO(&jobs);
+    jobs.compiler = c;
+    jobs.modules = c->modules.item;
+    jobs.modules_num = darray_size(c->modules);
+    if (jobs.modules_num == 0) {
+        return true;
+    }
+    if (jobs.modules_num < threads_num) {
+        threads_num = jobs.modules_num;
+    }
+    RF_CALLOC(jobs.pending, jobs.modules_num, sizeof(*jobs.pending), return false);
+    RF_CALLOC(jobs.failed, jobs.modules_num, sizeof(*jobs.failed), goto free_pending);
+    RF_CALLOC(jobs.dependents, jobs.modules_num, sizeof(*jobs.dependents), goto free_failed);
+    RF_MALLOC(jobs.ready, sizeof(*jobs.ready) * jobs.modules_num, goto free_dependents);
+    RF_MALLOC(front_first, sizeof(*front_first) * jobs.modules_num, goto free_dependents);
+    RF_MALLOC(front_last, sizeof(*front_last) * jobs.modules_num, goto free_front_first);
+    RF_MALLOC(threads, sizeof(*threads) * threads_num, goto free_front_indices);
+    if (0 != pthread_mutex_init(&jobs.lock, NULL)) {
+        goto free_threads;
+    }
+    if (0 != pthread_cond_init(&jobs.cond, NULL)) {
+        goto destroy_lock;
+    }
+
+    // modules of a front are created one after the other so they are
+    // contiguous in the modules array. Group them by their first index.
+    for (i = 0; i < jobs.modules_num; ++i) {
+        front_first[i] = (i != 0 && jobs.modules[i - 1]->front == jobs.modules[i]->front)
+            ? front_first[i - 1] : i;
+        front_last[i] = NO_MODULE_INDEX;
+    }
+    // build the prerequisites graph, visiting modules in sorted order
+    rf_ilist_for_each(&c->sorted_modules, mod, ln) {
+        i = mod->index;
+        darray_foreach(dep, mod->dependencies) {
+            darray_append(jobs.dependents[(*dep)->index], i);
+            ++jobs.pending[i];
+        }
+        prev = front_last[front_first[i]];
+        if (prev != NO_MODULE_INDEX) {
+            darray_append(jobs.dependents[prev], i);
+            ++jobs.pending[i];
+        }
+        front_last[front_first[i]] = i;
+    }
+    rf_ilist_for_each(&c->sorted_modules, mod, ln) {
+        if (jobs.pending[mod->index] == 0) {
+            jobs.ready[jobs.ready_tail++] = mod->index;
+        }
+    }
+
+    // the calling thread is also one of the workers
+    for (i = 1; i < threads_num; ++i) {
+        if (0 == pthread_create(&threads[threads_created], NULL,
+                                compiler_analyze_thread, &jobs)) {
+            ++threads_created;
+        }
+    }
+    compiler_analyze_jobs_run(&jobs);
+    for (i = 0; i < threads_created; ++i) {
+        pthread_join(threads[i], NULL);
     }
-    // success
+
     ret = true;
+    for (i = 0; i < jobs.modules_num; ++i) {
+        ret = ret && !jobs.failed[i];
+    }
 
-end_free_names:
-    rf_objset_clear(&mod_names_set);
+    pthread_cond_destroy(&jobs.cond);
+destroy_lock:
+    pthread_mutex_destroy(&jobs.lock);
+free_threads:
+    free(threads);
+free_front_indices:
+    free(front_last);
+free_front_first:
+    free(front_first);
+free_dependents:
+    for (i = 0; i < jobs.modules_num; ++i) {
+        darray_free(jobs.dependents[i]);
+    }
+    free(jobs.dependents);
+    free(jobs.ready);
+free_failed:
+    free(jobs.failed);
+free_pending:
+    free(jobs.pending);
     return ret;
 }
 
-bool compiler_analyze()
+bool compiler_analyze(struct compiler *c)
 {
-    struct compiler *c = g_compiler_instance;
+    compiler_bind(c);
+    unsigned int jobs = compiler_args_jobs(c->args);
+    if (jobs > 1) {
+        return compiler_analyze_parallel(c, jobs);
+    }
+
     // now analyze the modules in the topologically sorted order
     struct module *mod;
     rf_ilist_for_each(&c->sorted_modules, mod, ln) {
-        if (!module_analyze(mod)) {
+        if (!compiler_module_analyze(mod)) {
             return false;
         }
     }
     return true;
 }
 
-bool compiler_process()
+// Should be enclosed in RFS_PUSH() / RFS_POP()
+static const struct RFstring *compiler_ir_file_name(struct compiler *c)
+{
+    return RFS_NT_OR_DIE(
+        RF_STR_PF_FMT".ll",
+        RF_STR_PF_ARG(compiler_args_get_executable_name(c->args)));
+}
+
+bool compiler_process(struct compiler *c)
 {
-    struct compiler *c = g_compiler_instance;
+    compiler_bind(c);
     
-    // add the standard library to the front contexts
-    struct front_ctx *stdlib_front;
+    // add the standard library to the front contexts, unless it was kept
+    // from the previous program
     static const struct RFstring stdlib = RF_STRING_STATIC_INIT(RF_LANG_CORE_ROOT"/stdlib/io.rf");
-    if (!(stdlib_front = compiler_new_front(c, &stdlib))) {
+    if (!c->stdlib_front && !(c->stdlib_front = compiler_new_front(c, &stdlib))) {
         RF_ERROR("Failed to add standard library to the front_ctxs");
         return false;
     }
 
-    if (!compiler_preprocess_fronts()) {
+    // read the stdlib image once. It is used both for the cache keys and
+    // for code generation.
+    if (!c->stdlib_image &&
+        !compiler_args_print_rir(c->args) &&
+        !compiler_args_emit_stdlib_image(c->args)) {
+        c->stdlib_image = bllvm_stdlib_image_load(
+            c->stdlib_front,
+            compiler_args_stdlib_image(c->args)
+        );
+    }
+
+    // a program that is unchanged since it got cached only needs to be
+    // assembled and linked
+    compiler_cache_init(&c->cache, compiler_args_cache_dir(c->args));
+    if (compiler_cache_enabled(&c->cache) &&
+        !compiler_args_print_rir(c->args) &&
+        !compiler_args_emit_stdlib_image(c->args)) {
+        bool hit;
+        RFS_PUSH();
+        compiler_cache_set_stdlib_image(
+            &c->cache,
+            c->stdlib_image ? bllvm_stdlib_stamp(c->stdlib_front) : NULL
+        );
+        compiler_cache_set_key(&c->cache, &c->front_ctxs);
+        hit = compiler_cache_fetch(&c->cache, compiler_ir_file_name(c));
+        RFS_POP();
+        if (hit) {
+            return bllvm_compile_ir(c->args);
+        }
+    }
+
+    if (!compiler_preprocess_fronts(c)) {
         return false;
     }
+
+    // the modules' dependencies are now known so their keys can be computed
+    if (compiler_cache_enabled(&c->cache)) {
+        struct module *mod;
+        rf_ilist_for_each(&c->sorted_modules, mod, ln) {
+            compiler_cache_set_module_key(&c->cache, mod);
+        }
+    }
     
-    if (!compiler_analyze()) {
+    if (!compiler_analyze(c)) {
         return false;
     }
 
@@ -399,10 +943,19 @@ bool compiler_process()
 #endif
 
     // create the Refu Intermediate Format
+    struct compiler_profile_sample sample;
+    compiler_profile_begin(&c->profile, &sample);
     if (!compiler_create_rir(c)) {
         RF_ERROR("Failed to process the Refu IR");
         return false;
     }
+    compiler_profile_end(&c->profile, COMPILER_PHASE_CREATE_RIR, &sample);
+    // from now on the stdlib module is not modified and can be kept
+    c->stdlib_ready = true;
+
+    if (compiler_args_emit_stdlib_image(c->args)) {
+        return bllvm_emit_stdlib_image(compiler_module_get(c, &g_str_stdlib), c->args);
+    }
 
     if (compiler_args_print_rir(c->args)) {
         // print the RIR string representation and quit. Move somewhere else..?
@@ -414,14 +967,42 @@ bool compiler_process()
         return true;
     }
 
-    if (!bllvm_generate(&c->modules, c->args)) {
+    compiler_profile_begin(&c->profile, &sample);
+    if (!bllvm_generate_ir(&c->modules, c->args)) {
         RF_ERROR("Failed to create the LLVM IR from the Refu IR");
         return false;
     }
+    compiler_profile_end(&c->profile, COMPILER_PHASE_LLVM_IR, &sample);
+
+    if (compiler_cache_enabled(&c->cache)) {
+        RFS_PUSH();
+        // not fatal, the next compilation will just miss the cache
+        if (!compiler_cache_store(&c->cache, compiler_ir_file_name(c))) {
+            RF_ERROR("Failed to store the LLVM IR in the compilation cache");
+        }
+        RFS_POP();
+    }
+
+    if (!bllvm_compile_ir(c->args)) {
+        RF_ERROR("Failed to compile the LLVM IR into an executable");
+        return false;
+    }
 
     return true;
 }
 
+void compiler_print_reports(struct compiler *c)
+{
+    bool time_passes = compiler_args_time_passes(c->args);
+    bool mem_report = compiler_args_mem_report(c->args);
+    if (time_passes || mem_report) {
+        compiler_profile_report(time_passes ? &c->profile : NULL,
+                                mem_report ? &c->modules : NULL,
+                                compiler_args_report_json(c->args),
+                                stderr);
+    }
+}
+
 bool compiler_help_requested(struct compiler *c)
 {
     return compiler_args_check_and_display_help(c->args);
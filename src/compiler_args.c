@@ -26,10 +26,44 @@ static const char* version_message = ""
         (_ca)->output_ast,                      \
         (_ca)->output_name,                     \
         (_ca)->rir_print,                       \
+        (_ca)->mmap_input,                      \
+        (_ca)->parser_memo,                     \
+        (_ca)->jobs,                            \
+        (_ca)->cache_dir,                       \
+        (_ca)->emit_stdlib_image,               \
+        (_ca)->stdlib_image,                    \
+        (_ca)->server,                          \
+        (_ca)->connect,                         \
+        (_ca)->time_passes,                     \
+        (_ca)->mem_report,                      \
+        (_ca)->report_json,                     \
         (_ca)->positional_file,                 \
         (_ca)->end                              \
     }                                           \
 
+static void compiler_args_set_defaults(struct compiler_args *a)
+{
+    a->verbosity->ival[0] = VERBOSE_LEVEL_DEFAULT;
+    a->jobs->ival[0] = 1;
+}
+
+// free what was created from a previous parsing of the arguments
+static void compiler_args_clear_input(struct compiler_args *args)
+{
+    unsigned i;
+    if (args->output && args->output != &args->input_files[0]) {
+        rf_string_destroy(args->output);
+    }
+    if (args->input_files) {
+        for (i = 0; i < (unsigned)args->positional_file->count; ++i) {
+            rf_string_deinit(&args->input_files[i]);
+        }
+        free(args->input_files);
+    }
+    args->output = NULL;
+    args->input_files = NULL;
+}
+
 bool compiler_args_init(struct compiler_args *a)
 {
     RF_STRUCT_ZERO(a);
@@ -41,11 +75,21 @@ bool compiler_args_init(struct compiler_args *a)
     a->backend_debug = arg_litn(NULL, "backend-debug", 0, 1, "If given then some debug information about the backend code will be printed");
     a->output_name = arg_str0("o", "output", "name", "output file name. Defaults to input.exe if not given");
     a->rir_print = arg_lit0("r", "print-rir", "If given will output the intermediate representation in a file");
+    a->mmap_input = arg_lit0(NULL, "mmap-input", "If given then input files are memory mapped instead of read into a buffer");
+    a->parser_memo = arg_lit0(NULL, "parser-memo", "If given then the parser memoizes speculatively parsed productions so that it never parses them twice at the same position");
+    a->jobs = arg_int0("j", "jobs", "N", "Number of threads used to parse the input files and analyze the modules. Defaults to 1");
+    a->cache_dir = arg_str0(NULL, "cache-dir", "dir", "If given then compiled programs are cached in this directory and an unchanged program is not processed again");
+    a->emit_stdlib_image = arg_str0(NULL, "emit-stdlib-image", "file", "If given then no input is compiled. Instead the precompiled standard library image is written to the given file");
+    a->stdlib_image = arg_str0(NULL, "stdlib-image", "file", "The precompiled standard library image to use. Defaults to the image installed next to the standard library source");
+    a->server = arg_str0(NULL, "server", "socket", "If given then the compiler keeps running and serves compile requests sent to this unix socket with --connect");
+    a->connect = arg_str0(NULL, "connect", "socket", "If given then the compilation is performed by the compiler server listening on this unix socket");
+    a->time_passes = arg_lit0(NULL, "time-passes", "If given then the wall time, CPU time and heap growth of each compilation phase are printed to stderr");
+    a->mem_report = arg_lit0(NULL, "mem-report", "If given then the memory pools high-water marks of each module are printed to stderr");
+    a->report_json = arg_lit0(NULL, "report-json", "If given then the reports of --time-passes and --mem-report are printed as JSON");
     a->positional_file = arg_filen(NULL, NULL, "<file>", 0, 100, "input files");
     a->end = arg_end(20);
 
-    // set default values
-    a->verbosity->ival[0] = VERBOSE_LEVEL_DEFAULT;
+    compiler_args_set_defaults(a);
 
     rf_stringx_init_buff(&a->buff, 128, "");
 
@@ -66,14 +110,7 @@ struct compiler_args *compiler_args_create()
 
 void compiler_args_deinit(struct compiler_args *args)
 {
-    if (args->output != &args->input_files[0]) {
-        rf_string_destroy(args->output);
-    }
-    unsigned i;
-    for (i = 0; i < (unsigned)args->positional_file->count; ++i) {
-        rf_string_deinit(&args->input_files[i]);
-    }
-    free(args->input_files);
+    compiler_args_clear_input(args);
     rf_stringx_deinit(&args->buff);
     CREATE_LOCAL_ARGTABLE(args);
     arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
@@ -122,6 +159,7 @@ fail:
         rf_string_deinit(&args->input_files[i]);
     }
     free(args->input_files);
+    args->input_files = NULL;
     return false;
 }
 
@@ -130,11 +168,14 @@ bool compiler_args_parse(struct compiler_args *args, int argc, char** argv)
 {
     int nerrors;
     CREATE_LOCAL_ARGTABLE(args);
+    // the arguments may be parsed many times by a compiler server
+    compiler_args_clear_input(args);
+    compiler_args_set_defaults(args);
     nerrors = arg_parse(argc, argv, argtable);
 
     if (nerrors != 0) {
         arg_print_errors(stdout, args->end, "refu");
-        exit(1);
+        return false;
     }
 
     // handle input new
@@ -188,6 +229,63 @@ bool compiler_args_print_rir(const struct compiler_args *args)
     return args->rir_print->count > 0;
 }
 
+bool compiler_args_mmap_input(const struct compiler_args *args)
+{
+    return args->mmap_input->count > 0;
+}
+
+bool compiler_args_parser_memo(const struct compiler_args *args)
+{
+    return args->parser_memo->count > 0;
+}
+
+unsigned compiler_args_jobs(const struct compiler_args *args)
+{
+    return args->jobs->ival[0] > 1 ? (unsigned)args->jobs->ival[0] : 1;
+}
+
+const char *compiler_args_cache_dir(const struct compiler_args *args)
+{
+    return args->cache_dir->count > 0 ? args->cache_dir->sval[0] : NULL;
+}
+
+const char *compiler_args_emit_stdlib_image(const struct compiler_args *args)
+{
+    return args->emit_stdlib_image->count > 0 ? args->emit_stdlib_image->sval[0] : NULL;
+}
+
+const char *compiler_args_stdlib_image(const struct compiler_args *args)
+{
+    return args->stdlib_image->count > 0
+        ? args->stdlib_image->sval[0]
+        : RF_LANG_CORE_ROOT"/stdlib/io.bc";
+}
+
+const char *compiler_args_server(const struct compiler_args *args)
+{
+    return args->server->count > 0 ? args->server->sval[0] : NULL;
+}
+
+const char *compiler_args_connect(const struct compiler_args *args)
+{
+    return args->connect->count > 0 ? args->connect->sval[0] : NULL;
+}
+
+bool compiler_args_time_passes(const struct compiler_args *args)
+{
+    return args->time_passes->count > 0;
+}
+
+bool compiler_args_mem_report(const struct compiler_args *args)
+{
+    return args->mem_report->count > 0;
+}
+
+bool compiler_args_report_json(const struct compiler_args *args)
+{
+    return args->report_json->count > 0;
+}
+
 bool compiler_args_output_ast(struct compiler_args *args,
                               struct RFstring **name)
 {
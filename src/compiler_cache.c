@@ -0,0 +1,200 @@
+#include <compiler_cache.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <RFintrusive_list.h>
+#include <String/rf_str_core.h>
+#include <Utils/hash.h>
+#include <Utils/log.h>
+#include <Persistent/buffers.h>
+
+#include <front_ctx.h>
+#include <inpfile.h>
+#include <module.h>
+
+#include "build_id.h" /* include the generated build identity */
+
+static const struct RFstring s_build_id = RF_STRING_STATIC_INIT(RF_LANG_BUILD_ID);
+
+static void compiler_cache_key_init(const struct compiler_cache *cache,
+                                    uint32_t key[2])
+{
+    key[0] = cache->seed[0];
+    key[1] = cache->seed[1];
+}
+
+static void compiler_cache_key_add(uint32_t key[2], const struct RFstring *s)
+{
+    key[0] = rf_hash_str_stable(s, key[0]);
+    key[1] = rf_hash_str_stable(s, key[1]);
+}
+
+void compiler_cache_init(struct compiler_cache *cache, const char *dir)
+{
+    cache->dir = dir;
+    // a different compiler version may generate different code
+    cache->seed[0] = (RF_LANG_MAJOR_VERSION << 16) |
+        (RF_LANG_MINOR_VERSION << 8) |
+        RF_LANG_PATCH_VERSION;
+    // two independently seeded 32-bit hash chains make a 64-bit key
+    cache->seed[1] = ~cache->seed[0];
+    // and so may a different build of the same version
+    compiler_cache_key_add(cache->seed, &s_build_id);
+    cache->key[0] = 0;
+    cache->key[1] = 0;
+    cache->module_hits = 0;
+    if (dir && 0 != mkdir(dir, 0755) && errno != EEXIST) {
+        RF_ERROR("Could not create cache directory \"%s\". Caching is disabled.", dir);
+        cache->dir = NULL;
+    }
+}
+
+bool compiler_cache_enabled(const struct compiler_cache *cache)
+{
+    return cache->dir != NULL;
+}
+
+void compiler_cache_set_stdlib_image(struct compiler_cache *cache,
+                                     const struct RFstring *stamp)
+{
+    // the code generated for the stdlib and linked into every module comes
+    // from the image when there is one
+    if (stamp) {
+        compiler_cache_key_add(cache->seed, stamp);
+    }
+}
+
+static void compiler_cache_key_add_front(uint32_t key[2], struct front_ctx *front)
+{
+    struct RFstring contents;
+    RF_STRING_SHALLOW_INIT(&contents,
+                           inpfile_sp(front->file),
+                           inpstr_len_from_beg(&front->file->str));
+    compiler_cache_key_add(key, front_ctx_filename(front));
+    compiler_cache_key_add(key, &contents);
+}
+
+void compiler_cache_set_key(struct compiler_cache *cache,
+                            struct RFilist_head *fronts)
+{
+    struct front_ctx *front;
+    compiler_cache_key_init(cache, cache->key);
+    rf_ilist_for_each(fronts, front, ln) {
+        compiler_cache_key_add_front(cache->key, front);
+    }
+}
+
+void compiler_cache_set_module_key(const struct compiler_cache *cache,
+                                   struct module *m)
+{
+    struct module **dep;
+    compiler_cache_key_init(cache, m->cache_key);
+    compiler_cache_key_add(m->cache_key, module_name(m));
+    // the whole file containing the module is hashed. Coarser than the
+    // module's own source but never misses a change.
+    compiler_cache_key_add_front(m->cache_key, m->front);
+    // the code of a module depends on the declarations of its imports. Their
+    // interfaces can't be serialized so their whole keys are used instead.
+    RFS_PUSH();
+    darray_foreach(dep, m->dependencies) {
+        compiler_cache_key_add(m->cache_key, RFS_OR_DIE("%08"PRIx32"%08"PRIx32,
+                                                        (*dep)->cache_key[0],
+                                                        (*dep)->cache_key[1]));
+    }
+    RFS_POP();
+}
+
+const struct RFstring *compiler_cache_entry_name(const struct compiler_cache *cache)
+{
+    return RFS_NT_OR_DIE("%s/%08"PRIx32"%08"PRIx32".ll",
+                         cache->dir, cache->key[0], cache->key[1]);
+}
+
+const struct RFstring *compiler_cache_module_entry_name(const struct compiler_cache *cache,
+                                                        const struct module *m)
+{
+    return RFS_NT_OR_DIE("%s/%08"PRIx32"%08"PRIx32".bc",
+                         cache->dir, m->cache_key[0], m->cache_key[1]);
+}
+
+const struct RFstring *compiler_cache_tmp_name(const struct RFstring *entry)
+{
+    // unique among the threads of this process
+    static unsigned int counter = 0;
+    return RFS_NT_OR_DIE(RF_STR_PF_FMT".%ld.%u.tmp",
+                         RF_STR_PF_ARG(entry),
+                         (long)getpid(),
+                         __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED));
+}
+
+static bool compiler_cache_copy(const char *from, const char *to)
+{
+    char buff[4096];
+    size_t n;
+    bool ret = false;
+    FILE *in;
+    FILE *out;
+    if (!(in = fopen(from, "rb"))) {
+        return false;
+    }
+    if (!(out = fopen(to, "wb"))) {
+        goto close_in;
+    }
+    while ((n = fread(buff, 1, sizeof(buff), in)) > 0) {
+        if (fwrite(buff, 1, n, out) != n) {
+            goto close_out;
+        }
+    }
+    ret = !ferror(in);
+
+close_out:
+    if (0 != fclose(out)) {
+        ret = false;
+    }
+    if (!ret) {
+        remove(to);
+    }
+close_in:
+    fclose(in);
+    return ret;
+}
+
+bool compiler_cache_fetch(const struct compiler_cache *cache,
+                          const struct RFstring *ir_file)
+{
+    bool ret;
+    RFS_PUSH();
+    ret = compiler_cache_copy(
+        rf_string_data(compiler_cache_entry_name(cache)),
+        rf_string_data(RFS_NT_OR_DIE(RF_STR_PF_FMT, RF_STR_PF_ARG(ir_file)))
+    );
+    RFS_POP();
+    return ret;
+}
+
+bool compiler_cache_store(const struct compiler_cache *cache,
+                          const struct RFstring *ir_file)
+{
+    const struct RFstring *entry;
+    const struct RFstring *tmp;
+    bool ret = false;
+    RFS_PUSH();
+    entry = compiler_cache_entry_name(cache);
+    tmp = compiler_cache_tmp_name(entry);
+    // write the entry under a temporary name and then move it in place so
+    // that other compilations never see a partially written entry
+    if (compiler_cache_copy(
+            rf_string_data(RFS_NT_OR_DIE(RF_STR_PF_FMT, RF_STR_PF_ARG(ir_file))),
+            rf_string_data(tmp))) {
+        ret = 0 == rename(rf_string_data(tmp), rf_string_data(entry));
+        if (!ret) {
+            remove(rf_string_data(tmp));
+        }
+    }
+    RFS_POP();
+    return ret;
+}
@@ -0,0 +1,184 @@
+#include <compiler_profile.h>
+
+#include <inttypes.h>
+#include <malloc.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include <String/rf_str_core.h>
+
+#include <module.h>
+
+static const char *phase_names[] = {
+    [COMPILER_PHASE_LEXER_SCAN] = "lexer_scan",
+    [COMPILER_PHASE_PARSE] = "parser_process_file",
+    [COMPILER_PHASE_ANALYZER_FIRST_PASS] = "analyzer_first_pass",
+    [COMPILER_PHASE_ANALYZER_TYPECHECK] = "analyzer_typecheck",
+    [COMPILER_PHASE_ANALYZER_FINALIZE] = "analyzer_finalize",
+    [COMPILER_PHASE_CREATE_RIR] = "compiler_create_rir",
+    [COMPILER_PHASE_LLVM_IR] = "bllvm_generate_ir",
+    [COMPILER_PHASE_LLC] = "llc",
+    [COMPILER_PHASE_LINK] = "gcc",
+};
+
+bool compiler_profile_init(struct compiler_profile *p)
+{
+    p->enabled = false;
+    compiler_profile_clear(p);
+    return 0 == pthread_mutex_init(&p->lock, NULL);
+}
+
+void compiler_profile_clear(struct compiler_profile *p)
+{
+    memset(p->phases, 0, sizeof(p->phases));
+}
+
+void compiler_profile_deinit(struct compiler_profile *p)
+{
+    pthread_mutex_destroy(&p->lock);
+}
+
+static inline uint64_t timespec_ns(const struct timespec *t)
+{
+    return (uint64_t)t->tv_sec * 1000000000u + t->tv_nsec;
+}
+
+static inline uint64_t timeval_ns(const struct timeval *t)
+{
+    return (uint64_t)t->tv_sec * 1000000000u + (uint64_t)t->tv_usec * 1000u;
+}
+
+static int64_t heap_in_use()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    return (int64_t)(mi.uordblks + mi.hblkhd);
+#elif defined(__GLIBC__)
+    struct mallinfo mi = mallinfo();
+    return (int64_t)mi.uordblks + mi.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+void compiler_profile_take_sample(struct compiler_profile_sample *s)
+{
+    struct timespec t;
+    struct rusage children;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    s->wall_ns = timespec_ns(&t);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    s->cpu_ns = timespec_ns(&t);
+    // llc and gcc run as child processes of the compiler
+    if (0 == getrusage(RUSAGE_CHILDREN, &children)) {
+        s->cpu_ns += timeval_ns(&children.ru_utime) + timeval_ns(&children.ru_stime);
+    }
+    s->heap_bytes = heap_in_use();
+}
+
+void compiler_profile_add(struct compiler_profile *p,
+                          enum compiler_phase phase,
+                          const struct compiler_profile_sample *begin)
+{
+    struct compiler_profile_sample end;
+    struct compiler_phase_stats *stats = &p->phases[phase];
+    compiler_profile_take_sample(&end);
+    pthread_mutex_lock(&p->lock);
+    stats->wall_ns += end.wall_ns - begin->wall_ns;
+    stats->cpu_ns += end.cpu_ns - begin->cpu_ns;
+    stats->heap_bytes += end.heap_bytes - begin->heap_bytes;
+    ++stats->runs;
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void compiler_profile_report_text(const struct compiler_profile *p,
+                                         const struct modules_arr *modules,
+                                         FILE *f)
+{
+    unsigned int i;
+    struct module **mod;
+    if (p) {
+        fprintf(f, "%-22s %6s %12s %12s %14s\n",
+                "phase", "runs", "wall (ms)", "cpu (ms)", "heap (bytes)");
+        for (i = 0; i < COMPILER_PHASES_NUM; ++i) {
+            fprintf(f, "%-22s %6u %12.3f %12.3f %14" PRId64 "\n",
+                    phase_names[i],
+                    p->phases[i].runs,
+                    p->phases[i].wall_ns / 1e6,
+                    p->phases[i].cpu_ns / 1e6,
+                    p->phases[i].heap_bytes);
+        }
+    }
+    if (modules) {
+        fprintf(f, "%-22s %24s %14s\n",
+                "module", "symbol records (peak)", "types (peak)");
+        darray_foreach(mod, *modules) {
+            fprintf(f, "%-22.*s %24u %14u\n",
+                    (int)rf_string_length_bytes(module_name(*mod)),
+                    rf_string_data(module_name(*mod)),
+                    (*mod)->symbol_records_usage.peak,
+                    (*mod)->types_usage.peak);
+        }
+    }
+}
+
+static void compiler_profile_report_json(const struct compiler_profile *p,
+                                         const struct modules_arr *modules,
+                                         FILE *f)
+{
+    unsigned int i;
+    struct module **mod;
+    bool first = true;
+    fprintf(f, "{");
+    if (p) {
+        fprintf(f, "\"phases\": [");
+        for (i = 0; i < COMPILER_PHASES_NUM; ++i) {
+            fprintf(f,
+                    "%s{\"name\": \"%s\", \"runs\": %u, \"wall_ns\": %" PRIu64
+                    ", \"cpu_ns\": %" PRIu64 ", \"heap_bytes\": %" PRId64 "}",
+                    i == 0 ? "" : ", ",
+                    phase_names[i],
+                    p->phases[i].runs,
+                    p->phases[i].wall_ns,
+                    p->phases[i].cpu_ns,
+                    p->phases[i].heap_bytes);
+        }
+        fprintf(f, "]");
+    }
+    if (modules) {
+        fprintf(f, "%s\"modules\": [", p ? ", " : "");
+        darray_foreach(mod, *modules) {
+            fprintf(f,
+                    "%s{\"name\": \""RF_STR_PF_FMT"\", "
+                    "\"symbol_table_records_peak\": %u, \"types_peak\": %u}",
+                    first ? "" : ", ",
+                    RF_STR_PF_ARG(module_name(*mod)),
+                    (*mod)->symbol_records_usage.peak,
+                    (*mod)->types_usage.peak);
+            first = false;
+        }
+        fprintf(f, "]");
+    }
+    fprintf(f, "}\n");
+}
+
+void compiler_profile_report(const struct compiler_profile *p,
+                             const struct modules_arr *modules,
+                             bool json,
+                             FILE *f)
+{
+    if (json) {
+        compiler_profile_report_json(p, modules, f);
+    } else {
+        compiler_profile_report_text(p, modules, f);
+    }
+}
+
+i_INLINE_INS void compiler_profile_begin(const struct compiler_profile *p,
+                                         struct compiler_profile_sample *s);
+i_INLINE_INS void compiler_profile_end(struct compiler_profile *p,
+                                       enum compiler_phase phase,
+                                       const struct compiler_profile_sample *begin);
+i_INLINE_INS void pool_usage_alloc(struct pool_usage *u);
+i_INLINE_INS void pool_usage_free(struct pool_usage *u);
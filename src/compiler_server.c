@@ -0,0 +1,320 @@
+#include <compiler_server.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <String/rf_str_core.h>
+#include <String/rf_str_corex.h>
+#include <Utils/log.h>
+#include <Utils/memory.h>
+
+#include <compiler.h>
+
+#define SERVER_BACKLOG 16
+#define SERVER_READ_CHUNK 4096
+//! Upper limit of the arguments of a single request
+#define SERVER_MAX_ARGS 256
+
+#ifndef MSG_NOSIGNAL
+// compiler_server_run() ignores SIGPIPE where the flag does not exist
+#define MSG_NOSIGNAL 0
+#endif
+
+static bool server_address_init(struct sockaddr_un *addr, const char *socket_path)
+{
+    if (strlen(socket_path) >= sizeof(addr->sun_path)) {
+        RF_ERROR("Compiler server socket path \"%s\" is too long", socket_path);
+        return false;
+    }
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, socket_path);
+    return true;
+}
+
+/**
+ * Remove the socket a killed server left behind at @a socket_path
+ *
+ * @return               true if there is nothing at the path anymore. false
+ *                       if the path is not a socket or a live server is
+ *                       listening to it.
+ */
+static bool server_remove_stale_socket(const struct sockaddr_un *addr,
+                                       const char *socket_path)
+{
+    struct stat st;
+    int probe;
+    int rc;
+    if (0 != lstat(socket_path, &st)) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        RF_ERROR("Could not stat \"%s\": %s", socket_path, strerror(errno));
+        return false;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        RF_ERROR("\"%s\" already exists and is not a socket", socket_path);
+        return false;
+    }
+    // only a socket that refuses connections is stale
+    if ((probe = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        RF_ERROR("Could not create a socket: %s", strerror(errno));
+        return false;
+    }
+    rc = connect(probe, (const struct sockaddr*)addr, sizeof(*addr));
+    if (rc != 0 && errno == ECONNREFUSED) {
+        close(probe);
+        if (0 != unlink(socket_path)) {
+            RF_ERROR("Could not remove the stale socket \"%s\": %s",
+                     socket_path, strerror(errno));
+            return false;
+        }
+        return true;
+    }
+    if (rc == 0) {
+        RF_ERROR("A compiler server is already listening to \"%s\"", socket_path);
+    } else {
+        RF_ERROR("Could not check the socket \"%s\": %s", socket_path, strerror(errno));
+    }
+    close(probe);
+    return false;
+}
+
+static bool server_write_all(int fd, const char *data, size_t size)
+{
+    ssize_t n;
+    while (size > 0) {
+        // a peer that went away should be a failed write, not a SIGPIPE
+        n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+//! Reply to a request that failed before reaching the compiler
+static bool server_reply_failure(int fd, const char *msg)
+{
+    return server_write_all(fd, "1", 1) && server_write_all(fd, msg, strlen(msg));
+}
+
+/**
+ * Read from @a fd until the other side shuts down its writing
+ *
+ * @param size[out]      The number of bytes read
+ * @return               The bytes read, to be freed by the caller, or NULL
+ *                       in failure
+ */
+static char *server_read_all(int fd, size_t *size)
+{
+    char *buff;
+    char *tmp;
+    size_t capacity = SERVER_READ_CHUNK;
+    ssize_t n;
+    *size = 0;
+    RF_MALLOC(buff, capacity, return NULL);
+    while (true) {
+        if (*size == capacity) {
+            capacity *= 2;
+            tmp = realloc(buff, capacity);
+            if (!tmp) {
+                RF_ERRNOMEM();
+                free(buff);
+                return NULL;
+            }
+            buff = tmp;
+        }
+        n = read(fd, buff + *size, capacity - *size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(buff);
+            return NULL;
+        }
+        if (n == 0) {
+            return buff;
+        }
+        *size += n;
+    }
+}
+
+static bool server_compile(struct compiler *c, char *request, size_t size, int fd)
+{
+    char *argv[SERVER_MAX_ARGS];
+    int argc = 1;
+    char *p = request;
+    char *end = request + size;
+    const char *cwd;
+    struct RFstringx *errors;
+    bool ok;
+
+    // the request should be a sequence of '\0' terminated strings
+    if (size == 0 || request[size - 1] != '\0') {
+        return server_reply_failure(fd, "Malformed compile request\n");
+    }
+    cwd = p;
+    p += strlen(p) + 1;
+    argv[0] = "refu";
+    while (p < end && argc < SERVER_MAX_ARGS) {
+        argv[argc++] = p;
+        p += strlen(p) + 1;
+    }
+    if (p < end) {
+        return server_reply_failure(fd, "Too many arguments\n");
+    }
+
+    // input files are relative to the client's working directory
+    if (0 != chdir(cwd)) {
+        return server_reply_failure(fd, "Could not enter the client's working directory\n");
+    }
+
+    // keep the stdlib module from the previous request
+    if (!compiler_reset(c, true)) {
+        return server_reply_failure(fd, "Could not reset the compiler\n");
+    }
+    ok = compiler_pass_args(c, argc, argv) && compiler_process(c);
+    if (!server_write_all(fd, ok ? "0" : "1", 1)) {
+        return false;
+    }
+    if (!ok && (errors = compiler_get_errors(c))) {
+        return server_write_all(fd,
+                                rf_string_data(RF_STRX2STR(errors)),
+                                rf_string_length_bytes(RF_STRX2STR(errors)));
+    }
+    return true;
+}
+
+bool compiler_server_run(struct compiler *c, const char *socket_path)
+{
+    struct sockaddr_un addr;
+    int sock;
+    int fd;
+    char *request;
+    size_t size;
+
+    if (!server_address_init(&addr, socket_path)) {
+        return false;
+    }
+    // a client that disconnects before its reply, for example on Ctrl-C,
+    // must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+    if ((sock = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        RF_ERROR("Could not create the compiler server socket: %s", strerror(errno));
+        return false;
+    }
+    // a server that was killed leaves its socket behind
+    if (!server_remove_stale_socket(&addr, socket_path)) {
+        close(sock);
+        return false;
+    }
+    if (0 != bind(sock, (struct sockaddr*)&addr, sizeof(addr)) ||
+        0 != listen(sock, SERVER_BACKLOG)) {
+        RF_ERROR("Could not listen to \"%s\": %s", socket_path, strerror(errno));
+        close(sock);
+        return false;
+    }
+
+    while (true) {
+        if ((fd = accept(sock, NULL, NULL)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            RF_ERROR("Compiler server failed to accept a request: %s", strerror(errno));
+            break;
+        }
+        if ((request = server_read_all(fd, &size))) {
+            if (!server_compile(c, request, size, fd)) {
+                RF_ERROR("Compiler server failed to reply to a request");
+            }
+            free(request);
+        }
+        close(fd);
+    }
+
+    close(sock);
+    unlink(socket_path);
+    return false;
+}
+
+static bool client_is_connect_arg(const char *arg)
+{
+    return strncmp(arg, "--connect", 9) == 0 && (arg[9] == '\0' || arg[9] == '=');
+}
+
+int compiler_server_request(const char *socket_path, int argc, char **argv)
+{
+    struct sockaddr_un addr;
+    char cwd[PATH_MAX];
+    char buff[SERVER_READ_CHUNK];
+    ssize_t n;
+    int sock;
+    int i;
+    int rc = 1;
+    bool status_read = false;
+
+    if (!server_address_init(&addr, socket_path)) {
+        return 1;
+    }
+    if (!getcwd(cwd, sizeof(cwd))) {
+        RF_ERROR("Could not get the current working directory");
+        return 1;
+    }
+    if ((sock = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+        0 != connect(sock, (struct sockaddr*)&addr, sizeof(addr))) {
+        printf("Could not connect to the compiler server at \"%s\": %s\n",
+               socket_path, strerror(errno));
+        if (sock >= 0) {
+            close(sock);
+        }
+        return 1;
+    }
+
+    if (!server_write_all(sock, cwd, strlen(cwd) + 1)) {
+        goto end;
+    }
+    for (i = 1; i < argc; ++i) {
+        if (client_is_connect_arg(argv[i])) {
+            // the socket may also be given as the next argument
+            if (argv[i][9] == '\0') {
+                ++i;
+            }
+            continue;
+        }
+        if (!server_write_all(sock, argv[i], strlen(argv[i]) + 1)) {
+            goto end;
+        }
+    }
+    shutdown(sock, SHUT_WR);
+
+    // the first byte of the reply is the result and the rest are messages
+    while ((n = read(sock, buff, sizeof(buff))) > 0) {
+        if (!status_read) {
+            rc = buff[0] == '0' ? 0 : 1;
+            status_read = true;
+            fwrite(buff + 1, 1, n - 1, stdout);
+        } else {
+            fwrite(buff, 1, n, stdout);
+        }
+    }
+    if (!status_read) {
+        printf("The compiler server at \"%s\" did not reply\n", socket_path);
+    }
+
+end:
+    close(sock);
+    return rc;
+}
@@ -1,8 +1,10 @@
 #include <front_ctx.h>
 
 #include <module.h>
+#include <compiler.h>
 #include <compiler_args.h>
 #include <info/info.h>
+#include <ast/ast.h>
 #include <lexer/lexer.h>
 #include <parser/parser.h>
 #include <analyzer/analyzer.h>
@@ -14,9 +16,13 @@ static bool front_ctx_init(struct front_ctx *ctx,
                            const struct RFstring *file_contents)
 {
     RF_STRUCT_ZERO(ctx);
-    ctx->file = file_contents
-        ? inpfile_create_from_string(input_file_name, file_contents)
-        : inpfile_create(input_file_name);
+    if (file_contents) {
+        ctx->file = inpfile_create_from_string(input_file_name, file_contents);
+    } else if (compiler_args_mmap_input(args)) {
+        ctx->file = inpfile_create_mapped(input_file_name);
+    } else {
+        ctx->file = inpfile_create(input_file_name);
+    }
     if (!ctx->file) {
         goto err;
     }
@@ -26,7 +32,7 @@ static bool front_ctx_init(struct front_ctx *ctx,
         goto free_file;
     }
 
-    ctx->lexer = lexer_create(ctx->file, ctx->info);
+    ctx->lexer = lexer_create(ctx->file, ctx->info, compiler_identifiers());
     if (!ctx->lexer) {
         goto free_info;
     }
@@ -37,6 +43,8 @@ static bool front_ctx_init(struct front_ctx *ctx,
     }
 
     ctx->is_main = false;
+    ctx->parser_memo = args && compiler_args_parser_memo(args);
+    arena_init(&ctx->ast_arena, ARENA_DEFAULT_CHUNK_SIZE);
 
     return true;
 
@@ -84,6 +92,8 @@ void front_ctx_deinit(struct front_ctx *ctx)
     lexer_destroy(ctx->lexer);
     parser_destroy(ctx->parser);
     info_ctx_destroy(ctx->info);
+    // only after all nodes have been destroyed can the arena go away
+    arena_deinit(&ctx->ast_arena);
 }
 
 void front_ctx_destroy(struct front_ctx *ctx)
@@ -99,11 +109,29 @@ struct RFstring *front_ctx_filename(const struct front_ctx *f)
 
 bool front_ctx_parse(struct front_ctx *ctx)
 {
+    struct arena *prev_arena;
+    struct compiler_profile *profile = &compiler_instance_get()->profile;
+    struct compiler_profile_sample sample;
+    bool ret;
+    compiler_profile_begin(profile, &sample);
     if (!lexer_scan(ctx->lexer)) {
         return false;
     }
+    compiler_profile_end(profile, COMPILER_PHASE_LEXER_SCAN, &sample);
 
-    if (!parser_process_file(ctx->parser)) {
+    // memoized subtrees may outlive a failed alternative, which is only
+    // safe since the nodes come from the arena
+    prev_arena = ast_arena_set(&ctx->ast_arena);
+    if (ctx->parser_memo && !parser_memo_enable(ctx->parser)) {
+        ast_arena_set(prev_arena);
+        return false;
+    }
+    compiler_profile_begin(profile, &sample);
+    ret = parser_process_file(ctx->parser);
+    compiler_profile_end(profile, COMPILER_PHASE_PARSE, &sample);
+    parser_memo_disable(ctx->parser);
+    ast_arena_set(prev_arena);
+    if (!ret) {
         return false;
     }
     // the root should no longer be owned by the parser at this point
@@ -112,5 +140,25 @@ bool front_ctx_parse(struct front_ctx *ctx)
     // root will never go into analyzer pass1 so set the state properly here
     ctx->root->state = AST_NODE_STATE_ANALYZER_PASS1;
     // finally make sure that the root's symbol table is initialized
-    return root_symbol_table_init(&ctx->root->root.st);
+    return ast_root_symbol_table_init(ctx->root);
+}
+
+bool front_ctx_register_modules(struct front_ctx *ctx)
+{
+    struct ast_node *child;
+    ast_node_foreach_child(ctx->root, child) {
+        if (child->type == AST_MODULE && !module_create(child, ctx)) {
+            return false;
+        }
+    }
+    // if this is the main module or something else set the front's main flag
+    if (ctx->main_found || ctx->is_main) {
+        if (!compiler_set_main(ctx)) {
+            return false;
+        }
+        if (!module_create(ctx->root, ctx)) {
+            return false;
+        }
+    }
+    return true;
 }
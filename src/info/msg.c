@@ -110,6 +110,8 @@ bool info_msg_get_formatted(struct info_msg *m, struct RFstringx *s,
                             struct inpfile *input_file)
 {
     struct RFstring line_str;
+    unsigned int start_line = 0;
+    unsigned int start_col;
     switch(m->type) {
     case MESSAGE_SEMANTIC_WARNING:
         rf_stringx_assignv(
@@ -140,9 +142,11 @@ bool info_msg_get_formatted(struct info_msg *m, struct RFstringx *s,
             INPLOCMARKS_FMT" "INFO_ERROR_STR": "RF_STR_PF_FMT"\n",
             INPLOCMARKS_ARG(input_file, &m->start_mark, &m->end_mark),
             RF_STR_PF_ARG(&m->s));
-        if (!inpfile_line(input_file, m->start_mark.line, &line_str)) {
+        if (!inplocation_mark_linecol(&m->start_mark, input_file,
+                                      &start_line, &start_col) ||
+            !inpfile_line(input_file, start_line, &line_str)) {
             ERROR("Could not locate line %u at file "RF_STR_PF_FMT,
-                  m->start_mark.line,
+                  start_line,
                   RF_STR_PF_ARG(inpfile_name(input_file)));
             return false;
         } else {
@@ -154,12 +158,13 @@ bool info_msg_get_formatted(struct info_msg *m, struct RFstringx *s,
             if (info_msg_has_end_mark(m)) {
                 rf_stringx_assignv(s,
                                    LOCMARK2_FMT,
-                                   LOCMARK2_ARG(m->start_mark.col,
-                                                m->end_mark.col));
+                                   LOCMARK2_ARG(start_col,
+                                                inplocation_mark_col(&m->end_mark,
+                                                                     input_file)));
             } else {
                 rf_stringx_assignv(s,
                                    LOCMARK_FMT,
-                                   LOCMARK_ARG(m->start_mark.col));
+                                   LOCMARK_ARG(start_col));
             }
         }
         break;
@@ -1,14 +1,62 @@
 #include <inpfile.h>
+#include <inpskip.h>
 
 #include <RFtextfile.h>
 
 #include <ast/ast.h>
 #include <inpstr.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Attempt to memory map the file with the given name directly into the
+ * input string of @c f. Returns false if the file can't be mapped, in which
+ * case the caller should fall back to reading it.
+ */
+static bool inpfile_map(struct inpfile *f, const struct RFstring *name)
+{
+    int fd;
+    struct stat st;
+    void *map;
+    bool ret = false;
+
+    RFS_PUSH();
+    fd = open(rf_string_cstr_from_buff_or_die(name), O_RDONLY);
+    RFS_POP();
+    if (fd == -1) {
+        return false;
+    }
+
+    // empty and non-regular files can't be mapped, and offsets are 32-bit
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) ||
+        st.st_size == 0 || (uint64_t)st.st_size > UINT32_MAX) {
+        goto end_close;
+    }
+
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        goto end_close;
+    }
+    // the lexer only ever moves forward through the input
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    if (!inpstr_init_mapped(&f->str, map, st.st_size)) {
+        munmap(map, st.st_size);
+        goto end_close;
+    }
+    ret = true;
+
+end_close:
+    close(fd);
+    return ret;
+}
 
 static bool inpfile_init(struct inpfile* f,
                          const struct RFstring *name,
-                         const struct RFstring *contents)
+                         const struct RFstring *contents,
+                         bool mapped)
 {
     struct RFtextfile file;
     struct RFstringx file_str;
@@ -16,13 +64,19 @@ static bool inpfile_init(struct inpfile* f,
     int lines;
     static const struct RFstring s_stdin = RF_STRING_STATIC_INIT("stdin");
     RF_STRUCT_ZERO(f);
-    RF_ARRAY_TEMP_INIT(&lines_arr, uint32_t, INPUT_STRING_STARTING_LINES);
 
     if (!rf_string_copy_in(&f->file_name, name)) {
         RF_ERRNOMEM();
         return false;
     }
 
+    if (!contents && mapped && !rf_string_equal(name, &s_stdin) &&
+        inpfile_map(f, name)) {
+        inpoffset_init(&f->offset);
+        return true;
+    }
+
+    RF_ARRAY_TEMP_INIT(&lines_arr, uint32_t, INPUT_STRING_STARTING_LINES);
     if (!contents) { // if we read from a file
         if (!rf_stringx_init_buff(&file_str, INPUT_FILE_BUFF_INITIAL_SIZE, "")) {
             RF_ERRNOMEM();
@@ -69,7 +123,18 @@ struct inpfile *inpfile_create(const struct RFstring *name)
 {
     struct inpfile *ret;
     RF_MALLOC(ret, sizeof(*ret), return NULL);
-    if (!inpfile_init(ret, name, NULL)) {
+    if (!inpfile_init(ret, name, NULL, false)) {
+        free(ret);
+        ret = NULL;
+    }
+    return ret;
+}
+
+struct inpfile *inpfile_create_mapped(const struct RFstring *name)
+{
+    struct inpfile *ret;
+    RF_MALLOC(ret, sizeof(*ret), return NULL);
+    if (!inpfile_init(ret, name, NULL, true)) {
         free(ret);
         ret = NULL;
     }
@@ -81,7 +146,7 @@ struct inpfile *inpfile_create_from_string(const struct RFstring *name,
 {
     struct inpfile *ret;
     RF_MALLOC(ret, sizeof(*ret), return NULL);
-    if (!inpfile_init(ret, name, contents)) {
+    if (!inpfile_init(ret, name, contents, false)) {
         free(ret);
         ret = NULL;
     }
@@ -103,17 +168,27 @@ void inpfile_destroy(struct inpfile *f)
     free(f);
 }
 
-void inpfile_acc_ws(struct inpfile *f)
+static void inpfile_skip(struct inpfile *f, bool comments)
 {
-    static const struct RFstring wsp = RF_STRING_STATIC_INIT(" \t\n\r");
     struct inpoffset mov = INPOFFSET_STATIC_INIT();
-    mov.chars_moved = rf_stringx_skip_chars(inpfile_str(f),
-                                            &wsp,
-                                            0,
-                                            &mov.bytes_moved,
-                                            &mov.lines_moved);
+    const char *sp = rf_string_data(inpfile_str(f));
+    const char *end = sp + rf_string_length_bytes(inpfile_str(f));
+    const char *p = inpskip_ws(sp, end, comments, &mov.lines_moved);
 
+    mov.bytes_moved = p - sp;
+    mov.chars_moved = mov.bytes_moved;
     inpoffset_add(&f->offset, &mov);
+    rf_stringx_move_bytes(inpfile_str(f), mov.bytes_moved);
+}
+
+void inpfile_acc_ws(struct inpfile *f)
+{
+    inpfile_skip(f, false);
+}
+
+void inpfile_acc_ws_comments(struct inpfile *f)
+{
+    inpfile_skip(f, true);
 }
 
 void inpfile_move(struct inpfile *f,
@@ -121,7 +196,7 @@ void inpfile_move(struct inpfile *f,
                   unsigned int chars)
 {
     struct inpoffset *off = &f->offset;
-    static const struct RFstring nl = RF_STRING_STATIC_INIT("\n");
+    const char *p = rf_string_data(inpfile_str(f));
     uint32_t lim = inpstr_len_from_beg(&f->str);
 
     RF_ASSERT_OR_EXIT(off->bytes_moved + bytes <= lim,
@@ -129,7 +204,7 @@ void inpfile_move(struct inpfile *f,
 
     off->bytes_moved += bytes;
     off->chars_moved += chars;
-    off->lines_moved += rf_string_count(RF_STRX2STR(inpfile_str(f)), &nl, bytes, 0, 0);
+    off->lines_moved += inpskip_count_newlines(p, p + bytes);
 
     rf_stringx_move_bytes(inpfile_str(f), bytes);
 }
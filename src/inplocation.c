@@ -1,5 +1,7 @@
 #include <inplocation.h>
 
+#include <stdio.h>
+
 #include <inpstr.h>
 #include <inpfile.h>
 
@@ -7,19 +9,19 @@ bool inplocation_init(struct inplocation *loc,
                       struct inpfile *f,
                       char *sp, char *ep)
 {
-    loc->start.p = sp;
-    loc->end.p = ep;
+    char *beg = inpfile_sp(f);
+    uint32_t len = inpstr_len_from_beg(&f->str);
 
-    if (!inpstr_ptr_to_linecol(&f->str, loc->start.p,
-                               &loc->start.line, &loc->start.col)) {
+    if (sp < beg || (uint32_t)(sp - beg) > len) {
         return false;
     }
+    loc->start.off = sp - beg;
 
     if (ep) {
-        if (!inpstr_ptr_to_linecol(&f->str, ep,
-                                   &loc->end.line, &loc->end.col)) {
+        if (ep < beg || (uint32_t)(ep - beg) > len) {
             return false;
         }
+        loc->end.off = ep - beg;
     }
     return true;
 }
@@ -42,21 +44,69 @@ bool inplocation_from_file(struct inplocation *loc,
 {
     struct inpstr *str = &f->str;
 
-    if (!inpstr_ptr_to_linecol(str, inpstr_data(str),
-                               &loc->start.line, &loc->start.col)) {
-        ERROR("Could not create a location from a file");
-        return false;
-    }
-    loc->end.line = loc->start.line;
-    loc->end.col = loc->start.col;
+    loc->start.off = inpstr_data(str) - inpstr_beg(str);
+    loc->end.off = loc->start.off;
 
     return true;
 }
 
+bool inplocation_mark_linecol(const struct inplocation_mark *m,
+                              struct inpfile *f,
+                              unsigned int *line,
+                              unsigned int *col)
+{
+    if (inplocation_mark_empty(m)) {
+        *line = 0;
+        *col = 0;
+        return true;
+    }
+    return inpstr_ptr_to_linecol(&f->str, inplocation_mark_p(m, f), line, col);
+}
+
+char *inplocation_mark_linecol_str(const struct inplocation_mark *m,
+                                   struct inpfile *f,
+                                   char *buff)
+{
+    unsigned int line;
+    unsigned int col;
+    if (!inplocation_mark_linecol(m, f, &line, &col)) {
+        ERROR("Could not resolve the line and column of a location mark");
+        line = 0;
+        col = 0;
+    }
+    snprintf(buff, INPLOCATION_MARK_LINECOL_STRLEN, "%u:%u", line, col);
+    return buff;
+}
+
+unsigned int inplocation_mark_line(const struct inplocation_mark *m,
+                                   struct inpfile *f)
+{
+    unsigned int line;
+    unsigned int col;
+    if (!inplocation_mark_linecol(m, f, &line, &col)) {
+        ERROR("Could not resolve the line of a location mark");
+        return 0;
+    }
+    return line;
+}
+
+unsigned int inplocation_mark_col(const struct inplocation_mark *m,
+                                  struct inpfile *f)
+{
+    unsigned int line;
+    unsigned int col;
+    if (!inplocation_mark_linecol(m, f, &line, &col)) {
+        ERROR("Could not resolve the column of a location mark");
+        return 0;
+    }
+    return col;
+}
 
 i_INLINE_INS bool inplocation_mark_equal(const struct inplocation_mark *m1,
                                          const struct inplocation_mark *m2);
 i_INLINE_INS bool inplocation_mark_empty(const struct inplocation_mark *m);
+i_INLINE_INS char *inplocation_mark_p(const struct inplocation_mark *m,
+                                      const struct inpfile *f);
 i_INLINE_INS void inplocation_copy(struct inplocation *l1,
                                    const struct inplocation *l2);
 i_INLINE_INS bool inplocation_equal(const struct inplocation *l1,
@@ -0,0 +1,188 @@
+#include <inpskip.h>
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    defined(__SSE2__) && defined(__GNUC__)
+#define INPSKIP_X86
+#include <immintrin.h>
+#endif
+
+#define COND_WS(c_)                                               \
+    ((c_) == ' ' || (c_) == '\t' || (c_) == '\n' || (c_) == '\r')
+
+typedef const char *(*ws_run_fn)(const char *p,
+                                 const char *end,
+                                 unsigned int *lines);
+typedef unsigned int (*count_newlines_fn)(const char *p, const char *end);
+
+static const char *inpskip_ws_run_scalar(const char *p,
+                                         const char *end,
+                                         unsigned int *lines)
+{
+    for (; p < end && COND_WS(*p); ++p) {
+        if (*p == '\n') {
+            ++*lines;
+        }
+    }
+    return p;
+}
+
+unsigned int inpskip_count_newlines_scalar(const char *p, const char *end)
+{
+    unsigned int count = 0;
+    const char *nl;
+    while (p < end && (nl = memchr(p, '\n', end - p))) {
+        ++count;
+        p = nl + 1;
+    }
+    return count;
+}
+
+#ifdef INPSKIP_X86
+static const char *inpskip_ws_run_sse2(const char *p,
+                                       const char *end,
+                                       unsigned int *lines)
+{
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i nl = _mm_cmpeq_epi8(v, lf);
+        __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(nl, _mm_cmpeq_epi8(v, cr))
+        );
+        unsigned int wsmask = (unsigned int)_mm_movemask_epi8(ws);
+        unsigned int nlmask = (unsigned int)_mm_movemask_epi8(nl);
+        if (wsmask != 0xFFFF) {
+            unsigned int n = __builtin_ctz(~wsmask);
+            *lines += __builtin_popcount(nlmask & ((1u << n) - 1));
+            return p + n;
+        }
+        *lines += __builtin_popcount(nlmask);
+        p += 16;
+    }
+    return inpskip_ws_run_scalar(p, end, lines);
+}
+
+static unsigned int inpskip_count_newlines_sse2(const char *p,
+                                                const char *end)
+{
+    const __m128i lf = _mm_set1_epi8('\n');
+    unsigned int count = 0;
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        count += __builtin_popcount(
+            (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v, lf))
+        );
+        p += 16;
+    }
+    return count + inpskip_count_newlines_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *inpskip_ws_run_avx2(const char *p,
+                                       const char *end,
+                                       unsigned int *lines)
+{
+    const __m256i sp = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        __m256i nl = _mm256_cmpeq_epi8(v, lf);
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, sp),
+                            _mm256_cmpeq_epi8(v, tab)),
+            _mm256_or_si256(nl, _mm256_cmpeq_epi8(v, cr))
+        );
+        unsigned int wsmask = (unsigned int)_mm256_movemask_epi8(ws);
+        unsigned int nlmask = (unsigned int)_mm256_movemask_epi8(nl);
+        if (wsmask != 0xFFFFFFFFu) {
+            unsigned int n = __builtin_ctz(~wsmask);
+            *lines += __builtin_popcount(nlmask & ((1u << n) - 1));
+            return p + n;
+        }
+        *lines += __builtin_popcount(nlmask);
+        p += 32;
+    }
+    return inpskip_ws_run_sse2(p, end, lines);
+}
+
+__attribute__((target("avx2")))
+static unsigned int inpskip_count_newlines_avx2(const char *p,
+                                                const char *end)
+{
+    const __m256i lf = _mm256_set1_epi8('\n');
+    unsigned int count = 0;
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        count += __builtin_popcount(
+            (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lf))
+        );
+        p += 32;
+    }
+    return count + inpskip_count_newlines_sse2(p, end);
+}
+
+static ws_run_fn i_ws_run = inpskip_ws_run_sse2;
+static count_newlines_fn i_count_newlines = inpskip_count_newlines_sse2;
+
+/* pick the widest implementation the CPU supports before main() runs */
+__attribute__((constructor))
+static void inpskip_select_impl(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        i_ws_run = inpskip_ws_run_avx2;
+        i_count_newlines = inpskip_count_newlines_avx2;
+    }
+}
+#else
+static ws_run_fn i_ws_run = inpskip_ws_run_scalar;
+static count_newlines_fn i_count_newlines = inpskip_count_newlines_scalar;
+#endif
+
+static const char *inpskip_ws_with(const char *p,
+                                   const char *end,
+                                   bool comments,
+                                   unsigned int *lines,
+                                   ws_run_fn ws_run)
+{
+    const char *nl;
+    while (true) {
+        p = ws_run(p, end, lines);
+        if (!comments || end - p < 2 || p[0] != '/' || p[1] != '/') {
+            return p;
+        }
+        nl = memchr(p + 2, '\n', end - p - 2);
+        if (!nl) {
+            // as the lexer always did, an unterminated comment leaves the
+            // input's last byte unskipped unless that is part of the `//`
+            return p + 2 < end ? end - 1 : end;
+        }
+        ++*lines;
+        p = nl + 1;
+    }
+}
+
+const char *inpskip_ws(const char *p, const char *end,
+                       bool comments, unsigned int *lines)
+{
+    return inpskip_ws_with(p, end, comments, lines, i_ws_run);
+}
+
+const char *inpskip_ws_scalar(const char *p, const char *end,
+                              bool comments, unsigned int *lines)
+{
+    return inpskip_ws_with(p, end, comments, lines, inpskip_ws_run_scalar);
+}
+
+unsigned int inpskip_count_newlines(const char *p, const char *end)
+{
+    return i_count_newlines(p, end);
+}
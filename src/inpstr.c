@@ -1,6 +1,7 @@
 #include <inpstr.h>
 
 #include <Utils/sanity.h>
+#include <sys/mman.h>
 
 bool inpstr_init(struct inpstr *s,
                  struct RFstringx *input_str,
@@ -11,6 +12,7 @@ bool inpstr_init(struct inpstr *s,
     s->lines_num = lines_num;
     RF_MALLOC(s->lines, sizeof(uint32_t) * lines_num, return false);
     memcpy(s->lines, arr->buff, sizeof(uint32_t) * lines_num);
+    s->mapped_size = 0;
 
     return true;
 }
@@ -25,6 +27,7 @@ bool inpstr_init_from_source(struct inpstr *s,
     if (!rf_stringx_from_string_in(&s->str, input_str)) {
         return false;
     }
+    s->mapped_size = 0;
 
     if ((lc = rf_string_count(input_str, &nl, 0, &arr, 0)) == -1) {
         return false;
@@ -46,9 +49,46 @@ bool inpstr_init_from_source(struct inpstr *s,
     return true;
 }
 
+bool inpstr_init_mapped(struct inpstr *s, char *map, uint32_t size)
+{
+    char *p = map;
+    char *end = map + size;
+    uint32_t *tmp;
+    uint32_t lines_alloc = INPUT_STRING_STARTING_LINES;
+    RF_ASSERT(size > 0, "Can't initialize an input string from an empty mapping");
+
+    RF_MALLOC(s->lines, sizeof(uint32_t) * lines_alloc, return false);
+    s->lines[0] = 0;
+    s->lines_num = 1;
+    while ((p = memchr(p, '\n', end - p))) {
+        ++p;
+        if (s->lines_num == lines_alloc) {
+            lines_alloc *= 2;
+            tmp = realloc(s->lines, sizeof(uint32_t) * lines_alloc);
+            if (!tmp) {
+                RF_ERRNOMEM();
+                free(s->lines);
+                return false;
+            }
+            s->lines = tmp;
+        }
+        s->lines[s->lines_num++] = p - map;
+    }
+
+    RF_STRING_SHALLOW_INIT(RF_STRX2STR(&s->str), map, size);
+    s->str.bIndex = 0;
+    s->str.bSize = size;
+    s->mapped_size = size;
+    return true;
+}
+
 void inpstr_deinit(struct inpstr *s)
 {
-    rf_stringx_deinit(&s->str);
+    if (s->mapped_size) {
+        munmap(inpstr_beg(s), s->mapped_size);
+    } else {
+        rf_stringx_deinit(&s->str);
+    }
     free(s->lines);
 }
 
@@ -56,33 +96,34 @@ bool inpstr_ptr_to_linecol(struct inpstr *s,
                            char *p, unsigned int *line,
                            unsigned int *col)
 {
-    uint32_t i;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
     struct RFstring tmp;
     char *sp;
-    bool found = false;
     char *sbeg = inpstr_beg(s);
     uint32_t off = p - sbeg;
 
     RF_ASSERT(s->lines_num > 0,
               "The input string line indexing should start from 1");
 
-    for (i = 0; i < s->lines_num - 1; i++) {
-        if (off >= s->lines[i] && off < s->lines[i + 1]) {
-            found = true;
-            break;
-        }
-    }
-    if (!found) {
-        if (off >= s->lines[s->lines_num - 1] &&
-            off <= inpstr_len_from_beg(s)) {
-            /* last line */
-            i = s->lines_num - 1;
+    // binary search for the last line starting at or before off
+    lo = 0;
+    hi = s->lines_num - 1;
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1) / 2;
+        if (s->lines[mid] <= off) {
+            lo = mid;
         } else {
-            return false;
+            hi = mid - 1;
         }
     }
+    if (lo == s->lines_num - 1 && off > inpstr_len_from_beg(s)) {
+        // past the end of the last line
+        return false;
+    }
 
-    *line = i;
+    *line = lo;
     sp = sbeg + s->lines[*line];
     RF_ASSERT(p - sp >= 0,
               "pointer difference should always be positive");
@@ -17,6 +17,7 @@
 #include <utils/common_strings.h>
 #include <analyzer/type_set.h>
 #include <module.h>
+#include <front_ctx.h>
 #include <compiler.h>
 
 static inline void rir_ctx_init(struct rir_ctx *ctx, struct rir *r, struct module *m)
@@ -84,6 +85,12 @@ struct rir_object *rir_ctx_st_getobj(struct rir_ctx *ctx, const struct RFstring
     return rec ? rec->rirobj : NULL;
 }
 
+struct rir_object *rir_ctx_st_getobj_id(struct rir_ctx *ctx, uint32_t id, uint32_t hash)
+{
+    struct symbol_table_record *rec = symbol_table_lookup_record_id(rir_ctx_curr_st(ctx), id, hash, NULL);
+    return rec ? rec->rirobj : NULL;
+}
+
 void rir_strec_create_allocas(struct symbol_table_record *rec,
                               struct rir_ctx *ctx)
 {
@@ -311,7 +318,7 @@ static bool rir_process_do(struct rir *r, struct module *m)
 
     // for each function of the module, create a rir equivalent
     struct rir_fndef *fndef;
-    rf_ilist_for_each(&m->node->children, child, lh) {
+    ast_node_foreach_child(m->node, child) {
         if (child->type == AST_FUNCTION_IMPLEMENTATION) {
             fndef = rir_fndef_create_from_ast(child, &ctx);
             if (!fndef) {
@@ -329,16 +336,15 @@ end:
     return ret;
 }
 
-bool compiler_create_rir()
+bool compiler_create_rir(struct compiler *c)
 {
-    struct compiler *c = compiler_instance_get();
-    // create some utilities needed by all the rir modules. Freed at compiler_deinit.
-    if (!rir_utils_create()) {
-        return false;
-    }
     // for each module of the compiler process the rir
     struct module *mod;
     rf_ilist_for_each(&c->sorted_modules, mod, ln) {
+        // a module kept from a previous program already has its RIR
+        if (mod->front->retained) {
+            continue;
+        }
         if (!rir_process_do(mod->rir, mod)) {
             RF_ERROR("Failed to create the RIR for module \""RF_STR_PF_FMT"\"",
                      module_name(mod));
@@ -173,9 +173,10 @@ static bool rir_process_memberaccess(const struct ast_binaryop *op,
     }
 
     // find the index of the right part of member access
-    const struct ast_node *ast_desc = symbol_table_lookup_node(
+    const struct ast_node *ast_desc = symbol_table_lookup_node_id(
         rir_ctx_curr_st(ctx),
-        ast_identifier_str(op->left),
+        ast_identifier_id(op->left),
+        ast_identifier_hash(op->left),
         NULL
     );
     if (!ast_desc) {
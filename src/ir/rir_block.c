@@ -220,7 +220,7 @@ static bool rir_block_init(struct rir_object *obj,
             // create allocas for block's symbols and populate the symbol table with rir objects
             rir_ctx_st_create_and_add_allocas(ctx);
             // for each expression of the block create a rir expression and add it to the block
-            rf_ilist_for_each(&n->children, child, lh) {
+            ast_node_foreach_child(n, child) {
                 if (!rir_process_ast_node(child, ctx)) {
                     return false;
                 }
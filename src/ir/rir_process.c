@@ -16,8 +16,9 @@ static bool rir_process_vardecl(const struct ast_node *n,
 {
     // Just return the value from the symbol table
     struct ast_node *left = ast_types_left(ast_vardecl_desc_get(n));
-    const struct RFstring *id = ast_identifier_str(left);
-    struct rir_object *varobj = rir_ctx_st_getobj(ctx, id);
+    struct rir_object *varobj = rir_ctx_st_getobj_id(ctx,
+                                                     ast_identifier_id(left),
+                                                     ast_identifier_hash(left));
     if (!varobj) {
         RF_ERROR("Could not find a vardecl's RIR object in the symbol table");
         RIRCTX_RETURN_EXPR(ctx, false, NULL);
@@ -61,7 +62,9 @@ static bool rir_process_constant(const struct ast_node *n,
 bool rir_process_identifier(const struct ast_node *n,
                             struct rir_ctx *ctx)
 {
-    struct rir_object *obj = rir_ctx_st_getobj(ctx, ast_identifier_str(n));
+    struct rir_object *obj = rir_ctx_st_getobj_id(ctx,
+                                                  ast_identifier_id(n),
+                                                  ast_identifier_hash(n));
     if (!obj) {
         RF_ERROR("An identifier was not found in the strmap during rir creation");
         RIRCTX_RETURN_EXPR(ctx, false, NULL);
@@ -7,29 +7,37 @@
 
 #include <Utils/log.h>
 
+#include <pthread.h>
+
 struct rir_value g_rir_const_1;
 struct rir_value g_rir_const_m1;
-static bool utils_created = false;
+//! The utils are shared by all compilers, created by the first one
+static unsigned int utils_users = 0;
+static pthread_mutex_t utils_lock = PTHREAD_MUTEX_INITIALIZER;
 
 bool rir_utils_create()
 {
-    if (!rir_constantval_init_fromint32(&g_rir_const_1, 1)) {
-        return false;
+    bool ret = true;
+    pthread_mutex_lock(&utils_lock);
+    if (utils_users == 0) {
+        ret = rir_constantval_init_fromint32(&g_rir_const_1, 1) &&
+            rir_constantval_init_fromint32(&g_rir_const_m1, -1);
     }
-    if (!rir_constantval_init_fromint32(&g_rir_const_m1, -1)) {
-        return false;
+    if (ret) {
+        ++utils_users;
     }
-    utils_created = true;
-    return true;
+    pthread_mutex_unlock(&utils_lock);
+    return ret;
 }
 
 void rir_utils_destroy()
 {
-    if (utils_created) {
+    pthread_mutex_lock(&utils_lock);
+    if (utils_users != 0 && --utils_users == 0) {
         rir_value_deinit(&g_rir_const_m1);
         rir_value_deinit(&g_rir_const_1);
     }
-    utils_created = false;
+    pthread_mutex_unlock(&utils_lock);
 }
 
 struct rir_value *rir_getread_val(struct rir_expression *e, struct rir_ctx *ctx)
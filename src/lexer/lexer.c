@@ -1,11 +1,15 @@
+#include <string.h>
+
 #include <lexer/lexer.h>
 #include <inpfile.h>
 
 #include <ast/constants.h>
 #include <ast/string_literal.h>
+#include <utils/string_interner.h>
 
 #include <lexer/tokens.h>
 #include "tokens_htable.h" /* include the gperf generated hash table */
+#include "tokens_dispatch.h" /* include the generated symbol dispatch table */
 #include "common.h"
 
 static struct inplocation_mark i_file_start_loc_ = LOCMARK_INIT_ZERO();
@@ -16,90 +20,36 @@ static inline bool token_init(struct token *t,
                               char *sp, char *ep)
 {
     t->type = type;
+    t->value_idx = 0;
     if (!inplocation_init(&t->location, f, sp, ep)) {
         return false;
     }
     return true;
 }
 
-static inline bool token_init_identifier(struct token *t,
-                                         struct inpfile *f,
-                                         char *sp, char *ep)
-{
-    if (!token_init(t, TOKEN_IDENTIFIER, f, sp, ep)) {
-        return false;
-    }
-    t->value.v = ast_identifier_create(&t->location);
-    t->value.owned_by_lexer = true;
-    if (!t->value.v) {
-        return false;
-    }
-    return true;
-}
-
-static inline bool token_init_constant_int(struct token *t,
-                                           struct inpfile *f,
-                                           char *sp, char *ep,
-                                           uint64_t value)
-{
-    if (!token_init(t, TOKEN_CONSTANT_INTEGER, f, sp, ep)) {
-        return false;
-    }
-    t->value.v = ast_constant_create_integer(&t->location, value);
-    t->value.owned_by_lexer = true;
-    if (!t->value.v) {
-        return false;
-    }
-    return true;
-}
-
-static inline bool token_init_constant_float(struct token *t,
-                                             struct inpfile *f,
-                                             char *sp, char *ep,
-                                             double value)
-{
-    if (!token_init(t, TOKEN_CONSTANT_FLOAT, f, sp, ep)) {
-        return false;
-    }
-    t->value.v = ast_constant_create_float(&t->location, value);
-    t->value.owned_by_lexer = true;
-    if (!t->value.v) {
-        return false;
-    }
-    return true;
-}
-
-static inline bool token_init_string_literal(struct token *t,
-                                             struct inpfile *f,
-                                             char *sp, char *ep)
-{
-    if (!token_init(t, TOKEN_STRING_LITERAL, f, sp, ep)) {
-        return false;
-    }
-    t->value.v = ast_string_literal_create(&t->location);
-    t->value.owned_by_lexer = true;
-    if (!t->value.v) {
-        return false;
-    }
-    return true;
-}
-
-bool lexer_init(struct lexer *l, struct inpfile *f, struct info_ctx *info)
+bool lexer_init(struct lexer *l,
+                struct inpfile *f,
+                struct info_ctx *info,
+                struct string_interner *identifiers)
 {
     darray_init(l->tokens);
+    darray_init(l->literals);
     darray_init(l->indices);
     l->tok_index = 0;
     l->file = f;
     l->info = info;
+    l->identifiers = identifiers;
     l->at_eof = false;
     return true;
 }
 
-struct lexer *lexer_create(struct inpfile *f, struct info_ctx *info)
+struct lexer *lexer_create(struct inpfile *f,
+                           struct info_ctx *info,
+                           struct string_interner *identifiers)
 {
     struct lexer *ret;
     RF_MALLOC(ret, sizeof(*ret), NULL);
-    if (!lexer_init(ret, f, info)) {
+    if (!lexer_init(ret, f, info, identifiers)) {
         free(ret);
         return NULL;
     }
@@ -108,15 +58,8 @@ struct lexer *lexer_create(struct inpfile *f, struct info_ctx *info)
 
 void lexer_deinit(struct lexer *l)
 {
-    struct token *tok;
-
-    darray_foreach(tok, l->tokens) {
-        if (token_has_value(tok) && tok->value.owned_by_lexer) {
-            ast_node_destroy_from_lexer(tok->value.v);
-        }
-    }
-
     darray_free(l->tokens);
+    darray_free(l->literals);
     darray_free(l->indices);
 }
 
@@ -148,11 +91,30 @@ static bool lexer_add_token(struct lexer *l, enum token_type type,
 static bool lexer_add_token_identifier(struct lexer *l,
                                        char *sp, char* ep)
 {
-    darray_resize(l->tokens, l->tokens.size + 1);
-    if (!token_init_identifier(&darray_top(l->tokens), l->file, sp, ep)) {
+    struct RFstring s;
+    uint32_t id;
+    RF_STRING_SHALLOW_INIT(&s, sp, ep - sp + 1);
+    id = string_interner_add(l->identifiers, &s);
+    if (id == STRING_INTERNER_INVALID_ID) {
+        return false;
+    }
+    if (!lexer_add_token(l, TOKEN_IDENTIFIER, sp, ep)) {
         return false;
     }
+    darray_top(l->tokens).value_idx = id;
+    return true;
+}
 
+static bool lexer_add_token_literal(struct lexer *l,
+                                    enum token_type type,
+                                    char *sp, char* ep,
+                                    union token_literal v)
+{
+    if (!lexer_add_token(l, type, sp, ep)) {
+        return false;
+    }
+    darray_top(l->tokens).value_idx = darray_size(l->literals);
+    darray_append(l->literals, v);
     return true;
 }
 
@@ -160,47 +122,24 @@ static bool lexer_add_token_constant_int(struct lexer *l,
                                          char *sp, char* ep,
                                          uint64_t v)
 {
-    darray_resize(l->tokens, l->tokens.size + 1);
-    if (!token_init_constant_int(&darray_top(l->tokens), l->file, sp, ep, v)) {
-        return false;
-    }
-
-    return true;
+    union token_literal lit;
+    lit.integer = v;
+    return lexer_add_token_literal(l, TOKEN_CONSTANT_INTEGER, sp, ep, lit);
 }
 
 static bool lexer_add_token_constant_float(struct lexer *l,
                                          char *sp, char* ep,
                                          double v)
 {
-    darray_resize(l->tokens, l->tokens.size + 1);
-    if (!token_init_constant_float(&darray_top(l->tokens), l->file, sp, ep, v)) {
-        return false;
-    }
-
-    return true;
+    union token_literal lit;
+    lit.floating = v;
+    return lexer_add_token_literal(l, TOKEN_CONSTANT_FLOAT, sp, ep, lit);
 }
 
 static bool lexer_add_token_string_literal(struct lexer *l,
                                            char *sp, char* ep)
 {
-    darray_resize(l->tokens, l->tokens.size + 1);
-    if (!token_init_string_literal(&darray_top(l->tokens), l->file, sp, ep)) {
-        return false;
-    }
-
-    return true;
-}
-
-static void lexer_get_dblslash_comment(struct lexer *l, char *p, char *lim, char **ret_p)
-{
-    // skip the first 2 '//'
-    p += 2;
-    // TODO: this assumes newline is always LF which depends on where we get our data from
-    // If we use RFTextFile that is always gonna be true. If other ways we have to add
-    // logic for different types of new line characters
-    while (p < lim && *(p++) != '\n') {
-    }
-    *ret_p = p;
+    return lexer_add_token(l, TOKEN_STRING_LITERAL, sp, ep);
 }
 
 #define COND_IDENTIFIER_BEGIN(p_)               \
@@ -409,10 +348,31 @@ static bool lexer_get_string_literal(struct lexer *l, char *p,
     return true;
 }
 
-#define COND_TOKEN_AMBIG1(p_)                     \
-    ((p_) == '+' || (p_) == '-' || (p_) == '>' || \
-     (p_) == '<' || (p_) == '|' || (p_) == '=' || \
-     (p_) == '&')
+/**
+ * Find the longest symbol token starting at @a p, in a single forward scan.
+ *
+ * The first byte selects the candidates from the generated dispatch table,
+ * which lists them longest first, so the first one that fits is the match.
+ *
+ * @param p         The position of the first byte of the token
+ * @param lim       The last valid byte of the input
+ * @return          The matched symbol or NULL if no token starts at @a p
+ */
+static inline const struct token_symbol *lexer_match_symbol(const char *p,
+                                                            const char *lim)
+{
+    unsigned char c = (unsigned char)*p;
+    const struct token_symbol *sym = &token_symbols[token_dispatch_start[c]];
+    const struct token_symbol *end = sym + token_dispatch_count[c];
+    for (; sym != end; ++sym) {
+        if (sym->len == 1 ||
+            (p + sym->len - 1 <= lim &&
+             memcmp(p + 1, sym->name + 1, sym->len - 1) == 0)) {
+            return sym;
+        }
+    }
+    return NULL;
+}
 
 bool lexer_scan(struct lexer *l)
 {
@@ -425,7 +385,7 @@ bool lexer_scan(struct lexer *l)
 
    /* TODO: combine inpfile_at_eof with lexer eof check */
     while (!l->at_eof && p <= lim) {
-        inpfile_acc_ws(l->file);
+        inpfile_acc_ws_comments(l->file);
         if (inpfile_at_eof(l->file)) {
             break;
         }
@@ -448,69 +408,42 @@ bool lexer_scan(struct lexer *l)
                     "Failed to scan numeric literal");
                 return false;
             }
-         // if it's the start of a comment
-        } else if (p + 1 <= lim && *p == '/' && *(p + 1) == '/') {
-            lexer_get_dblslash_comment(l, p, lim, &p);                        
         } else { // see if it's a token
-            unsigned int len = 1;
-            const struct internal_token *itoken;
-            const struct internal_token *itoken2;
-            bool got_token = false;
-            char *toksp = p;
-
-            while (len <= MAX_WORD_LENGTH) {
-                itoken = lexer_lexeme_is_token(p, len);
-                if (itoken) {                    
-                    if (itoken->type == TOKEN_SM_DBLQUOTE) {
-                        // if it's the start of a string literal
-                        if (!lexer_get_string_literal(l, p, lim, &p)) {
-                            lexer_synerr(
-                                l, lexer_get_last_token_loc_start(l),
-                                NULL,
-                                "Failed to scan string literal");
-                            return false;
-                        }
-                        got_token = true;
-                        break;
-                    } else if (itoken->type == TOKEN_OP_MINUS &&
-                               p + 1 <= lim &&
-                               COND_NUMERIC(*(p + 1))) {
-                        // if it's a negative numeric literal
-                        if (!lexer_get_numeric(l, p + 1, lim, true, &p)) {
-                            lexer_synerr(
-                                l, lexer_get_last_token_loc_start(l),
-                                NULL,
-                                "Failed to scan numeric literal");
-                            return false;
-                        }
-                        got_token = true;
-                        break;
-                    } else if (p + 1 <= lim && COND_TOKEN_AMBIG1(*toksp)) {
-                        // if more than 1 tokens may start with that character
-                        len = 2;
-                        itoken2 = lexer_lexeme_is_token(p, len);
-                        if (itoken2) {
-                            itoken = itoken2;
-                        } else {
-                            len = 1;
-                        }
-                    }
-                    if (!lexer_add_token(l, itoken->type, toksp, p + len - 1)) {
-                        RF_ERROR("Failed to add a new token");
-                        return false;
-                    }
-                    p += len;
-                    got_token=true;
-                    break;
-                }
-                len ++;
-            }
-            if (!got_token) {
+            const struct token_symbol *sym = lexer_match_symbol(p, lim);
+            if (!sym) {
                 // error unknown token
                 lexer_synerr(l, lexer_get_last_token_loc_start(l), NULL,
                              "Unknown token encountered");
                 return false;
             }
+
+            if (sym->type == TOKEN_SM_DBLQUOTE) {
+                // if it's the start of a string literal
+                if (!lexer_get_string_literal(l, p, lim, &p)) {
+                    lexer_synerr(
+                        l, lexer_get_last_token_loc_start(l),
+                        NULL,
+                        "Failed to scan string literal");
+                    return false;
+                }
+            } else if (sym->type == TOKEN_OP_MINUS &&
+                       p + 1 <= lim &&
+                       COND_NUMERIC(*(p + 1))) {
+                // if it's a negative numeric literal
+                if (!lexer_get_numeric(l, p + 1, lim, true, &p)) {
+                    lexer_synerr(
+                        l, lexer_get_last_token_loc_start(l),
+                        NULL,
+                        "Failed to scan numeric literal");
+                    return false;
+                }
+            } else {
+                if (!lexer_add_token(l, sym->type, p, p + sym->len - 1)) {
+                    RF_ERROR("Failed to add a new token");
+                    return false;
+                }
+                p += sym->len;
+            }
         }
         inpfile_move(l->file, p - sp, p - sp);
     }
@@ -556,6 +489,9 @@ i_INLINE_INS struct inplocation *lexer_last_token_location(struct lexer *l);
 i_INLINE_INS struct inplocation_mark *lexer_last_token_start(struct lexer *l);
 i_INLINE_INS struct inplocation_mark *lexer_last_token_end(struct lexer *l);
 i_INLINE_INS void lexer_inject_input_file(struct lexer *l, struct inpfile *f);
+i_INLINE_INS unsigned int lexer_curr_index(const struct lexer *l);
+i_INLINE_INS void lexer_set_index(struct lexer *l, unsigned int idx);
+i_INLINE_INS unsigned int lexer_tokens_num(const struct lexer *l);
 
 void lexer_push(struct lexer *l)
 {
@@ -571,21 +507,43 @@ void lexer_pop(struct lexer *l)
 void lexer_rollback(struct lexer *l)
 {
     unsigned int idx;
-    unsigned int i;
-    struct token *tok;
     RF_ASSERT(!darray_empty(l->indices),
               "lexer_rollback called with empty array");
     idx = darray_pop(l->indices);
     RF_ASSERT(l->tok_index >= idx, "asked to rollback to a token ahead of us?");
-    // make sure that all value tokens in between now and rollback belong to the lexer
-    i = darray_size(l->tokens) - 1;
-    darray_foreach_reverse(tok, l->tokens) {
-        if (i <= l->tok_index && i >= idx && token_has_value(tok)) {
-            tok->value.owned_by_lexer = true;
-            tok->value.v->state = AST_NODE_STATE_CREATED;
-        }
-        --i;
-    }
-    // set new token index
+    // tokens own no AST nodes, so rewinding is just resetting the index
     l->tok_index = idx;
 }
+
+struct ast_node *lexer_token_get_value(struct lexer *l, struct token *tok)
+{
+    struct ast_node *n = NULL;
+    RF_ASSERT(token_has_value(tok), "Requesting value of illegal token type");
+    switch (tok->type) {
+    case TOKEN_IDENTIFIER:
+        n = ast_identifier_create_interned(&tok->location, l->file,
+                                           tok->value_idx);
+        break;
+    case TOKEN_STRING_LITERAL:
+        n = ast_string_literal_create(&tok->location, l->file);
+        break;
+    case TOKEN_CONSTANT_INTEGER:
+        n = ast_constant_create_integer(
+            &tok->location,
+            darray_item(l->literals, tok->value_idx).integer
+        );
+        break;
+    case TOKEN_CONSTANT_FLOAT:
+        n = ast_constant_create_float(
+            &tok->location,
+            darray_item(l->literals, tok->value_idx).floating
+        );
+        break;
+    default:
+        break;
+    }
+    if (!n) {
+        RF_ERRNOMEM();
+    }
+    return n;
+}
@@ -1,6 +1,8 @@
 #include <stdio.h>
 
 #include <compiler.h>
+#include <compiler_args.h>
+#include <compiler_server.h>
 #include <refu.h>
 
 int main(int argc, char **argv)
@@ -20,11 +22,21 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    if (compiler_args_connect(compiler->args)) {
+        rc = compiler_server_request(compiler_args_connect(compiler->args), argc, argv);
+        goto end;
+    }
+
+    if (compiler_args_server(compiler->args)) {
+        rc = compiler_server_run(compiler, compiler_args_server(compiler->args)) ? 0 : 1;
+        goto end;
+    }
+
     if (!compiler_process(compiler)) {
         rc = 1;
         compiler_print_errors(compiler);
-        goto end;
     }
+    compiler_print_reports(compiler);
 
 end:
     compiler_destroy(compiler);
@@ -18,6 +18,16 @@
 #include <ir/rir.h>
 
 
+static size_t exports_rehash_fn(const void *e, void *user_arg)
+{
+    return ((const struct symbol_table_record*)e)->hash;
+}
+
+static bool exports_cmp_fn(const void *e, void *id)
+{
+    return ((const struct symbol_table_record*)e)->interned_id == *(uint32_t*)id;
+}
+
 static bool module_init(struct module *m, struct ast_node *n, struct front_ctx *front)
 {
     // initialize
@@ -26,8 +36,16 @@ static bool module_init(struct module *m, struct ast_node *n, struct front_ctx *
     m->front = front;
     darray_init(m->dependencies);
     darray_init(m->foreignfn_arr);
+    htable_init(&m->exports, exports_rehash_fn, NULL);
     // add to the compiler's modules
-    darray_append(compiler_instance_get()->modules, m);
+    struct compiler *c = compiler_instance_get();
+    m->index = darray_size(c->modules);
+    darray_append(c->modules, m);
+    m->name_id = string_interner_add(compiler_identifiers(), module_name(m));
+    if (m->name_id == STRING_INTERNER_INVALID_ID) {
+        RF_ERROR("Failed to intern a module's name");
+        return false;
+    }
 
     // initialize analysis related members
     m->symbol_table_records_pool = rf_fixed_memorypool_create(sizeof(struct symbol_table_record),
@@ -36,6 +54,12 @@ static bool module_init(struct module *m, struct ast_node *n, struct front_ctx *
         RF_ERROR("Failed to initialize a fixed memory pool for symbol records");
         return false;
     }
+    m->symbol_tables_pool = rf_fixed_memorypool_create(sizeof(struct symbol_table),
+                                                       SYMBOL_TABLES_POOL_CHUNK_SIZE);
+    if (!m->symbol_tables_pool) {
+        RF_ERROR("Failed to initialize a fixed memory pool for symbol tables");
+        return false;
+    }
     m->types_pool = rf_fixed_memorypool_create(sizeof(struct type),
                                                TYPES_POOL_CHUNK_SIZE);
     if (!m->types_pool) {
@@ -46,7 +70,6 @@ static bool module_init(struct module *m, struct ast_node *n, struct front_ctx *
     RF_MALLOC(m->types_set, sizeof(*m->types_set), return false);
     rf_objset_init(m->types_set, type);
 
-    rf_objset_init(&m->identifiers_set, string);
     rf_objset_init(&m->string_literals_set, string);
 
     return true;
@@ -70,7 +93,9 @@ static void module_deinit(struct module *m)
    if (m->symbol_table_records_pool) {
         rf_fixed_memorypool_destroy(m->symbol_table_records_pool);
     }
-    rf_objset_clear(&m->identifiers_set);
+    if (m->symbol_tables_pool) {
+        rf_fixed_memorypool_destroy(m->symbol_tables_pool);
+    }
     rf_objset_clear(&m->string_literals_set);
 
     if (m->types_set) {
@@ -84,6 +109,7 @@ static void module_deinit(struct module *m)
         rir_destroy(m->rir);
     }
 
+    htable_clear(&m->exports);
     darray_free(m->foreignfn_arr);
     darray_free(m->dependencies);
 }
@@ -98,7 +124,7 @@ void module_add_foreign_import(struct module *m, struct ast_node *import)
 {
     RF_ASSERT(ast_node_is_foreign_import(import), "Expected a foreign import node");
     struct ast_node *child;
-    rf_ilist_for_each(&import->children, child, lh) {
+    ast_node_foreach_child(import, child) {
         // for now foreign import should only import function decls
         AST_NODE_ASSERT_TYPE(child, AST_FUNCTION_DECLARATION);
         darray_append(m->foreignfn_arr, child);
@@ -110,9 +136,9 @@ bool module_add_import(struct module *m, struct ast_node *import)
     AST_NODE_ASSERT_TYPE(import, AST_IMPORT);
     struct ast_node *c;
     struct module *other_mod;
-    rf_ilist_for_each(&import->children, c, lh) {
+    ast_node_foreach_child(import, c) {
 
-        other_mod = compiler_module_get(ast_identifier_str(c));
+        other_mod = compiler_module_get(compiler_instance_get(), ast_identifier_str(c));
         if (!other_mod) {
             // requested import module not found
             i_info_ctx_add_msg(m->front->info,   
@@ -144,7 +170,7 @@ bool module_symbol_table_init(struct module *m)
               "Illegal ast node detected");
         return m->node->type == AST_ROOT
             ? true  // the root symbol table should have already been initialized
-            : symbol_table_init(&m->node->module.st, m);
+            : ast_module_symbol_table_init(m->node, m);
 }
 
 struct inpfile *module_get_file(const struct module *m)
@@ -154,12 +180,12 @@ struct inpfile *module_get_file(const struct module *m)
 
 bool module_is_main(const struct module *m)
 {
-    return rf_string_equal(module_name(m), &g_str_main);
+    return m->name_id == compiler_instance_get()->main_name_id;
 }
 
 bool module_add_stdlib(struct module *m)
 {
-    struct module *other_mod = compiler_module_get(&g_str_stdlib);
+    struct module *other_mod = compiler_module_get(compiler_instance_get(), &g_str_stdlib);
     if (!other_mod) {
         RF_ERROR("stdlib was requested but could not be found in the parsed compiler modules");
         return false;
@@ -171,6 +197,9 @@ bool module_add_stdlib(struct module *m)
 
 bool module_types_set_add(struct module *m, struct type *new_type)
 {
+    // the set is indexed by the cached uid. type_create_from_operation()
+    // recomputes it if it extends the type later.
+    type_cache_uid(new_type);
     return rf_objset_add(m->types_set, type, new_type);
 }
 
@@ -180,17 +209,27 @@ struct type *module_get_or_create_type(struct module *mod,
                                        struct ast_node *genrdecl)
 {
     struct type *t;
+    size_t uid;
     if (desc->type == AST_TYPE_LEAF) {
         desc = ast_typeleaf_right(desc);
     }
     if (desc->type == AST_XIDENTIFIER) {
         return type_lookup_xidentifier(desc, mod, st, genrdecl);
     }
-    struct rf_objset_iter it;
-    rf_objset_foreach(mod->types_set, &it, t) {
-        if (type_equals_ast_node(t, desc, mod, st, genrdecl, TYPECMP_IDENTICAL)) {
+    if (type_uid_from_ast_node(desc, st, &uid)) {
+        // a single probe of the types set
+        if ((t = type_objset_has_ast_node(mod->types_set, uid, desc, mod, st, genrdecl))) {
             return t;
         }
+    } else {
+        // the description's uid could not be determined, so compare it
+        // with every type of the set
+        struct rf_objset_iter it;
+        rf_objset_foreach(mod->types_set, &it, t) {
+            if (type_equals_ast_node(t, desc, mod, st, genrdecl, TYPECMP_IDENTICAL)) {
+                return t;
+            }
+        }
     }
 
     // else we have to create a new type
@@ -246,28 +285,41 @@ bool module_determine_dependencies(struct module *m, bool use_stdlib)
 bool module_analyze(struct module *m)
 {
     bool ret = false;
+    struct compiler_profile *profile = &compiler_instance_get()->profile;
+    struct compiler_profile_sample sample;
     // since analyze pass is always going to be one per thread initializing
     // thread local type creation context here should be okay
     type_creation_ctx_init();
     // create symbol tables and change ast nodes ownership
+    compiler_profile_begin(profile, &sample);
     if (!analyzer_first_pass(m)) {
         if (!module_have_errors(m)) {
             RF_ERROR("Failure at module analysis first pass");
         }
         goto end;
     }
+    compiler_profile_end(profile, COMPILER_PHASE_ANALYZER_FIRST_PASS, &sample);
 
+    if (!module_exports_build(m)) {
+        RF_ERROR("Failed to index the symbols exported to a module");
+        goto end;
+    }
+
+    compiler_profile_begin(profile, &sample);
     if (!analyzer_typecheck(m, m->node)) {
         if (!module_have_errors(m)) {
             RF_ERROR("Failure at module's typechecking");
         }
         goto end;
     }
+    compiler_profile_end(profile, COMPILER_PHASE_ANALYZER_TYPECHECK, &sample);
 
+    compiler_profile_begin(profile, &sample);
     if (!analyzer_finalize(m)) {
         RF_ERROR("Failure at module's finalization");
         goto end;
     }
+    compiler_profile_end(profile, COMPILER_PHASE_ANALYZER_FINALIZE, &sample);
 
     // success
     ret = true;
@@ -276,6 +328,57 @@ end:
     return ret;
 }
 
+struct module_exports_ctx {
+    struct module *m;
+    //! The dependency whose records are being indexed
+    const struct module *dep;
+    bool success;
+};
+
+static void module_exports_add(struct symbol_table_record *rec,
+                               struct module_exports_ctx *ctx)
+{
+    if (!ctx->success || rec->interned_id == ctx->dep->name_id) {
+        return;
+    }
+    // an earlier dependency or an inner symbol table already exported it
+    if (module_exports_lookup(ctx->m, rec->interned_id, rec->hash)) {
+        return;
+    }
+    ctx->success = htable_add(&ctx->m->exports, rec->hash, rec);
+}
+
+bool module_exports_build(struct module *m)
+{
+    struct module **dep;
+    struct symbol_table *st;
+    struct module_exports_ctx ctx = { .m = m, .success = true };
+    htable_clear(&m->exports);
+    m->exports_ready = false;
+    darray_foreach(dep, m->dependencies) {
+        if (!(*dep)->exports_ready) {
+            // lookups will search the dependencies themselves
+            return true;
+        }
+    }
+    darray_foreach(dep, m->dependencies) {
+        ctx.dep = *dep;
+        for (st = module_symbol_table(*dep); st; st = st->parent) {
+            symbol_table_iterate(st, (htable_iter_cb)module_exports_add, &ctx);
+        }
+        htable_iterate_records(&(*dep)->exports, (htable_iter_cb)module_exports_add, &ctx);
+    }
+    m->exports_ready = ctx.success;
+    return ctx.success;
+}
+
+struct symbol_table_record *module_exports_lookup(const struct module *m,
+                                                  uint32_t id,
+                                                  uint32_t hash)
+{
+    return htable_get(&m->exports, hash, exports_cmp_fn, &id);
+}
+
 bool module_have_errors(const struct module *m)
 {
     return info_ctx_has(m->front->info, MESSAGE_SEMANTIC_ERROR | MESSAGE_SYNTAX_ERROR);
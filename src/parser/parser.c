@@ -17,6 +17,7 @@ bool parser_init(struct parser *p,
     p->info = info;
     p->front = front;
     p->have_syntax_err = false;
+    p->memo = NULL;
     return true;
 }
 
@@ -40,6 +41,7 @@ void parser_deinit(struct parser *p)
         // if parser has ownership of ast tree
         ast_node_destroy(p->root);
     }
+    parser_memo_disable(p);
     p->lexer = NULL;
     p->info = NULL;
     p->file = NULL;
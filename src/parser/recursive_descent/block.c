@@ -133,11 +133,17 @@ struct ast_node *parser_acc_block(struct parser *p, bool expect_braces)
         start = ast_node_startmark(element);
     }
     end = ast_node_endmark(element);
-    ast_block_add_element(n, element);
+    if (!ast_block_add_element(n, element)) {
+        ast_node_destroy(element);
+        goto err_free_block;
+    }
 
     // now add elements to the block
     while ((element = parser_acc_block_element(p))) {
-        ast_block_add_element(n, element);
+        if (!ast_block_add_element(n, element)) {
+            ast_node_destroy(element);
+            goto err_free_block;
+        }
         end = ast_node_endmark(element);
     }
 
@@ -1,14 +1,12 @@
 #include <parser/parser.h>
 
 #include <inpfile.h>
-#include <module.h>
 #include <inpstr.h>
 #include <ast/function.h>
 #include <ast/ast.h>
 #include <ast/ast_utils.h>
 #include <lexer/lexer.h>
 #include <front_ctx.h>
-#include <compiler.h>
 #include <utils/common_strings.h>
 
 #include "common.h"
@@ -36,15 +34,8 @@ bool parser_finalize_parsing(struct parser *p)
 {
     bool main_found = false;
     ast_pre_traverse_tree(p->root, do_finalize_parsing, &main_found);
-    // if this is the main module or something else set the front's main flag
-    if (main_found || p->front->is_main) {
-        if (!compiler_set_main(p->front)) {
-            return false;
-        }
-        if (!module_create(p->root, p->front)) {
-            return false;
-        }
-    }
+    // modules are registered with the compiler later, see front_ctx_register_modules()
+    p->front->main_found = main_found;
     return true;
 }
 
@@ -53,7 +44,10 @@ bool parser_parse_file(struct parser *p)
     struct ast_node *stmt;
     p->root = ast_root_create(p->file);
     while ((stmt = parser_acc_stmt(p))) {
-        ast_node_add_child(p->root, stmt);
+        if (!ast_node_add_child(p->root, stmt)) {
+            ast_node_destroy(stmt);
+            return false;
+        }
     }
 
     if (NULL != lexer_next_token(p->lexer)) {
@@ -87,9 +81,6 @@ static struct ast_node *parser_acc_stmt(struct parser *p)
     // TODO: Maybe change these, since each one of these macros actually checks for token existence too
     if (TOKEN_IS_MODULE_START(tok)) {
         stmt = parser_acc_module(p);
-        if (!stmt || !module_create(stmt, p->front)) {
-            return NULL;
-        }
     } else if (TOKEN_IS_BLOCK_START(tok)) {
         stmt = parser_acc_block(p, true);
     } else if (TOKENS_ARE_POSSIBLE_VARDECL(tok, tok2)) {
@@ -16,13 +16,6 @@
 #include "block.h"
 #include "matchexpr.h"
 
-#define MAX_LEVEL_OP_PRECEDENCE 13
-
-static struct ast_node *parser_acc_expression_prime(
-    struct parser *p,
-    struct ast_node *left_hand_side,
-    int level);
-
 static struct ast_node *parser_acc_expr_element(struct parser *p)
 {
     struct ast_node *n;
@@ -101,7 +94,10 @@ static struct ast_node *parser_acc_expr_element(struct parser *p)
     } else if (token_is_numeric_constant(tok) ||
         tok->type == TOKEN_IDENTIFIER ||
         tok->type == TOKEN_STRING_LITERAL) {
-        n = token_get_value(tok);
+        n = lexer_token_get_value(p->lexer, tok);
+        if (!n) {
+            return NULL;
+        }
     } else {
         // no expression found. This is not an error
         return NULL;
@@ -168,139 +164,68 @@ static struct ast_node *parser_acc_exprfactor(struct parser *p)
     return element;
 }
 
-static inline bool check_operator_type(struct token *tok, int level)
-{
-    if (!tok) {
-        return false;
-    }
-
-    switch(level) {
-    case 1: /* comma operator */
-        return (tok->type == TOKEN_OP_COMMA);
-    case 2: /* assignment */
-        return (tok->type == TOKEN_OP_ASSIGN);
-    case 3: /* logic OR */
-        return (tok->type == TOKEN_OP_LOGIC_OR);
-    case 4: /* logic AND */
-        return (tok->type == TOKEN_OP_LOGIC_AND);
-    case 5: /* bitwise OR */
-        return (tok->type == TOKEN_OP_TYPESUM);
-    case 6: /* bitwise XOR */
-        return (tok->type == TOKEN_OP_BITWISE_XOR);
-    case 7: /* bitwise AND */
-        return (tok->type == TOKEN_OP_AMPERSAND);
-
-
-
-    case 8: /* equality comparison */
-        return (tok->type == TOKEN_OP_EQ || tok->type == TOKEN_OP_NEQ);
-    case 9: /* relational comparison */
-        return (tok->type == TOKEN_OP_GT   ||
-                tok->type == TOKEN_OP_GTEQ ||
-                tok->type == TOKEN_OP_LT   ||
-                tok->type == TOKEN_OP_LTEQ);
-
-    case 10: /* additive operators */
-        return (tok->type == TOKEN_OP_PLUS || tok->type == TOKEN_OP_MINUS);
-    case 11: /* multiplicative operators */
-        return (tok->type == TOKEN_OP_MULTI || tok->type == TOKEN_OP_DIV);
-    case 12: /* access operators */
-        return tok->type == TOKEN_OP_MEMBER_ACCESS || tok->type == TOKEN_SM_OSBRACE;
-    /* case 12: */
-    /*     return tok->type == TOKEN_SM_OSBRACE; */
-    /* case 13: */
-    /*     return tok->type == TOKEN_OP_MEMBER_ACCESS; */
-    case MAX_LEVEL_OP_PRECEDENCE: /* no operators at the last level (expr_factor) */
-        return false;
-    }
-
-    // illegal expression parsing level, should never happen
-    RF_ASSERT_OR_CRITICAL(false, return false,
-                          "Illegal level %d for expression parsing", level);
-}
-
-static struct ast_node *parser_acc_exprlevel(struct parser *p, int level)
-{
-    struct ast_node *prime;
-    struct ast_node *term;
-
-    if (level == MAX_LEVEL_OP_PRECEDENCE) { // end, we got to the factor level
-        term = parser_acc_exprfactor(p);
-    } else {
-        term = parser_acc_exprlevel(p, level + 1);
-    }
-    if (!term) {
-        return NULL;
-    }
-
-    prime = parser_acc_expression_prime(p, term, level);
-    if (parser_has_syntax_error(p)) {
-        return NULL;
-    }
-
-    return prime ? prime : term;
-}
-
-static struct ast_node *parser_acc_expression_prime(
-    struct parser *p,
-    struct ast_node *left_hand_side,
-    int level)
+/**
+ * Precedence climbing: accepts an expression made of factors joined by
+ * binary operators whose precedence is at least @a min_prec
+ */
+static struct ast_node *parser_acc_expression_prec(struct parser *p,
+                                                   unsigned int min_prec)
 {
     struct token *tok;
+    struct ast_node *lhs;
     struct ast_node *op;
-    struct ast_node *right_hand_side;
-    struct ast_node *ret;
-
+    struct ast_node *rhs;
+    unsigned int prec;
 
-    tok = lexer_lookahead(p->lexer, 1);
-    if (!check_operator_type(tok, level)) {
+    lhs = parser_acc_exprfactor(p);
+    if (!lhs || parser_has_syntax_error(p)) {
         return NULL;
     }
-    //consume operator
-    lexer_next_token(p->lexer);
 
-    op = ast_binaryop_create(ast_node_startmark(left_hand_side), NULL,
-                             binaryop_type_from_token(tok),
-                             left_hand_side, NULL);
-    if (!op) {
-        RF_ERRNOMEM();
-        return NULL;
-    }
-    right_hand_side = parser_acc_exprlevel(p, level + 1);
-    if (!right_hand_side) {
-        parser_synerr(p, token_get_end(tok), NULL,
-                      "Expected "EXPR_ELEMENT_START" after "
-                      "\""RF_STR_PF_FMT"\"",
-                      RF_STR_PF_ARG(tokentype_to_str(tok->type)));
-        ast_node_destroy(op);
-        return NULL;
-    }
-    ast_binaryop_set_right(op, right_hand_side);
-    // special case here for array reference operator we need to consume the closing bracket
-    if (ast_binaryop_op(op) == BINARYOP_ARRAY_REFERENCE) {
-        tok = lexer_lookahead(p->lexer, 1);
-        if (tok->type != TOKEN_SM_CSBRACE) {
-            parser_synerr(p, token_get_start(tok), NULL,
-                          "Expected ']' after "RF_STR_PF_FMT,
-                          RF_STR_PF_ARG(ast_node_get_name_str(right_hand_side)));
+    while ((tok = lexer_lookahead(p->lexer, 1)) &&
+           (prec = binaryop_precedence_from_token(tok)) >= min_prec) {
+        //consume operator
+        lexer_next_token(p->lexer);
+
+        op = ast_binaryop_create(ast_node_startmark(lhs), NULL,
+                                 binaryop_type_from_token(tok),
+                                 lhs, NULL);
+        if (!op) {
+            RF_ERRNOMEM();
+            return NULL;
+        }
+        // left associativity: the right side only binds tighter operators
+        rhs = parser_acc_expression_prec(p, prec + 1);
+        if (!rhs) {
+            parser_synerr(p, token_get_end(tok), NULL,
+                          "Expected "EXPR_ELEMENT_START" after "
+                          "\""RF_STR_PF_FMT"\"",
+                          RF_STR_PF_ARG(tokentype_to_str(tok->type)));
             ast_node_destroy(op);
             return NULL;
         }
-        // consume ']'
-        lexer_next_token(p->lexer);
-        ast_node_set_end(op, token_get_end(tok));
-    }
-
-    ret = parser_acc_expression_prime(p, op, level);
-    if (parser_has_syntax_error(p)) {
-        // no need to free op here, since it's freed inside expression' accepting
-        return NULL;
+        ast_binaryop_set_right(op, rhs);
+        // special case here for array reference operator we need to consume the closing bracket
+        if (ast_binaryop_op(op) == BINARYOP_ARRAY_REFERENCE) {
+            tok = lexer_lookahead(p->lexer, 1);
+            if (!tok || tok->type != TOKEN_SM_CSBRACE) {
+                parser_synerr(p, tok ? token_get_start(tok) : lexer_last_token_end(p->lexer),
+                              NULL, "Expected ']' after "RF_STR_PF_FMT,
+                              RF_STR_PF_ARG(ast_node_get_name_str(rhs)));
+                ast_node_destroy(op);
+                return NULL;
+            }
+            // consume ']'
+            lexer_next_token(p->lexer);
+            ast_node_set_end(op, token_get_end(tok));
+        }
+        lhs = op;
     }
 
-    return ret ? ret : op;
+    return lhs;
 }
 
 struct ast_node *parser_acc_expression(struct parser *p)
 {
-    return parser_acc_exprlevel(p, 1);
+    return parser_acc_expression_prec(p, 1);
 }
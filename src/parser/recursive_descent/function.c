@@ -47,7 +47,7 @@ struct ast_node *parser_acc_fndecl(struct parser *p, int fndecl_position)
     if (GENRDECL_START_COND(tok)) {
         genr = parser_acc_genrdecl(p);
         if (!genr) {
-            goto err;
+            goto err_free_name;
         }
     }
 
@@ -115,6 +115,8 @@ err_free_genr:
     if (genr) {
         ast_node_destroy(genr);
     }
+err_free_name:
+    ast_node_destroy(name);
 err:
     lexer_rollback(p->lexer);
     return NULL;
@@ -138,7 +140,10 @@ enum parser_fndecl_list_err parser_acc_fndecl_list(struct parser *p,
         if (!decl) {
             return PARSER_FNDECL_LIST_FAILURE;
         }
-        ast_node_add_child(parent, decl);
+        if (!ast_node_add_child(parent, decl)) {
+            ast_node_destroy(decl);
+            return PARSER_FNDECL_LIST_FAILURE;
+        }
         tok = lexer_lookahead(p->lexer, 1);
     }
 
@@ -216,7 +221,10 @@ enum parser_fnimpl_list_err parser_acc_fnimpl_list(struct parser *p,
        if (!impl) {
            return PARSER_FNIMPL_LIST_FAILURE;
        }
-       ast_node_add_child(parent, impl);
+       if (!ast_node_add_child(parent, impl)) {
+           ast_node_destroy(impl);
+           return PARSER_FNIMPL_LIST_FAILURE;
+       }
        tok = lexer_lookahead(p->lexer, 1);
    }
 
@@ -239,8 +247,7 @@ struct ast_node *parser_acc_fncall(struct parser *p, bool expect_it)
 
     genr = parser_acc_genrattr(p, false);
     if (!genr && parser_has_syntax_error(p)) {
-        // name is an identifier and even in failure does not need to get destroyed here
-        goto err;
+        goto err_free_name;
     }
 
     tok = lexer_lookahead(p->lexer, 1);
@@ -293,6 +300,8 @@ err_free_genr:
     if (genr) {
         ast_node_destroy(genr);
     }
+err_free_name:
+    ast_node_destroy(name);
 err:
     lexer_rollback(p->lexer);
     return NULL;
@@ -9,13 +9,16 @@
 #include "common.h"
 #include "identifier.h"
 #include "type.h"
+#include "memo.h"
 
 
 //failure in this means syntax error
 static struct ast_node * parser_acc_genrtype(struct parser *p)
 {
     struct ast_node *type_id;
+    struct ast_node *type_name;
     struct token *tok;
+    struct token *tok2;
     struct ast_node *n;
 
     lexer_push(p->lexer);
@@ -25,25 +28,35 @@ static struct ast_node * parser_acc_genrtype(struct parser *p)
                       "Expected an identifier for the generic type kind");
         goto err;
     }
-    type_id = token_get_value(tok);
-
-    tok = lexer_next_token(p->lexer);
-    if (!tok || tok->type != TOKEN_IDENTIFIER) {
+    tok2 = lexer_next_token(p->lexer);
+    if (!tok2 || tok2->type != TOKEN_IDENTIFIER) {
         parser_synerr(p, lexer_last_token_end(p->lexer), NULL,
                       "Expected an identifier for the generic type name");
         goto err;
     }
 
+    // only create the nodes once the whole production is matched
+    type_id = lexer_token_get_value(p->lexer, tok);
+    if (!type_id) {
+        goto err;
+    }
+    type_name = lexer_token_get_value(p->lexer, tok2);
+    if (!type_name) {
+        goto err_free_id;
+    }
 
-
-    n = ast_genrtype_create(type_id, token_get_value(tok));
+    n = ast_genrtype_create(type_id, type_name);
     if (!n) {
         RF_ERRNOMEM();
-        goto err;
+        ast_node_destroy(type_name);
+        goto err_free_id;
     }
 
     lexer_pop(p->lexer);
     return n;
+
+err_free_id:
+    ast_node_destroy(type_id);
 err:
     lexer_rollback(p->lexer);
     return NULL;
@@ -69,7 +82,10 @@ static bool parser_acc_generic_decls_prime(struct parser *p,
                       "Expected a generic type after ','");
         return false;
     }
-    ast_node_add_child(parent, single);
+    if (!ast_node_add_child(parent, single)) {
+        ast_node_destroy(single);
+        return false;
+    }
     return parser_acc_generic_decls_prime(p, parent);
 }
 
@@ -82,7 +98,10 @@ static bool parser_acc_generic_decls(struct parser *p,
     if (!single) {
         return false;
     }
-    ast_node_add_child(parent, single);
+    if (!ast_node_add_child(parent, single)) {
+        ast_node_destroy(single);
+        return false;
+    }
     return parser_acc_generic_decls_prime(p, parent);
 }
 
@@ -204,7 +223,10 @@ static bool parser_acc_generic_attribute_prime(struct parser *p,
                       "Expected a generic attribute after ','");
         return false;
     }
-    ast_node_add_child(parent, single);
+    if (!ast_node_add_child(parent, single)) {
+        ast_node_destroy(single);
+        return false;
+    }
     return parser_acc_generic_attribute_prime(p, parent, expect_it);
 }
 
@@ -218,11 +240,14 @@ static bool parser_acc_generic_attribute(struct parser *p,
     if (!single) {
         return false;
     }
-    ast_node_add_child(parent, single);
+    if (!ast_node_add_child(parent, single)) {
+        ast_node_destroy(single);
+        return false;
+    }
     return parser_acc_generic_attribute_prime(p, parent, expect_it);
 }
 
-struct ast_node *parser_acc_genrattr(struct parser *p, bool expect_it)
+static struct ast_node *parser_acc_genrattr_do(struct parser *p, bool expect_it)
 {
     struct ast_node *n = NULL;
     struct token *tok;
@@ -267,3 +292,19 @@ bailout:
     lexer_rollback(p->lexer);
     return NULL;
 }
+
+struct ast_node *parser_acc_genrattr(struct parser *p, bool expect_it)
+{
+    struct ast_node *n;
+    unsigned int start = lexer_curr_index(p->lexer);
+    // an expected attribute reports errors on failure so keep it separate
+    enum parser_memo_production prod = expect_it
+        ? PARSER_MEMO_GENRATTR_EXPECTED
+        : PARSER_MEMO_GENRATTR;
+    if (parser_memo_lookup(p, prod, &n)) {
+        return n;
+    }
+    n = parser_acc_genrattr_do(p, expect_it);
+    parser_memo_store(p, prod, start, n);
+    return n;
+}
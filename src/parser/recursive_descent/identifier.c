@@ -49,12 +49,16 @@ struct ast_node *parser_acc_xidentifier(struct parser *p, bool expect_it)
     }
     //consume identifier
     lexer_next_token(p->lexer);
-    id = token_get_value(tok);
+    id = lexer_token_get_value(p->lexer, tok);
+    if (!id) {
+        return NULL;
+    }
     end = ast_node_endmark(id);
 
     tok = lexer_lookahead(p->lexer, 1);
     genr = parser_acc_genrattr(p, false); // can be NULL for example in: if a < 15 { .. }
     if (!genr && parser_has_syntax_error(p)) {
+        ast_node_destroy(id);
         return NULL;
     }
     if (genr) {
@@ -64,6 +68,10 @@ struct ast_node *parser_acc_xidentifier(struct parser *p, bool expect_it)
     xid = ast_xidentifier_create(start, end, id, is_const, genr);
     if (!xid) {
         RF_ERRNOMEM();
+        if (genr) {
+            ast_node_destroy(genr);
+        }
+        ast_node_destroy(id);
         return NULL;
     }
 
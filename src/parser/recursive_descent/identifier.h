@@ -25,7 +25,7 @@ i_INLINE_DECL struct ast_node *parser_acc_identifier(struct parser *p)
     }
     // consume the identifier token and return it
     lexer_next_token(p->lexer);
-    return token_get_value(tok);
+    return lexer_token_get_value(p->lexer, tok);
 }
 
 /**
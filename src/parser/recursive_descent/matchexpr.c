@@ -89,11 +89,13 @@ struct ast_node *parser_acc_matchexpr(struct parser *p,
         if (got_paren && !(tok = lexer_expect_token(p->lexer, TOKEN_SM_CPAREN))) {
             parser_synerr(p, lexer_last_token_end(p->lexer), NULL,
                           "Expected a closing ')' after identifier");
+            ast_node_destroy(id);
             goto fail;
         }
         match_expr = ast_matchexpr_create(start, token_get_end(tok), id);
         if (!match_expr) {
             RF_ERROR("Failed to allocate a match expression node");
+            ast_node_destroy(id);
             goto fail;
         }
         
@@ -118,12 +120,18 @@ struct ast_node *parser_acc_matchexpr(struct parser *p,
             RF_ERROR("Failed to allocate a match expression node");
             goto fail;
         }
-        ast_matchexpr_add_case(match_expr, match_case);
+        if (!ast_matchexpr_add_case(match_expr, match_case)) {
+            ast_node_destroy(match_case);
+            goto fail_free_matchexpr;
+        }
     }
 
     const struct inplocation_mark *end;
     while ((match_case = parser_accept_matchcase(p))) {
-        ast_matchexpr_add_case(match_expr, match_case);
+        if (!ast_matchexpr_add_case(match_expr, match_case)) {
+            ast_node_destroy(match_case);
+            goto fail_free_matchexpr;
+        }
         end = ast_node_endmark(match_case);
     }
     if (parser_has_syntax_error(p)) { // last match_case parsing failed
@@ -0,0 +1,96 @@
+#include "memo.h"
+
+#include <Utils/memory.h>
+#include <Utils/sanity.h>
+
+#include <parser/parser.h>
+#include <lexer/lexer.h>
+
+enum parser_memo_state {
+    PARSER_MEMO_UNKNOWN = 0,
+    PARSER_MEMO_FAILED,
+    PARSER_MEMO_PARSED,
+};
+
+struct parser_memo_entry {
+    //! The parsed subtree, if state is PARSER_MEMO_PARSED
+    struct ast_node *node;
+    //! Token index right after the parsed subtree
+    unsigned int end;
+    enum parser_memo_state state;
+};
+
+struct parser_memo {
+    //! Number of entries per production. One per token plus the EOF position
+    unsigned int size;
+    //! Per production arrays indexed by starting token. Created on first use
+    struct parser_memo_entry *entries[PARSER_MEMO_PRODUCTIONS_COUNT];
+};
+
+bool parser_memo_enable(struct parser *p)
+{
+    RF_ASSERT(!p->memo, "Parser memoization enabled twice");
+    RF_CALLOC(p->memo, 1, sizeof(*p->memo), return false);
+    p->memo->size = lexer_tokens_num(p->lexer) + 1;
+    return true;
+}
+
+void parser_memo_disable(struct parser *p)
+{
+    unsigned int i;
+    if (!p->memo) {
+        return;
+    }
+    for (i = 0; i < PARSER_MEMO_PRODUCTIONS_COUNT; ++i) {
+        free(p->memo->entries[i]);
+    }
+    free(p->memo);
+    p->memo = NULL;
+}
+
+bool parser_memo_lookup(struct parser *p,
+                        enum parser_memo_production prod,
+                        struct ast_node **n)
+{
+    struct parser_memo_entry *e;
+    unsigned int idx = lexer_curr_index(p->lexer);
+    if (!p->memo || !p->memo->entries[prod] || idx >= p->memo->size) {
+        return false;
+    }
+
+    e = &p->memo->entries[prod][idx];
+    switch (e->state) {
+    case PARSER_MEMO_FAILED:
+        *n = NULL;
+        return true;
+    case PARSER_MEMO_PARSED:
+        *n = e->node;
+        lexer_set_index(p->lexer, e->end);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void parser_memo_store(struct parser *p,
+                       enum parser_memo_production prod,
+                       unsigned int start,
+                       struct ast_node *n)
+{
+    struct parser_memo_entry *e;
+    if (!p->memo || start >= p->memo->size) {
+        return;
+    }
+    if (!n && parser_has_syntax_error(p)) {
+        return;
+    }
+    if (!p->memo->entries[prod]) {
+        RF_CALLOC(p->memo->entries[prod], p->memo->size,
+                  sizeof(struct parser_memo_entry), return);
+    }
+
+    e = &p->memo->entries[prod][start];
+    e->state = n ? PARSER_MEMO_PARSED : PARSER_MEMO_FAILED;
+    e->node = n;
+    e->end = lexer_curr_index(p->lexer);
+}
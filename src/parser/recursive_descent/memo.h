@@ -0,0 +1,50 @@
+#ifndef LFR_PARSER_RECURSIVE_DESCENT_MEMO_H
+#define LFR_PARSER_RECURSIVE_DESCENT_MEMO_H
+
+#include <stdbool.h>
+
+struct parser;
+struct ast_node;
+
+/**
+ * The productions whose results are memoized. Only productions that get
+ * speculatively retried at the same position are worth memoizing.
+ */
+enum parser_memo_production {
+    PARSER_MEMO_TYPEDESC = 0,
+    PARSER_MEMO_GENRATTR,
+    PARSER_MEMO_GENRATTR_EXPECTED,
+
+    PARSER_MEMO_PRODUCTIONS_COUNT /* always last */
+};
+
+/**
+ * Look up the result of @a prod at the current position of the lexer
+ *
+ * On a hit of a successful parse the lexer is moved right after the
+ * memoized subtree, exactly as if the production had been parsed again.
+ *
+ * @param p          The parser
+ * @param prod       The production to look for
+ * @param n[out]     The memoized node or NULL if the production is known to
+ *                   fail at this position
+ * @return           true if there was a memoized result and false if the
+ *                   production needs to be parsed
+ */
+bool parser_memo_lookup(struct parser *p,
+                        enum parser_memo_production prod,
+                        struct ast_node **n);
+
+/**
+ * Remember the result of parsing @a prod starting at token index @a start.
+ * The end of the result is the current position of the lexer.
+ *
+ * Failures that reported a syntax error are not memoized since a lookup
+ * could not replay the error.
+ */
+void parser_memo_store(struct parser *p,
+                       enum parser_memo_production prod,
+                       unsigned int start,
+                       struct ast_node *n);
+
+#endif
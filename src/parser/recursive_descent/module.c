@@ -50,7 +50,10 @@ struct ast_node *parser_acc_import(struct parser *p)
         } else {
             info_ctx_pop(p->info);
         }
-        ast_node_add_child(import, child);
+        if (!ast_node_add_child(import, child)) {
+            ast_node_destroy(child);
+            goto fail_free;
+        }
         end = ast_node_endmark(child);
     } while (lexer_expect_token(p->lexer, TOKEN_OP_COMMA));
     ast_node_set_end(import, end);
@@ -107,7 +110,7 @@ struct ast_node *parser_acc_module(struct parser *p)
     if (!tok || (tok->type != TOKEN_SM_OPAREN && tok->type != TOKEN_SM_OCBRACE)) {
         parser_synerr(p, lexer_last_token_end(p->lexer), NULL,
                       "Expected a '(' or a '{' at module declaration");
-        goto err;
+        goto err_free_args;
     }
 
     if (tok->type == TOKEN_SM_OPAREN) {
@@ -119,7 +122,7 @@ struct ast_node *parser_acc_module(struct parser *p)
             parser_synerr(p, token_get_end(tok), NULL,
                           "Expected either a type description for the module's "
                           "arguments or ')' after '('");
-            goto err;
+            goto err_free_args;
         }
 
         if (!lexer_expect_token(p->lexer, TOKEN_SM_CPAREN)) {
@@ -146,9 +149,13 @@ struct ast_node *parser_acc_module(struct parser *p)
         goto err_free_args;
     }
     args = NULL;
+    name = NULL;
 
     while ((stmt = parser_acc_module_statement(p))) {
-        ast_node_add_child(n, stmt);
+        if (!ast_node_add_child(n, stmt)) {
+            ast_node_destroy(stmt);
+            goto err_free_module;
+        }
     }
 
     if (parser_has_syntax_error_reset(p)) {
@@ -172,6 +179,9 @@ err_free_args:
     if (args) {
         ast_node_destroy(args);
     }
+    if (name) {
+        ast_node_destroy(name);
+    }
 err:
     lexer_rollback(p->lexer);
     return NULL;
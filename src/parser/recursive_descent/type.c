@@ -9,6 +9,7 @@
 #include <parser/parser.h>
 #include "common.h"
 #include "identifier.h"
+#include "memo.h"
 
 /**
  * Call to parse a parenthesized typedesc once you are sure that next token is '('
@@ -59,7 +60,10 @@ struct ast_node *parser_acc_typeleaf(struct parser *p)
     tok2 = lexer_lookahead(p->lexer, 2);
     if (tok->type == TOKEN_IDENTIFIER &&
         tok2 && tok2->type == TOKEN_SM_COLON) {
-        left = token_get_value(tok);
+        left = lexer_token_get_value(p->lexer, tok);
+        if (!left) {
+            goto err;
+        }
         //consume identifier and ':'
         lexer_next_token(p->lexer);
         lexer_next_token(p->lexer);
@@ -72,13 +76,13 @@ struct ast_node *parser_acc_typeleaf(struct parser *p)
         } else {
             parser_synerr(p, lexer_last_token_end(p->lexer), NULL,
                           "expected "XIDENTIFIER_START_STR" or '(' after ':'");
-            goto err;
+            goto err_free_left;
         }
 
         if (!right) {
             parser_synerr(p, lexer_last_token_end(p->lexer), NULL,
                           "expected "XIDENTIFIER_START_STR" or '(' after ':'");
-            goto err;
+            goto err_free_left;
         }
 
         n = ast_typeleaf_create(ast_node_startmark(left),
@@ -86,7 +90,8 @@ struct ast_node *parser_acc_typeleaf(struct parser *p)
                                 left, right);
         if (!n) {
             RF_ERRNOMEM();
-            goto err;
+            ast_node_destroy(right);
+            goto err_free_left;
         }
     } else { // last expansion of type_leaf rule, just an xidentifier
         n = parser_acc_xidentifier(p, true);
@@ -95,6 +100,8 @@ struct ast_node *parser_acc_typeleaf(struct parser *p)
     lexer_pop(p->lexer);
     return n;
 
+err_free_left:
+    ast_node_destroy(left);
 err:
     lexer_rollback(p->lexer);
     return NULL;
@@ -304,7 +311,7 @@ fail:
     return NULL;
 }
 
-struct ast_node *parser_acc_typedesc(struct parser *p)
+static struct ast_node *parser_acc_typedesc_do(struct parser *p)
 {
     struct ast_node *prime;
     struct ast_node *term;
@@ -328,6 +335,18 @@ fail:
     return NULL;
 }
 
+struct ast_node *parser_acc_typedesc(struct parser *p)
+{
+    struct ast_node *n;
+    unsigned int start = lexer_curr_index(p->lexer);
+    if (parser_memo_lookup(p, PARSER_MEMO_TYPEDESC, &n)) {
+        return n;
+    }
+    n = parser_acc_typedesc_do(p);
+    parser_memo_store(p, PARSER_MEMO_TYPEDESC, start, n);
+    return n;
+}
+
 struct ast_node *parser_acc_typedesc_top(struct parser *p)
 {
     struct ast_node *ret;
@@ -363,7 +382,7 @@ struct ast_node *parser_acc_typedecl(struct parser *p)
 
     tok = lexer_next_token(p->lexer);
     if (!tok || tok->type != TOKEN_SM_OCBRACE) {
-        goto not_found;
+        goto err_free_name;
     }
 
     desc = parser_acc_typedesc_top(p);
@@ -372,14 +391,14 @@ struct ast_node *parser_acc_typedecl(struct parser *p)
                       "Expected data description for data declaration "
                       "of \""RF_STR_PF_FMT"\"",
                       RF_STR_PF_ARG(ast_identifier_str(name)));
-        goto not_found;
+        goto err_free_name;
     }
 
     /* from here and on we throw syntax errors if something goes wrong */
     data_decl = ast_typedecl_create(start, NULL, name, desc);
     if (!data_decl) {//memory error
         ast_node_destroy(desc);
-        goto not_found;
+        goto err_free_name;
     }
 
     tok = lexer_next_token(p->lexer);
@@ -396,7 +415,11 @@ struct ast_node *parser_acc_typedecl(struct parser *p)
     return data_decl;
 
 err_free:
+    // the type declaration owns its name
     ast_node_destroy(data_decl);
+    goto not_found;
+err_free_name:
+    ast_node_destroy(name);
 not_found:
     lexer_rollback(p->lexer);
     return NULL;
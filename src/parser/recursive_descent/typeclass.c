@@ -95,6 +95,7 @@ err_free_genr:
     if (genr) {
         ast_node_destroy(genr);
     }
+    ast_node_destroy(name);
 err_free_typeclass:
     if (n) {
         ast_node_destroy(n);
@@ -138,7 +139,7 @@ struct ast_node *parser_acc_typeinstance(struct parser *p)
                       "Expected an identifier for the name of \""RF_STR_PF_FMT"\" "
                       "typeclass instance",
                       RF_STR_PF_ARG(ast_identifier_str(class_name)));
-        goto err;
+        goto err_free_class_name;
     }
 
     genr = parser_acc_genrdecl(p);
@@ -148,7 +149,7 @@ struct ast_node *parser_acc_typeinstance(struct parser *p)
                       RF_STR_PF_FMT"\" after type name \""RF_STR_PF_FMT"\"",
                       RF_STR_PF_ARG(ast_identifier_str(class_name)),
                       RF_STR_PF_ARG(ast_identifier_str(type_name)));
-        goto err;
+        goto err_free_genr;
     }
 
     tok = lexer_next_token(p->lexer);
@@ -203,14 +204,17 @@ struct ast_node *parser_acc_typeinstance(struct parser *p)
 
     return n;
 
+err_free_typeinstance:
+    // the type instance owns the names and the generic declaration
+    ast_node_destroy(n);
+    return NULL;
 err_free_genr:
     if (genr) {
         ast_node_destroy(genr);
     }
-err_free_typeinstance:
-    if (n) {
-        ast_node_destroy(n);
-    }
+    ast_node_destroy(type_name);
+err_free_class_name:
+    ast_node_destroy(class_name);
 err:
     return NULL;
 }
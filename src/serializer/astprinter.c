@@ -33,9 +33,9 @@ static json_object *astprinter_json_new(const struct astprinter *p,
     
     json_object *typejstr = json_object_new_string(type);
     json_object_object_add(ret, "type", typejstr);
-    json_object *locstart = json_object_new_int64(inpfile_ptr_to_offset(p->infile, start_mark->p));
+    json_object *locstart = json_object_new_int64(start_mark->off);
     json_object_object_add(ret, "start", locstart);
-    json_object *locend = json_object_new_int64(inpfile_ptr_to_offset(p->infile, end_mark->p));
+    json_object *locend = json_object_new_int64(end_mark->off);
     json_object_object_add(ret, "end", locend);
     
     return ret;
@@ -105,7 +105,7 @@ static bool astprinter_handle_node(struct astprinter *p,
             json_children = json_object_new_array();
         }
         struct ast_node *child;
-        rf_ilist_for_each(&n->children, child, lh) {
+        ast_node_foreach_child(n, child) {
             if (new_json) {
                 p->current = json_children;
             }
@@ -137,7 +137,7 @@ bool ast_output_to_file(const struct ast_node *root,
     }
 
     struct ast_node *child;
-    rf_ilist_for_each(&root->children, child, lh) {
+    ast_node_foreach_child(root, child) {
         if (!astprinter_handle_node(&p, child)) {
             return false;
         }
@@ -158,6 +158,7 @@ struct type *type_alloc(struct module *m)
 {
     struct type *ret = rf_fixed_memorypool_alloc_element(m->types_pool);
     RF_STRUCT_ZERO(ret);
+    pool_usage_alloc(&m->types_usage);
     return ret;
 }
 
@@ -170,6 +171,13 @@ void type_free(struct type *t, struct rf_fixed_memorypool *pool)
     rf_fixed_memorypool_free_element(pool, t);
 }
 
+//! Free a type that was just allocated with type_alloc()
+static inline void type_free_from_module(struct type *t, struct module *m)
+{
+    pool_usage_free(&m->types_usage);
+    type_free(t, m->types_pool);
+}
+
 /* -- type creation and initialization functions used internally -- */
 static bool type_init_from_typeelem(struct type *t,
                                     const struct ast_node *typeelem,
@@ -234,7 +242,7 @@ struct type *type_create_from_typeelem(const struct ast_node *typedesc,
         return NULL;
     }
     if (!type_init_from_typeelem(ret, typedesc, m, st, genrdecl)) {
-        type_free(ret, m->types_pool);
+        type_free_from_module(ret, m);
         return NULL;
     }
 
@@ -275,19 +283,39 @@ struct type *type_lookup_or_create(const struct ast_node *n,
     return ret;
 }
 
+// The types set is indexed by uid, so a type of the set that changes in place
+// has to be moved to the bucket of its new uid
+static inline bool type_set_unindex(struct module *m, struct type *t)
+{
+    return htable_del(&m->types_set->raw.ht, type_get_uid(t), t);
+}
+
+static inline void type_set_reindex(struct module *m, struct type *t, bool indexed)
+{
+    type_cache_uid(t);
+    if (indexed) {
+        htable_add(&m->types_set->raw.ht, type_get_uid(t), t);
+    }
+}
+
 struct type *type_create_from_operation(enum typeop_type typeop,
                                         struct type *left,
                                         struct type *right,
                                         struct module *m)
 {
     struct type *t;
+    bool indexed;
     if (left->category == TYPE_CATEGORY_OPERATOR && left->operator.type == typeop) {
-        darray_append(left->operator.operands, right);
         t = left;
+        indexed = type_set_unindex(m, t);
+        darray_append(t->operator.operands, right);
+        type_set_reindex(m, t, indexed);
     } else if (right->category == TYPE_CATEGORY_OPERATOR && right->operator.type == typeop) {
-        darray_prepend(right->operator.operands, left);
         t = right;
-    } else if (!(t = type_objset_has_string(m->types_set, type_op_create_str(left, right, typeop)))) {
+        indexed = type_set_unindex(m, t);
+        darray_prepend(t->operator.operands, left);
+        type_set_reindex(m, t, indexed);
+    } else if (!(t = type_objset_has_uid(m->types_set, type_op_create_uid(left, right, typeop)))) {
         // else if the type [left OP right] is not already in the set create a new type
         t = type_alloc(m);
         if (!t) {
@@ -353,7 +381,7 @@ struct type *type_create_from_typedecl(const struct ast_node *n,
                                             st,
                                             ast_typedecl_genrdecl_get(n));
     if (!t->defined.type) {
-        type_free(t, m->types_pool);
+        type_free_from_module(t, m);
         return NULL;
     }
 
@@ -421,7 +449,7 @@ struct type *type_create_from_fndecl(const struct ast_node *n,
 
     if (!type_init_from_fndecl(t, n, m, st)) {
         RF_ERROR("Function type initialization failure");
-        type_free(t, m->types_pool);
+        type_free_from_module(t, m);
         return NULL;
     }
 
@@ -498,7 +526,7 @@ struct type *type_operator_create_from_node(struct ast_node *n,
     }
 
     if (!type_operator_init_from_node(t, n, m, st, genrdecl)) {
-        type_free(t, m->types_pool);
+        type_free_from_module(t, m);
         return NULL;
     }
 
@@ -518,7 +546,7 @@ struct type *type_lookup_xidentifier(const struct ast_node *n,
     AST_NODE_ASSERT_TYPE(n, AST_XIDENTIFIER);
     id = ast_xidentifier_str(n);
 
-    ret = type_lookup_identifier_string(id, st);
+    ret = type_lookup_identifier(n, st);
     if (ret) {
         return ret;
     }
@@ -543,10 +571,9 @@ struct type *type_lookup_xidentifier(const struct ast_node *n,
 
 }
 
-struct type *type_lookup_identifier_string(const struct RFstring *str,
-                                           const struct symbol_table *st)
+// Types which are known without looking into any symbol table
+static struct type *type_lookup_builtin(const struct RFstring *str)
 {
-    struct symbol_table_record *rec;
     int elementary_type;
 
     if (string_is_wildcard(str)) {
@@ -558,14 +585,37 @@ struct type *type_lookup_identifier_string(const struct RFstring *str,
     if (elementary_type != -1) {
         return (struct type*)type_elementary_get_type(elementary_type);
     }
+    return NULL;
+}
+
+struct type *type_lookup_identifier_string(const struct RFstring *str,
+                                           const struct symbol_table *st)
+{
+    struct symbol_table_record *rec;
+    struct type *ret = type_lookup_builtin(str);
+    if (ret) {
+        return ret;
+    }
 
     // if not check if we know about it from the symbol tables
     rec = symbol_table_lookup_record(st, str, NULL);
-    if (rec) {
-        return symbol_table_record_type(rec);
+    return rec ? symbol_table_record_type(rec) : NULL;
+}
+
+struct type *type_lookup_identifier(const struct ast_node *n,
+                                    const struct symbol_table *st)
+{
+    struct symbol_table_record *rec;
+    struct type *ret = type_lookup_builtin(ast_identifier_str(n));
+    if (ret) {
+        return ret;
     }
 
-    return NULL;
+    rec = symbol_table_lookup_record_id(st,
+                                        ast_identifier_id(n),
+                                        ast_identifier_hash(n),
+                                        NULL);
+    return rec ? symbol_table_record_type(rec) : NULL;
 }
 
 static struct RFstring *type_str_do(const struct type *t, int options)
@@ -631,13 +681,188 @@ struct RFstring *type_op_create_str(const struct type *t1,
     );
 }
 
+// Seeds that keep types of different categories apart in type_get_uid()
+#define TYPE_UID_SEED_OPERATOR   0x2f6b1a3dU
+#define TYPE_UID_SEED_ELEMENTARY 0x5c83e9a1U
+#define TYPE_UID_SEED_DEFINED    0x7d1e4b29U
+#define TYPE_UID_SEED_MODULE     0x13a9c67fU
+#define TYPE_UID_SEED_OTHER      0x61d0f5b7U
+
+static inline uint32_t type_uid_mix(uint32_t h, uint32_t v)
+{
+    return h ^ (v + 0x9e3779b9U + (h << 6) + (h >> 2));
+}
+
+static uint32_t type_compute_uid(const struct type *t)
+{
+    struct type **operand;
+    uint32_t h;
+    switch (t->category) {
+    case TYPE_CATEGORY_OPERATOR:
+        h = type_uid_mix(TYPE_UID_SEED_OPERATOR, t->operator.type);
+        darray_foreach(operand, t->operator.operands) {
+            h = type_uid_mix(h, type_get_uid(*operand));
+        }
+        return h;
+    case TYPE_CATEGORY_ELEMENTARY:
+        // constness does not make a type different for the types set
+        return type_uid_mix(TYPE_UID_SEED_ELEMENTARY, t->elementary.etype);
+    case TYPE_CATEGORY_DEFINED:
+        h = type_uid_mix(TYPE_UID_SEED_DEFINED, rf_hash_str_stable(t->defined.name, 0));
+        return type_uid_mix(h, type_get_uid(t->defined.type));
+    case TYPE_CATEGORY_MODULE:
+        return type_uid_mix(TYPE_UID_SEED_MODULE, rf_hash_str_stable(t->module.name, 0));
+    default:
+        return type_uid_mix(TYPE_UID_SEED_OTHER, t->category);
+    }
+}
+
 size_t type_get_uid(const struct type *t)
 {
-    size_t ret;
-    RFS_PUSH();
-    ret = rf_hash_str_stable(type_str_or_die(t, TSTR_DEFINED_CONTENTS), 0);
-    RFS_POP();
-    return ret;
+    return t->uid != 0 ? t->uid : type_compute_uid(t);
+}
+
+void type_cache_uid(struct type *t)
+{
+    t->uid = 0;
+    t->uid = type_compute_uid(t);
+}
+
+size_t type_op_create_uid(const struct type *t1,
+                          const struct type *t2,
+                          enum typeop_type optype)
+{
+    // must match type_compute_uid() for an operator with operands [t1, t2]
+    uint32_t h = type_uid_mix(TYPE_UID_SEED_OPERATOR, optype);
+    h = type_uid_mix(h, type_get_uid(t1));
+    return type_uid_mix(h, type_get_uid(t2));
+}
+
+/*
+ * The functions below compute the uid of the type that would be created for
+ * a type description, following the way type_operator_init_from_node() and
+ * type_add_to_currop() flatten the operands of nested operators of the same
+ * kind.
+ */
+static bool type_ast_uid(const struct ast_node *n,
+                         const struct symbol_table *st,
+                         uint32_t *uid);
+
+static const struct type *type_ast_uid_lookup(const struct ast_node *n,
+                                              const struct symbol_table *st)
+{
+    return type_lookup_identifier(n, st);
+}
+
+// Add an already existing type to the operator of kind @a op being hashed
+static void type_ast_uid_fold_type(const struct type *t,
+                                   enum typeop_type op,
+                                   uint32_t *h)
+{
+    struct type **operand;
+    if (t->category == TYPE_CATEGORY_OPERATOR && t->operator.type == op) {
+        darray_foreach(operand, t->operator.operands) {
+            *h = type_uid_mix(*h, type_get_uid(*operand));
+        }
+    } else {
+        *h = type_uid_mix(*h, type_get_uid(t));
+    }
+}
+
+static bool type_ast_uid_fold(const struct ast_node *n,
+                              enum typeop_type op,
+                              const struct symbol_table *st,
+                              uint32_t *h)
+{
+    const struct type *t;
+    const struct ast_node *desc;
+    uint32_t uid;
+    switch (n->type) {
+    case AST_TYPE_DESCRIPTION:
+        return type_ast_uid_fold(ast_typedesc_desc_get(n), op, st, h);
+    case AST_TYPE_OPERATOR:
+        if (ast_typeop_op(n) == op) {
+            return type_ast_uid_fold(ast_typeop_left(n), op, st, h) &&
+                type_ast_uid_fold(ast_typeop_right(n), op, st, h);
+        }
+        break;
+    case AST_XIDENTIFIER:
+        if (!(t = type_ast_uid_lookup(n, st))) {
+            return false;
+        }
+        type_ast_uid_fold_type(t, op, h);
+        return true;
+    case AST_TYPE_LEAF:
+        desc = ast_typeleaf_right(n);
+        if (desc->type == AST_XIDENTIFIER) {
+            return type_ast_uid_fold(desc, op, st, h);
+        }
+        // the leaf's type is created on its own and its operands are
+        // flattened into the current operator if it is of the same kind
+        while (desc->type == AST_TYPE_DESCRIPTION) {
+            desc = ast_typedesc_desc_get(desc);
+        }
+        if (desc->type == AST_TYPE_OPERATOR && ast_typeop_op(desc) == op) {
+            return type_ast_uid_fold(desc, op, st, h);
+        }
+        n = ast_typeleaf_right(n);
+        break;
+    default:
+        return false;
+    }
+    // a type of its own, added as a single operand
+    if (!type_ast_uid(n, st, &uid)) {
+        return false;
+    }
+    *h = type_uid_mix(*h, uid);
+    return true;
+}
+
+static bool type_ast_uid(const struct ast_node *n,
+                         const struct symbol_table *st,
+                         uint32_t *uid)
+{
+    const struct type *t;
+    const struct ast_node *desc;
+    uint32_t h;
+    switch (n->type) {
+    case AST_TYPE_LEAF:
+        return type_ast_uid(ast_typeleaf_right(n), st, uid);
+    case AST_XIDENTIFIER:
+        if (!(t = type_ast_uid_lookup(n, st))) {
+            return false;
+        }
+        *uid = type_get_uid(t);
+        return true;
+    case AST_TYPE_DESCRIPTION:
+        desc = ast_typedesc_desc_get(n);
+        if (desc->type != AST_TYPE_OPERATOR && desc->type != AST_TYPE_DESCRIPTION) {
+            return false;
+        }
+        return type_ast_uid(desc, st, uid);
+    case AST_TYPE_OPERATOR:
+        h = type_uid_mix(TYPE_UID_SEED_OPERATOR, ast_typeop_op(n));
+        if (!type_ast_uid_fold(ast_typeop_left(n), ast_typeop_op(n), st, &h) ||
+            !type_ast_uid_fold(ast_typeop_right(n), ast_typeop_op(n), st, &h)) {
+            return false;
+        }
+        *uid = h;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool type_uid_from_ast_node(const struct ast_node *desc,
+                            const struct symbol_table *st,
+                            size_t *uid)
+{
+    uint32_t ret;
+    if (!type_ast_uid(desc, st, &ret)) {
+        return false;
+    }
+    *uid = ret;
+    return true;
 }
 
 const struct RFstring *type_get_unique_type_str(const struct type *t)
@@ -0,0 +1,71 @@
+#include <utils/arena.h>
+
+#include <stdlib.h>
+
+#include <Utils/memory.h>
+
+//! A type with the strictest alignment any allocation may need
+union arena_align {
+    long double d;
+    long long l;
+    void *p;
+    void (*f)(void);
+};
+
+#define ARENA_ALIGN (sizeof(union arena_align))
+#define ARENA_ALIGN_UP(n_) (((n_) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+struct arena_chunk {
+    struct arena_chunk *next;
+    union arena_align data[];
+};
+
+void arena_init(struct arena *a, size_t chunk_size)
+{
+    RF_STRUCT_ZERO(a);
+    a->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+}
+
+void arena_deinit(struct arena *a)
+{
+    struct arena_chunk *c = a->chunks;
+    struct arena_chunk *next;
+    while (c) {
+        next = c->next;
+        free(c);
+        c = next;
+    }
+    arena_init(a, a->chunk_size);
+}
+
+static bool arena_add_chunk(struct arena *a, size_t min_size)
+{
+    struct arena_chunk *c;
+    size_t size = min_size > a->chunk_size ? min_size : a->chunk_size;
+    RF_MALLOC(c, sizeof(*c) + size, return false);
+    c->next = a->chunks;
+    a->chunks = c;
+    a->ptr = (char*)c->data;
+    a->end = a->ptr + size;
+    ++a->chunks_num;
+    return true;
+}
+
+void *arena_alloc(struct arena *a, size_t size)
+{
+    void *ret;
+    size = ARENA_ALIGN_UP(size);
+    if ((size_t)(a->end - a->ptr) < size) {
+        if (!arena_add_chunk(a, size)) {
+            return NULL;
+        }
+    }
+    ret = a->ptr;
+    a->ptr += size;
+    ++a->allocations;
+    a->bytes += size;
+    return ret;
+}
+
+i_INLINE_INS size_t arena_allocations(const struct arena *a);
+i_INLINE_INS size_t arena_chunks(const struct arena *a);
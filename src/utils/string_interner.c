@@ -0,0 +1,213 @@
+#include <utils/string_interner.h>
+
+#include <string.h>
+
+#include <String/rf_str_core.h>
+#include <Utils/hash.h>
+#include <Utils/log.h>
+#include <Utils/memory.h>
+
+//! Starting number of slots of the lookup table
+#define STRING_INTERNER_INITIAL_SLOTS 1024
+
+static inline uint64_t slot_make(uint32_t hash, uint32_t id)
+{
+    // IDs are offset by one so that no occupied slot is zero
+    return ((uint64_t)hash << 32) | ((uint64_t)id + 1);
+}
+
+static inline uint32_t slot_hash(uint64_t slot)
+{
+    return (uint32_t)(slot >> 32);
+}
+
+static inline uint32_t slot_id(uint64_t slot)
+{
+    return (uint32_t)slot - 1;
+}
+
+static struct string_interner_table *table_create(uint32_t slots_num)
+{
+    struct string_interner_table *t;
+    RF_MALLOC(t, sizeof(*t) + slots_num * sizeof(uint64_t), return NULL);
+    t->mask = slots_num - 1;
+    t->prev = NULL;
+    memset(t->slots, 0, slots_num * sizeof(uint64_t));
+    return t;
+}
+
+// Place a slot in a table that is either not published yet or whose
+// writers are serialized by the interner's lock
+static void table_insert(struct string_interner_table *t, uint64_t slot)
+{
+    uint32_t i = slot_hash(slot) & t->mask;
+    while (t->slots[i] != 0) {
+        i = (i + 1) & t->mask;
+    }
+    __atomic_store_n(&t->slots[i], slot, __ATOMIC_RELEASE);
+}
+
+bool string_interner_init(struct string_interner *in)
+{
+    if (0 != pthread_mutex_init(&in->lock, NULL)) {
+        return false;
+    }
+    if (!(in->table = table_create(STRING_INTERNER_INITIAL_SLOTS))) {
+        pthread_mutex_destroy(&in->lock);
+        return false;
+    }
+    memset(in->chunks, 0, sizeof(in->chunks));
+    in->size = 0;
+    return true;
+}
+
+void string_interner_deinit(struct string_interner *in)
+{
+    uint32_t i;
+    struct string_interner_table *t;
+    for (i = 0; i < in->size; ++i) {
+        free((void*)string_interner_get(in, i));
+    }
+    for (i = 0; i < STRING_INTERNER_MAX_CHUNKS && in->chunks[i]; ++i) {
+        free(in->chunks[i]);
+    }
+    while ((t = in->table)) {
+        in->table = t->prev;
+        free(t);
+    }
+    pthread_mutex_destroy(&in->lock);
+}
+
+void string_interner_clear(struct string_interner *in)
+{
+    uint32_t i;
+    struct string_interner_table *t;
+    for (i = 0; i < in->size; ++i) {
+        free((void*)string_interner_get(in, i));
+    }
+    // keep the chunks and the largest table for the strings to come
+    while ((t = in->table->prev)) {
+        in->table->prev = t->prev;
+        free(t);
+    }
+    memset(in->table->slots, 0, (in->table->mask + 1) * sizeof(uint64_t));
+    in->size = 0;
+}
+
+static uint32_t string_interner_find(const struct string_interner *in,
+                                     const struct RFstring *s,
+                                     uint32_t hash)
+{
+    uint64_t slot;
+    const struct string_interner_table *t = __atomic_load_n(&in->table,
+                                                            __ATOMIC_ACQUIRE);
+    uint32_t i = hash & t->mask;
+    while ((slot = __atomic_load_n(&t->slots[i], __ATOMIC_ACQUIRE)) != 0) {
+        if (slot_hash(slot) == hash &&
+            rf_string_equal(string_interner_str(in, slot_id(slot)), s)) {
+            return slot_id(slot);
+        }
+        i = (i + 1) & t->mask;
+    }
+    return STRING_INTERNER_INVALID_ID;
+}
+
+// Keep the table at most half full, replacing it with a table of double the
+// size when needed
+static bool string_interner_reserve(struct string_interner *in)
+{
+    uint32_t i;
+    struct string_interner_table *old = in->table;
+    struct string_interner_table *t;
+    if ((in->size + 1) * 2 <= old->mask + 1) {
+        return true;
+    }
+    if (!(t = table_create((old->mask + 1) * 2))) {
+        return false;
+    }
+    for (i = 0; i <= old->mask; ++i) {
+        if (old->slots[i] != 0) {
+            table_insert(t, old->slots[i]);
+        }
+    }
+    t->prev = old;
+    __atomic_store_n(&in->table, t, __ATOMIC_RELEASE);
+    return true;
+}
+
+static uint32_t string_interner_add_locked(struct string_interner *in,
+                                           const struct RFstring *s,
+                                           uint32_t hash)
+{
+    struct interned_string *e;
+    struct interned_string ***chunk;
+    uint32_t id;
+    uint32_t len = rf_string_length_bytes(s);
+    // someone may have added the string since the caller's lookup
+    if ((id = string_interner_find(in, s, hash)) != STRING_INTERNER_INVALID_ID) {
+        return id;
+    }
+
+    if (in->size >= STRING_INTERNER_MAX_CHUNKS * STRING_INTERNER_CHUNK_SIZE) {
+        RF_ERROR("Too many distinct strings for the string interner");
+        return STRING_INTERNER_INVALID_ID;
+    }
+    if (!string_interner_reserve(in)) {
+        return STRING_INTERNER_INVALID_ID;
+    }
+    chunk = &in->chunks[in->size >> STRING_INTERNER_CHUNK_SHIFT];
+    if (!*chunk) {
+        RF_MALLOC(*chunk, STRING_INTERNER_CHUNK_SIZE * sizeof(**chunk),
+                  return STRING_INTERNER_INVALID_ID);
+    }
+
+    // keep the string's bytes in the same allocation as its entry
+    RF_MALLOC(e, sizeof(*e) + len, return STRING_INTERNER_INVALID_ID);
+    memcpy(e + 1, rf_string_data(s), len);
+    RF_STRING_SHALLOW_INIT(&e->str, (char*)(e + 1), len);
+    e->hash = hash;
+    e->id = in->size;
+    (*chunk)[e->id & (STRING_INTERNER_CHUNK_SIZE - 1)] = e;
+
+    // the release store of the slot makes the entry visible to lookups
+    table_insert(in->table, slot_make(hash, e->id));
+    __atomic_store_n(&in->size, in->size + 1, __ATOMIC_RELEASE);
+    return e->id;
+}
+
+uint32_t string_interner_add(struct string_interner *in,
+                             const struct RFstring *s)
+{
+    uint32_t ret;
+    // hash outside of the lock, it only depends on the string
+    uint32_t hash = rf_hash_str_stable(s, 0);
+    // most strings are already interned, so try without locking first
+    if ((ret = string_interner_find(in, s, hash)) != STRING_INTERNER_INVALID_ID) {
+        return ret;
+    }
+    pthread_mutex_lock(&in->lock);
+    ret = string_interner_add_locked(in, s, hash);
+    pthread_mutex_unlock(&in->lock);
+    return ret;
+}
+
+uint32_t string_interner_get_id(const struct string_interner *in,
+                                const struct RFstring *s)
+{
+    return string_interner_find(in, s, rf_hash_str_stable(s, 0));
+}
+
+uint32_t string_interner_get_id_h(const struct string_interner *in,
+                                  const struct RFstring *s,
+                                  uint32_t hash)
+{
+    return string_interner_find(in, s, hash);
+}
+
+i_INLINE_INS const struct interned_string *
+string_interner_get(const struct string_interner *in, uint32_t id);
+i_INLINE_INS const struct RFstring *
+string_interner_str(const struct string_interner *in, uint32_t id);
+i_INLINE_INS uint32_t string_interner_hash(const struct string_interner *in,
+                                           uint32_t id);
+i_INLINE_INS unsigned int string_interner_size(const struct string_interner *in);
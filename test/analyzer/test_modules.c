@@ -1,11 +1,16 @@
 #include <check.h>
+#include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <refu.h>
 #include <info/msg.h>
 
 #include <ast/function.h>
+#include <compiler.h>
+#include <compiler_args.h>
+#include <argtable/argtable3.h>
 
 #include "../testsupport_front.h"
 #include "../parser/testsupport_parser.h"
@@ -64,6 +69,128 @@ START_TEST (test_multiple_dependencies) {
 
 } END_TEST
 
+START_TEST (test_multiple_dependencies_parallel_parsing) {
+    static const struct RFstring base = RF_STRING_STATIC_INIT(
+        "module base {}"
+    );
+    static const struct RFstring pack1 = RF_STRING_STATIC_INIT(
+        "module package1 { import base }\n"
+    );
+    static const struct RFstring pack2 = RF_STRING_STATIC_INIT(
+        "module package2 { import base }\n"
+    );
+    static const struct RFstring child = RF_STRING_STATIC_INIT(
+        "module child {\n"
+        "    import package1\n"
+        "    import package2\n"
+        "}\n"
+    );
+    get_front_testdriver()->compiler->args->jobs->ival[0] = 3;
+    front_testdriver_new_source(&child);
+    front_testdriver_new_source(&pack1);
+    front_testdriver_new_source(&base);
+    front_testdriver_new_source(&pack2);
+
+    static const struct RFstring expected_modules[] = {
+        RF_STRING_STATIC_INIT("base"),
+        RF_STRING_STATIC_INIT("package2"),
+        RF_STRING_STATIC_INIT("package1"),
+        RF_STRING_STATIC_INIT("child"),
+    };
+    ck_assert_modules_order(expected_modules);
+
+    // modules are created in the order of their fronts, whichever thread parsed them
+    struct modules_arr *modules = &get_front_testdriver()->compiler->modules;
+    ck_assert_uint_eq(darray_size(*modules), 4);
+    ck_assert_rf_str_eq_cstr(module_name(darray_item(*modules, 0)), "child");
+    ck_assert_rf_str_eq_cstr(module_name(darray_item(*modules, 1)), "package1");
+    ck_assert_rf_str_eq_cstr(module_name(darray_item(*modules, 2)), "base");
+    ck_assert_rf_str_eq_cstr(module_name(darray_item(*modules, 3)), "package2");
+} END_TEST
+
+START_TEST (test_parallel_analysis_skips_dependents_of_failed_module) {
+    static const struct RFstring a = RF_STRING_STATIC_INIT(
+        "module a {\n"
+        "type person { name:string, age:if32 }\n"
+        "}"
+    );
+    static const struct RFstring b = RF_STRING_STATIC_INIT(
+        "module b { import a }\n"
+    );
+    static const struct RFstring c = RF_STRING_STATIC_INIT(
+        "module c {}\n"
+    );
+    get_front_testdriver()->compiler->args->jobs->ival[0] = 4;
+    front_testdriver_new_source(&a);
+    front_testdriver_new_source(&b);
+    front_testdriver_new_source(&c);
+
+    struct info_msg messages[] = {
+        TESTSUPPORT_INFOMSG_INIT_BOTH_SPECIFIC_FRONT(
+            0,
+            MESSAGE_SEMANTIC_ERROR,
+            "Type \"if32\" is not defined",
+            1, 31, 1, 34)
+    };
+    ck_assert_typecheck_with_messages(false, messages);
+} END_TEST
+
+#define DIAMOND_DEPTH 24
+#define MANY_MODULES_NUM 256
+START_TEST (test_many_modules_dependency_order) {
+    // m0 imports m1, m1 imports m2 e.t.c. so the sorted order is reversed
+    static char buff[MANY_MODULES_NUM * 40];
+    struct RFstring s;
+    struct module *mod;
+    unsigned int i;
+    size_t len = 0;
+    for (i = 0; i < MANY_MODULES_NUM - 1; ++i) {
+        len += sprintf(buff + len, "module m%u { import m%u }\n", i, i + 1);
+    }
+    len += sprintf(buff + len, "module m%u {}\n", i);
+    RF_STRING_SHALLOW_INIT(&s, buff, len);
+    front_testdriver_new_source(&s);
+
+    ck_assert(compiler_preprocess_fronts(get_front_testdriver()->compiler));
+    i = MANY_MODULES_NUM;
+    rf_ilist_for_each(&get_front_testdriver()->compiler->sorted_modules, mod, ln) {
+        ck_assert_uint_eq(mod->index, --i);
+    }
+    ck_assert_uint_eq(i, 0);
+} END_TEST
+
+START_TEST (test_deep_diamond_imports) {
+    // each level has two modules that both import the two modules of the
+    // next level, so searching through every dependency would visit the
+    // modules of the last level 2^DIAMOND_DEPTH times
+    static char buff[DIAMOND_DEPTH * 128 + 256];
+    struct RFstring s;
+    unsigned int i;
+    size_t len = 0;
+    len += sprintf(buff + len,
+                   "module top {\n"
+                   "import l0a\n"
+                   "import l0b\n"
+                   "type wrapper { p:person }\n"
+                   "}\n");
+    for (i = 0; i < DIAMOND_DEPTH - 1; ++i) {
+        len += sprintf(buff + len,
+                       "module l%ua {\nimport l%ua\nimport l%ub\n}\n"
+                       "module l%ub {\nimport l%ua\nimport l%ub\n}\n",
+                       i, i + 1, i + 1, i, i + 1, i + 1);
+    }
+    len += sprintf(buff + len,
+                   "module l%ua {\nimport base\n}\n"
+                   "module l%ub {\nimport base\n}\n"
+                   "module base {\n"
+                   "type person { name:string, age:u32 }\n"
+                   "}\n",
+                   i, i);
+    RF_STRING_SHALLOW_INIT(&s, buff, len);
+    front_testdriver_new_source(&s);
+    ck_assert_typecheck_ok();
+} END_TEST
+
 START_TEST (test_complicated_dependencies) {
     static const struct RFstring b = RF_STRING_STATIC_INIT(
         "module b {\n"
@@ -244,6 +371,35 @@ START_TEST (test_modules_nonexistent_import) {
 
 } END_TEST
 
+START_TEST (test_modules_redeclared_imported_function) {
+    // foo is declared further in its file than the whole of module b so
+    // its location only makes sense in module a's file
+    static const struct RFstring a = RF_STRING_STATIC_INIT(
+        "module a {\n"
+        "type person { name:string, age:u32 }\n"
+        "type pet { name:string, owner:person }\n"
+        "fn foo(x:u32) -> u32 { return x }\n"
+        "}\n"
+    );
+    static const struct RFstring b = RF_STRING_STATIC_INIT(
+        "module b {\n"
+        "import a\n"
+        "fn foo(x:u32) -> u32 { return x }\n"
+        "}\n"
+    );
+    front_testdriver_new_source(&a);
+    front_testdriver_new_source(&b);
+
+    struct info_msg messages[] = {
+        TESTSUPPORT_INFOMSG_INIT_BOTH_SPECIFIC_FRONT(
+            1,
+            MESSAGE_SEMANTIC_ERROR,
+            "Function \"foo\" was already declared at test_filename:3:0",
+            2, 0, 2, 19)
+    };
+    ck_assert_typecheck_with_messages(false, messages);
+} END_TEST
+
 START_TEST (test_modules_main_detection) {
     static const struct RFstring mainm = RF_STRING_STATIC_INIT(
         "fn main() -> u32 { }\n"
@@ -262,6 +418,62 @@ START_TEST (test_modules_main_detection) {
 
 } END_TEST
 
+START_TEST (test_compiler_reset_and_reuse) {
+    static const struct RFstring a = RF_STRING_STATIC_INIT(
+        "module a { import b }\n"
+    );
+    static const struct RFstring b = RF_STRING_STATIC_INIT(
+        "module b {}\n"
+    );
+    static const struct RFstring name = RF_STRING_STATIC_INIT("other_filename");
+    static const struct RFstring b_name = RF_STRING_STATIC_INIT("b");
+    struct compiler *c = get_front_testdriver()->compiler;
+    struct compiler *other;
+    front_testdriver_new_source(&a);
+    front_testdriver_new_source(&b);
+    ck_assert_typecheck_ok();
+
+    // a second compiler can exist next to the first one
+    other = compiler_create(LOG_TARGET_STDOUT, false);
+    ck_assert(other);
+    ck_assert(compiler_new_front_from_source(other, &name, &b));
+    ck_assert(compiler_preprocess_fronts(other));
+    ck_assert(compiler_analyze(other));
+    ck_assert_uint_eq(darray_size(other->modules), 1);
+    compiler_destroy(other);
+    ck_assert_uint_eq(darray_size(c->modules), 2);
+
+    // and the first one can be reused for another program
+    ck_assert(compiler_reset(c, false));
+    ck_assert_uint_eq(darray_size(c->modules), 0);
+    front_testdriver_new_source(&b);
+    ck_assert_typecheck_ok();
+    ck_assert_uint_eq(darray_size(c->modules), 1);
+    ck_assert(compiler_module_get(c, &b_name));
+} END_TEST
+
+START_TEST (test_compiler_profile_counts_phases_and_pools) {
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "fn main() -> u32 {\n"
+        "    a:u32 = 15\n"
+        "    return a\n"
+        "}\n"
+    );
+    struct compiler *c = get_front_testdriver()->compiler;
+    struct module *mod;
+    c->profile.enabled = true;
+    front_testdriver_new_source(&s);
+    ck_assert_typecheck_ok();
+
+    ck_assert_uint_eq(c->profile.phases[COMPILER_PHASE_PARSE].runs, 1);
+    ck_assert_uint_eq(c->profile.phases[COMPILER_PHASE_ANALYZER_FIRST_PASS].runs, 1);
+    ck_assert_uint_eq(c->profile.phases[COMPILER_PHASE_ANALYZER_TYPECHECK].runs, 1);
+    ck_assert_uint_eq(c->profile.phases[COMPILER_PHASE_CREATE_RIR].runs, 0);
+    mod = darray_item(c->modules, 0);
+    ck_assert(mod->symbol_records_usage.peak > 0);
+    ck_assert(mod->types_usage.peak > 0);
+} END_TEST
+
 START_TEST (test_modules_multiple_main_error) {
     static const struct RFstring mainm = RF_STRING_STATIC_INIT(
         "fn main() -> u32 { }\n"
@@ -297,7 +509,10 @@ Suite *analyzer_modules_suite_create(void)
                               teardown_analyzer_tests);
     tcase_add_test(t_1, test_single_dependency);
     tcase_add_test(t_1, test_multiple_dependencies);
+    tcase_add_test(t_1, test_multiple_dependencies_parallel_parsing);
     tcase_add_test(t_1, test_complicated_dependencies);
+    tcase_add_test(t_1, test_many_modules_dependency_order);
+    tcase_add_test(t_1, test_deep_diamond_imports);
 
     TCase *t_2 = tcase_create("modules_dependency_cycles");
     tcase_add_checked_fixture(t_2,
@@ -313,6 +528,7 @@ Suite *analyzer_modules_suite_create(void)
                               teardown_analyzer_tests);
     tcase_add_test(t_3, test_modules_same_name);
     tcase_add_test(t_3, test_modules_nonexistent_import);
+    tcase_add_test(t_3, test_modules_redeclared_imported_function);
 
     TCase *t_4 = tcase_create("modules_analysis_misc");
     tcase_add_checked_fixture(t_4,
@@ -320,6 +536,9 @@ Suite *analyzer_modules_suite_create(void)
                               teardown_analyzer_tests);
     tcase_add_test(t_4, test_modules_main_detection);
     tcase_add_test(t_4, test_modules_multiple_main_error);
+    tcase_add_test(t_4, test_compiler_reset_and_reuse);
+    tcase_add_test(t_4, test_compiler_profile_counts_phases_and_pools);
+    tcase_add_test(t_4, test_parallel_analysis_skips_dependents_of_failed_module);
 
     suite_add_tcase(s, t_1);
     suite_add_tcase(s, t_2);
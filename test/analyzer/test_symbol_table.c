@@ -434,6 +434,78 @@ START_TEST(test_multiple_level_symbol_tables) {
     testsupport_types_equal(symbol_table_record_type(rec), ti8);
 } END_TEST
 
+START_TEST(test_lookup_with_hash_in_nested_blocks) {
+    struct symbol_table *st;
+    struct symbol_table_record *rec;
+    bool at_first;
+    static const struct RFstring v1s = RF_STRING_STATIC_INIT("var1");
+    static const struct RFstring v2s = RF_STRING_STATIC_INIT("var2");
+    static const struct RFstring nos = RF_STRING_STATIC_INIT("not_there");
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "var1:string\n"
+        "{\n"
+        "    {\n"
+        "        {\n"
+        "            var2:i8\n"
+        "        }\n"
+        "    }\n"
+        "}\n"
+    );
+    front_testdriver_new_main_source(&s);
+    testsupport_analyzer_prepare();
+    ck_assert(analyzer_first_pass(front_testdriver_module()));
+
+    struct ast_node *root = front_testdriver_module_root();
+    struct ast_node *block = ast_node_get_child(root, 1);
+    block = ast_node_get_child(block, 0);
+    block = ast_node_get_child(block, 0);
+    ck_assert_msg(block, "innermost block node was not found");
+    st = ast_block_symbol_table_get(block);
+
+    rec = symbol_table_lookup_record_h(st, &v2s, rf_hash_str_stable(&v2s, 0), &at_first);
+    ck_assert(rec);
+    ck_assert(at_first);
+    // found in the root after walking up all the parents
+    rec = symbol_table_lookup_record_h(st, &v1s, rf_hash_str_stable(&v1s, 0), &at_first);
+    ck_assert(rec);
+    ck_assert(!at_first);
+    ck_assert(rec == symbol_table_lookup_record(st, &v1s, NULL));
+    // and by the interned ID, as identifier nodes do
+    ck_assert(rec == symbol_table_lookup_record_id(st, rec->interned_id, rec->hash, &at_first));
+    ck_assert(!at_first);
+    ck_assert(!symbol_table_lookup_record_h(st, &nos, rf_hash_str_stable(&nos, 0), NULL));
+} END_TEST
+
+START_TEST(test_empty_block_symbol_tables_are_skipped) {
+    struct symbol_table *st;
+    struct symbol_table_record *rec;
+    static const struct RFstring v1s = RF_STRING_STATIC_INIT("var1");
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "{\n"
+        "    var1:u32\n"
+        "    {\n"
+        "        {\n"
+        "            var1 = 5\n"
+        "        }\n"
+        "    }\n"
+        "}\n"
+    );
+    front_testdriver_new_main_source(&s);
+    testsupport_analyzer_prepare();
+    ck_assert(analyzer_first_pass(front_testdriver_module()));
+
+    struct ast_node *outer = ast_node_get_child(front_testdriver_module_root(), 0);
+    struct ast_node *middle = ast_node_get_child(outer, 1);
+    struct ast_node *inner = ast_node_get_child(middle, 0);
+    ck_assert_uint_eq(ast_block_symbol_table_get(outer)->records_num, 1);
+    ck_assert_uint_eq(ast_block_symbol_table_get(middle)->records_num, 0);
+    ck_assert_uint_eq(ast_block_symbol_table_get(inner)->records_num, 0);
+
+    st = ast_block_symbol_table_get(inner);
+    testsupport_symbol_table_lookup_record(st, &v1s, rec, false);
+    ck_assert(rec == symbol_table_lookup_record(ast_block_symbol_table_get(outer), &v1s, NULL));
+} END_TEST
+
 Suite *analyzer_symboltable_suite_create(void)
 {
     Suite *s = suite_create("analyzer_symbol_table");
@@ -455,6 +527,8 @@ Suite *analyzer_symboltable_suite_create(void)
     tcase_add_test(st2, test_fndecl_symbol_table);
     tcase_add_test(st2, test_typedecl_symbol_table);
     tcase_add_test(st2, test_multiple_level_symbol_tables);
+    tcase_add_test(st2, test_lookup_with_hash_in_nested_blocks);
+    tcase_add_test(st2, test_empty_block_symbol_tables_are_skipped);
 
     TCase *st3 = tcase_create("analyzer_symbol_table_invalid_op");
     tcase_add_checked_fixture(st3,
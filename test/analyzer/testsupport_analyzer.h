@@ -48,7 +48,7 @@ void teardown_analyzer_tests_before_firstpass();
 
 #define testsupport_scan_and_parse()                                    \
     do {                                                                \
-        if (!compiler_preprocess_fronts()) {                            \
+        if (!compiler_preprocess_fronts(get_front_testdriver()->compiler)) { \
             testsupport_show_front_errors("Scanning/parsing failed");   \
         }                                                               \
 } while (0)
@@ -135,7 +135,7 @@ bool ck_assert_analyzer_errors_impl(struct info_msg *errors,
 //! Perform up to the parsing/finalizing stage and check for messages
 #define ck_test_parse_fronts(expected_result_, expected_msgs_)          \
     do {                                                                \
-        ck_assert_msg(expected_result_ == compiler_preprocess_fronts(), \
+        ck_assert_msg(expected_result_ == compiler_preprocess_fronts(get_front_testdriver()->compiler), \
                       "unexpected front parsing result");               \
         ck_assert_analyzer_errors(expected_msgs_);                      \
     } while (0)
@@ -146,7 +146,7 @@ bool ck_assert_analyzer_errors_impl(struct info_msg *errors,
 #define ck_assert_typecheck_ok()                                        \
     do {                                                                \
         testsupport_scan_and_parse();                                   \
-        if (!compiler_analyze()) {                                      \
+        if (!compiler_analyze(get_front_testdriver()->compiler)) { \
             testsupport_show_front_errors("Typechecking failed");       \
         }                                                               \
     } while(0)
@@ -154,7 +154,7 @@ bool ck_assert_analyzer_errors_impl(struct info_msg *errors,
 #define ck_assert_typecheck_with_messages(success_, expected_msgs_)     \
     do {                                                                \
         testsupport_scan_and_parse();                                   \
-        if (success_ != compiler_analyze()) {                           \
+        if (success_ != compiler_analyze(get_front_testdriver()->compiler)) { \
             testsupport_show_front_errors("Typechecking result was unexpected"); \
         }                                                               \
         ck_assert_analyzer_errors(expected_msgs_);                      \
@@ -192,7 +192,7 @@ void i_ck_assert_modules_order(const struct RFstring *expected_module_names,
                 MESSAGE_SEMANTIC_ERROR,                                 \
                 expected_msg_, sl_, sc_, el_, ec_)                      \
         };                                                              \
-        ck_assert_msg(!compiler_preprocess_fronts(),                    \
+        ck_assert_msg(!compiler_preprocess_fronts(get_front_testdriver()->compiler), \
                       "Expected a modules cyclic dependency but no error detected at preprocess_fronts()"); \
         ck_assert_analyzer_errors(expected_msgs_);                      \
     } while (0)
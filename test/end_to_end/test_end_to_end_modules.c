@@ -3,8 +3,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <dirent.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <llvm-c/Core.h>
+#include <llvm-c/BitWriter.h>
+
 #include <String/rf_str_core.h>
 #include <ast/ast.h>
+#include <compiler_cache.h>
+#include <front_ctx.h>
+#include <module.h>
+#include <utils/common_strings.h>
 
 #include "testsupport_end_to_end.h"
 
@@ -27,6 +38,284 @@ START_TEST (test_smoke_module_inclusion) {
     ck_end_to_end_run(inputs, 42);
 } END_TEST
 
+START_TEST (test_modules_link_with_shared_stdlib_and_literals) {
+    // each module gets its own LLVM module. Linking them should keep a
+    // single stdlib and merge the literals that both modules define.
+    struct test_input_pair inputs[] = {
+        TEST_DECL_SRC(
+            "main.rf",
+            "import other\n"
+            "fn main()->u32{\n"
+            "print(\"shared\")\n"
+            "return 42\n"
+            "}"
+        ),
+        TEST_DECL_SRC(
+            "other.rf",
+
+            "module other {\n"
+            "fn helper()->u32{\n"
+            "print(\"shared\")\n"
+            "return 1\n"
+            "}\n"
+            "}"
+        )
+    };
+    static const struct RFstring output = RF_STRING_STATIC_INIT("shared");
+    ck_end_to_end_run(inputs, 42, &output);
+} END_TEST
+
+static void remove_cache_dir(const char *dir)
+{
+    char path[512];
+    struct dirent *entry;
+    DIR *d = opendir(dir);
+    if (!d) {
+        return;
+    }
+    while ((entry = readdir(d))) {
+        if (entry->d_name[0] != '.') {
+            snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+            remove(path);
+        }
+    }
+    closedir(d);
+    rmdir(dir);
+}
+
+START_TEST (test_cached_rebuild_skips_front_end) {
+    struct test_input_pair inputs[] = {
+        TEST_DECL_SRC(
+            "main.rf",
+            "import other\n"
+            "fn main()->u32{return 42}"
+        ),
+        TEST_DECL_SRC(
+            "other.rf",
+
+            "module other {\n"
+            "}"
+        )
+    };
+    struct end_to_end_driver *d = get_end_to_end_driver();
+    struct front_ctx *front;
+    int ret;
+    ck_assert_msg(end_to_end_create_files(PASS_SRC_ARR(inputs)),
+                  "Could not create input file/s");
+    // the driver frees a single extra argument so it can't be a literal
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), strdup("--cache-dir=refu_test_cache")),
+                  "Could not compile the input file/s");
+
+    // compile the same sources again with a fresh compiler
+    compiler_destroy(d->compiler);
+    d->compiler = compiler_create(LOG_TARGET_STDOUT, true);
+    ck_assert_msg(d->compiler, "failed to create the compiler instance");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), strdup("--cache-dir=refu_test_cache")),
+                  "Could not recompile the input file/s");
+
+    // nothing should have been scanned, parsed or analyzed
+    rf_ilist_for_each(&d->compiler->front_ctxs, front, ln) {
+        ck_assert_msg(!front->root, "A front was parsed in a cached rebuild");
+    }
+    ck_assert_uint_eq(darray_size(d->compiler->modules), 0);
+
+    ck_assert_msg(end_to_end_run(&ret, NULL), "Failed to execute driver's compiled result");
+    ck_assert_int_eq(ret, 42);
+
+    remove_cache_dir("refu_test_cache");
+} END_TEST
+
+START_TEST (test_cached_rebuild_reuses_unchanged_modules) {
+    struct test_input_pair inputs[] = {
+        TEST_DECL_SRC(
+            "main.rf",
+            "import other\n"
+            "fn main()->u32{return 42}"
+        ),
+        TEST_DECL_SRC(
+            "other.rf",
+
+            "module other {\n"
+            "}"
+        )
+    };
+    struct test_input_pair changed_inputs[] = {
+        TEST_DECL_SRC(
+            "main.rf",
+            "import other\n"
+            "fn main()->u32{return 43}"
+        ),
+        TEST_DECL_SRC(
+            "other.rf",
+
+            "module other {\n"
+            "}"
+        )
+    };
+    struct end_to_end_driver *d = get_end_to_end_driver();
+    int ret;
+    ck_assert_msg(end_to_end_create_files(PASS_SRC_ARR(inputs)),
+                  "Could not create input file/s");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), strdup("--cache-dir=refu_test_cache")),
+                  "Could not compile the input file/s");
+    ck_assert_uint_eq(d->compiler->cache.module_hits, 0);
+
+    // change only the main module and compile again with a fresh compiler
+    compiler_destroy(d->compiler);
+    d->compiler = compiler_create(LOG_TARGET_STDOUT, true);
+    ck_assert_msg(d->compiler, "failed to create the compiler instance");
+    ck_assert_msg(end_to_end_create_files(PASS_SRC_ARR(changed_inputs)),
+                  "Could not create input file/s");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(changed_inputs), strdup("--cache-dir=refu_test_cache")),
+                  "Could not recompile the input file/s");
+
+    // only the LLVM code of module other should have come from the cache
+    ck_assert_uint_eq(d->compiler->cache.module_hits, 1);
+
+    ck_assert_msg(end_to_end_run(&ret, NULL), "Failed to execute driver's compiled result");
+    ck_assert_int_eq(ret, 43);
+
+    remove_cache_dir("refu_test_cache");
+} END_TEST
+
+START_TEST (test_reset_compiler_keeps_stdlib) {
+    struct test_input_pair inputs[] = {
+        TEST_DECL_SRC(
+            "main.rf",
+            "import other\n"
+            "fn main()->u32{return 42}"
+        ),
+        TEST_DECL_SRC(
+            "other.rf",
+
+            "module other {\n"
+            "}"
+        )
+    };
+    struct end_to_end_driver *d = get_end_to_end_driver();
+    struct front_ctx *stdlib_front;
+    struct module *stdlib_module;
+    int ret;
+    ck_assert_msg(end_to_end_create_files(PASS_SRC_ARR(inputs)),
+                  "Could not create input file/s");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), NULL),
+                  "Could not compile the input file/s");
+    stdlib_front = d->compiler->stdlib_front;
+    ck_assert(stdlib_front);
+    stdlib_module = darray_item(d->compiler->modules, 0);
+    ck_assert(stdlib_module->front == stdlib_front);
+
+    // compile again with the same compiler, as a compiler server would
+    ck_assert(compiler_reset(d->compiler, true));
+    ck_assert(stdlib_front->retained);
+    ck_assert_uint_eq(darray_size(d->compiler->modules), 1);
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), NULL),
+                  "Could not recompile the input file/s");
+
+    // the stdlib should not have been processed again
+    ck_assert(d->compiler->stdlib_front == stdlib_front);
+    ck_assert(darray_item(d->compiler->modules, 0) == stdlib_module);
+    ck_assert_uint_eq(darray_size(d->compiler->modules), 3);
+
+    ck_assert_msg(end_to_end_run(&ret, NULL), "Failed to execute driver's compiled result");
+    ck_assert_int_eq(ret, 42);
+} END_TEST
+
+START_TEST (test_reset_compiler_clears_identifiers) {
+    struct test_input_pair inputs[] = {
+        TEST_DECL_SRC(
+            "main.rf",
+            "import other\n"
+            "fn main()->u32{return 42}"
+        ),
+        TEST_DECL_SRC(
+            "other.rf",
+
+            "module other {\n"
+            "}"
+        )
+    };
+    struct end_to_end_driver *d = get_end_to_end_driver();
+    int ret;
+    ck_assert_msg(end_to_end_create_files(PASS_SRC_ARR(inputs)),
+                  "Could not create input file/s");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), NULL),
+                  "Could not compile the input file/s");
+
+    // without the stdlib only the main module's name should remain interned
+    ck_assert(compiler_reset(d->compiler, false));
+    ck_assert_uint_eq(string_interner_size(&d->compiler->identifiers), 1);
+    ck_assert_uint_eq(string_interner_get_id(&d->compiler->identifiers, &g_str_main),
+                      d->compiler->main_name_id);
+
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), NULL),
+                  "Could not recompile the input file/s");
+    ck_assert_msg(end_to_end_run(&ret, NULL), "Failed to execute driver's compiled result");
+    ck_assert_int_eq(ret, 42);
+} END_TEST
+
+START_TEST (test_stale_stdlib_image_is_regenerated) {
+    struct test_input_pair inputs[] = {
+        TEST_DECL_SRC(
+            "main.rf",
+            "fn main()->u32{\n"
+            "print(\"image\")\n"
+            "return 42\n"
+            "}"
+        )
+    };
+    static const struct RFstring output = RF_STRING_STATIC_INIT("image");
+    struct end_to_end_driver *d = get_end_to_end_driver();
+    LLVMModuleRef stale;
+    LLVMValueRef stamp;
+    int ret;
+    ck_assert_msg(end_to_end_create_files(PASS_SRC_ARR(inputs)),
+                  "Could not create input file/s");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), strdup("--emit-stdlib-image=refu_test_stdlib.bc")),
+                  "Could not emit the stdlib image");
+
+    // a freshly emitted image should be used instead of the stdlib's RIR
+    compiler_destroy(d->compiler);
+    d->compiler = compiler_create(LOG_TARGET_STDOUT, true);
+    ck_assert_msg(d->compiler, "failed to create the compiler instance");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), strdup("--stdlib-image=refu_test_stdlib.bc")),
+                  "Could not compile the input file/s");
+    ck_assert_msg(d->compiler->stdlib_image, "The emitted stdlib image was not used");
+    ck_assert_msg(end_to_end_run(&ret, &output), "Failed to execute driver's compiled result");
+    ck_assert_int_eq(ret, 42);
+
+    // replace the image with one whose stamp does not match. It has no
+    // functions so the program could not link if it was used.
+    stale = LLVMModuleCreateWithName("stdlib");
+    stamp = LLVMMDString("0.0.0 stale", strlen("0.0.0 stale"));
+    LLVMAddNamedMetadataOperand(stale, "refu.stdlib.stamp", LLVMMDNode(&stamp, 1));
+    ck_assert(LLVMWriteBitcodeToFile(stale, "refu_test_stdlib.bc") == 0);
+    LLVMDisposeModule(stale);
+
+    compiler_destroy(d->compiler);
+    d->compiler = compiler_create(LOG_TARGET_STDOUT, true);
+    ck_assert_msg(d->compiler, "failed to create the compiler instance");
+    ck_assert_msg(end_to_end_compile(PASS_SRC_ARR(inputs), strdup("--stdlib-image=refu_test_stdlib.bc")),
+                  "Could not compile the input file/s");
+    ck_assert_msg(!d->compiler->stdlib_image, "A stale stdlib image was used");
+    ck_assert_msg(end_to_end_run(&ret, &output), "Failed to execute driver's compiled result");
+    ck_assert_int_eq(ret, 42);
+
+    unlink("refu_test_stdlib.bc");
+} END_TEST
+
+START_TEST (test_destroying_compiler_keeps_current_one) {
+    struct end_to_end_driver *d = get_end_to_end_driver();
+    struct compiler *other = compiler_create(LOG_TARGET_STDOUT, true);
+    ck_assert_msg(other, "failed to create the compiler instance");
+    ck_assert(compiler_instance_get() == other);
+
+    // destroying another compiler should leave the current one bound
+    compiler_destroy(d->compiler);
+    ck_assert(compiler_instance_get() == other);
+    d->compiler = other;
+} END_TEST
+
 Suite *end_to_end_module_suite_create(void)
 {
     Suite *s = suite_create("end_to_end_module");
@@ -36,6 +325,13 @@ Suite *end_to_end_module_suite_create(void)
                               setup_end_to_end_tests,
                               teardown_end_to_end_tests);
     tcase_add_test(st_basic, test_smoke_module_inclusion);
+    tcase_add_test(st_basic, test_modules_link_with_shared_stdlib_and_literals);
+    tcase_add_test(st_basic, test_cached_rebuild_skips_front_end);
+    tcase_add_test(st_basic, test_cached_rebuild_reuses_unchanged_modules);
+    tcase_add_test(st_basic, test_reset_compiler_keeps_stdlib);
+    tcase_add_test(st_basic, test_reset_compiler_clears_identifiers);
+    tcase_add_test(st_basic, test_stale_stdlib_image_is_regenerated);
+    tcase_add_test(st_basic, test_destroying_compiler_keeps_current_one);
     
     suite_add_tcase(s, st_basic);
 
@@ -131,7 +131,7 @@ bool end_to_end_driver_compile(struct end_to_end_driver *d,
     }
 
     // + 1 is for the initial argument of the executable name
-    if (!compiler_pass_args(args_num, args_cstrings)) {
+    if (!compiler_pass_args(d->compiler, args_num, args_cstrings)) {
         goto free_cstrings_arr;
     }
 
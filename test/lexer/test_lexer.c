@@ -1,10 +1,14 @@
 #include <check.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <String/rf_str_core.h>
 #include <lexer/lexer.h>
+#include <ast/constants.h>
+#include <utils/string_interner.h>
 
 #include "../testsupport_front.h"
 #include "testsupport_lexer.h"
@@ -19,7 +23,7 @@ START_TEST(test_lexer_scan_tokens_1) {
     front = front_testdriver_new_main_source(&s);
     ck_assert_msg(front, "Failed to assign string to file ");
     f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_IDENTIFIER_INIT(0, 0, 0, 2, "asd"),
         {
             .type=TOKEN_SM_OCBRACE,
@@ -62,7 +66,7 @@ START_TEST(test_lexer_scan_tokens_2) {
     front = front_testdriver_new_main_source(&s);
     ck_assert_msg(front, "Failed to assign string to file ");
     struct inpfile *f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         {
             .type=TOKEN_KW_TYPE,
             .location=LOC_INIT(f, 0, 0, 0, 3)
@@ -229,7 +233,7 @@ START_TEST(test_lexer_scan_tokens_crammed) {
         "food<>||");
     front_testdriver_new_main_source(&s);
     f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_IDENTIFIER_INIT(0, 0, 0, 3, "food"),
         {
             .type=TOKEN_OP_LT,
@@ -249,6 +253,63 @@ START_TEST(test_lexer_scan_tokens_crammed) {
 
 } END_TEST
 
+START_TEST(test_lexer_scan_tokens_longest_match) {
+    struct inpfile *f;
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "!=->=>==&&&++-|||=");
+    front_testdriver_new_main_source(&s);
+    f = front_testdriver_file();
+    struct testlex_token expected[] = {
+        {
+            .type=TOKEN_OP_NEQ,
+            .location=LOC_INIT(f, 0, 0, 0, 1)
+        },
+        {
+            .type=TOKEN_OP_IMPL,
+            .location=LOC_INIT(f, 0, 2, 0, 3)
+        },
+        {
+            .type=TOKEN_SM_THICKARROW,
+            .location=LOC_INIT(f, 0, 4, 0, 5)
+        },
+        {
+            .type=TOKEN_OP_EQ,
+            .location=LOC_INIT(f, 0, 6, 0, 7)
+        },
+        {
+            .type=TOKEN_OP_LOGIC_AND,
+            .location=LOC_INIT(f, 0, 8, 0, 9)
+        },
+        {
+            .type=TOKEN_OP_AMPERSAND,
+            .location=LOC_INIT(f, 0, 10, 0, 10)
+        },
+        {
+            .type=TOKEN_OP_INC,
+            .location=LOC_INIT(f, 0, 11, 0, 12)
+        },
+        {
+            .type=TOKEN_OP_MINUS,
+            .location=LOC_INIT(f, 0, 13, 0, 13)
+        },
+        {
+            .type=TOKEN_OP_LOGIC_OR,
+            .location=LOC_INIT(f, 0, 14, 0, 15)
+        },
+        {
+            .type=TOKEN_OP_TYPESUM,
+            .location=LOC_INIT(f, 0, 16, 0, 16)
+        },
+        {
+            .type=TOKEN_OP_ASSIGN,
+            .location=LOC_INIT(f, 0, 17, 0, 17)
+        }
+    };
+    ck_assert_lexer_scan("Scanning failed");
+    testsupport_lexer_check_tokens(expected);
+
+} END_TEST
+
 START_TEST(test_lexer_scan_constant_numbers) {
     static const struct RFstring s = RF_STRING_STATIC_INIT(
         "42\n"
@@ -263,7 +324,7 @@ START_TEST(test_lexer_scan_constant_numbers) {
         "-2.1234\n"
     );
     front_testdriver_new_main_source(&s);
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 1, 42),
         TESTLEX_FLOAT_INIT(1, 0, 1, 3, 3.14),
         TESTLEX_INTEGER_INIT(2, 0, 2, 6, 28),
@@ -288,7 +349,7 @@ START_TEST(test_lexer_scan_string_literals) {
         "\"Eleos そう思いながらも\"\n"
     );
     front_testdriver_new_main_source(&s);
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_LITERAL_INIT(0, 0, 0, 6, 0, 6,  "Celka"),
         TESTLEX_LITERAL_INIT(1, 0, 1, 31, 0, 31,
                              "Containing escaped \\\"\\\" quotes"),
@@ -309,7 +370,7 @@ START_TEST (test_lexer_scan_with_comments) {
     );
     front = front_testdriver_new_main_source(&s);
     ck_assert_msg(front, "Failed to assign string to file");
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 2, 234),
         TESTLEX_LITERAL_INIT(2, 0, 2, 15, 0, 15, "string_literal")
     };
@@ -319,12 +380,26 @@ START_TEST (test_lexer_scan_with_comments) {
 
 /* -- lexer scan edge cases tests -- */
 
+START_TEST(test_lexer_scan_comment_at_eof_without_newline) {
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "234 // a comment"
+    );
+    front_testdriver_new_main_source(&s);
+    // the last byte of a comment that ends the input is not part of it
+    struct testlex_token expected[] = {
+        TESTLEX_INTEGER_INIT(0, 0, 0, 2, 234),
+        TESTLEX_IDENTIFIER_INIT(0, 15, 0, 15, "t"),
+    };
+    ck_assert_lexer_scan("Scanning failed");
+    testsupport_lexer_check_tokens(expected);
+} END_TEST
+
 START_TEST(test_lexer_scan_identifier_at_end) {
     struct inpfile *f;
     static const struct RFstring s = RF_STRING_STATIC_INIT("<Type a bbb");
     front_testdriver_new_main_source(&s);
     f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         {
             .type=TOKEN_OP_LT,
             .location=LOC_INIT(f, 0, 0, 0, 0),
@@ -345,7 +420,7 @@ START_TEST(test_lexer_scan_problematic_typeclass) {
         "}");
     front_testdriver_new_main_source(&s);
     f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         {
             .type=TOKEN_KW_TYPECLASS,
             .location=LOC_INIT(f, 0, 0, 0, 4),
@@ -377,7 +452,7 @@ START_TEST(test_lexer_scan_problematic_typeclass) {
 START_TEST(test_lexer_scan_constant_int_at_end) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("13 2462");
     front_testdriver_new_main_source(&s);
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 1, 13),
         TESTLEX_INTEGER_INIT(0, 3, 0, 6, 2462),
     };
@@ -388,7 +463,7 @@ START_TEST(test_lexer_scan_constant_int_at_end) {
 START_TEST(test_lexer_scan_constant_float_at_end) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("13 0.142");
     front_testdriver_new_main_source(&s);
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 1, 13),
         TESTLEX_FLOAT_INIT(0, 3, 0, 7, 0.142),
     };
@@ -399,7 +474,7 @@ START_TEST(test_lexer_scan_constant_float_at_end) {
 START_TEST(test_lexer_scan_string_literal_at_end) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("21 \"Berlin\"");
     front_testdriver_new_main_source(&s);
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 1, 21),
         TESTLEX_LITERAL_INIT(0, 3, 0, 10, 3, 10, "Berlin"),
     };
@@ -411,7 +486,7 @@ START_TEST(test_lexer_scan_integer_with_tokens_in_between) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("10|&{23");
     front_testdriver_new_main_source(&s);
     struct inpfile *f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 1, 10),
         {
             .type=TOKEN_OP_TYPESUM,
@@ -435,7 +510,7 @@ START_TEST(test_lexer_scan_float_with_tokens_in_between) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("5.3134|&{23");
     front_testdriver_new_main_source(&s);
     struct inpfile *f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_FLOAT_INIT(0, 0, 0, 5, 5.3134),
         {
             .type=TOKEN_OP_TYPESUM,
@@ -459,7 +534,7 @@ START_TEST(test_lexer_scan_integer_close_to_member_access) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("10).something_else");
     front_testdriver_new_main_source(&s);
     struct inpfile *f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 1, 10),
         {
             .type=TOKEN_SM_CPAREN,
@@ -480,7 +555,7 @@ START_TEST(test_lexer_scan_zero_at_eof) {
         "0"
     );
     front_testdriver_new_main_source(&s);
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         TESTLEX_INTEGER_INIT(0, 0, 0, 0, 0),
     };
     ck_assert_lexer_scan("Scanning failed");
@@ -492,7 +567,7 @@ START_TEST(test_lexer_push_pop) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("if a < 2 { }");
     front_testdriver_new_main_source(&s);
     struct inpfile *f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         {
             .type=TOKEN_KW_IF,
             .location=LOC_INIT(f, 0, 0, 0, 1)
@@ -539,7 +614,7 @@ START_TEST(test_lexer_push_rollback) {
     static const struct RFstring s = RF_STRING_STATIC_INIT("if a < 2 { }");
     front_testdriver_new_main_source(&s);
     struct inpfile *f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         {
             .type=TOKEN_KW_IF,
             .location=LOC_INIT(f, 0, 0, 0, 1)
@@ -584,12 +659,165 @@ START_TEST(test_lexer_push_rollback) {
     ck_assert_msg(!tok, "Last token should be NULL");
 } END_TEST
 
+START_TEST(test_lexer_token_value_after_rollback) {
+    static const struct RFstring s = RF_STRING_STATIC_INIT("a 42 b");
+    front_testdriver_new_main_source(&s);
+    ck_assert_lexer_scan("Scanning failed");
+
+    struct lexer *lex = front_testdriver_lexer();
+    lexer_push(lex);
+    struct token *tok_a = lexer_next_token(lex);
+    struct token *tok_42 = lexer_next_token(lex);
+    ck_assert(tok_a && tok_42);
+    struct ast_node *a1 = lexer_token_get_value(lex, tok_a);
+    struct ast_node *c1 = lexer_token_get_value(lex, tok_42);
+    ck_assert(a1 && c1);
+    // a speculative parse failed. The parser frees what it created and rewinds
+    ast_node_destroy(a1);
+    ast_node_destroy(c1);
+    lexer_rollback(lex);
+
+    ck_assert(lexer_next_token(lex) == tok_a);
+    struct ast_node *a2 = lexer_token_get_value(lex, tok_a);
+    ck_assert(a2);
+    ck_assert_rf_str_eq_cstr(ast_identifier_str(a2), "a");
+    ast_node_destroy(a2);
+
+    ck_assert(lexer_next_token(lex) == tok_42);
+    struct ast_node *c2 = lexer_token_get_value(lex, tok_42);
+    int64_t v;
+    ck_assert(c2);
+    ck_assert(ast_constant_get_integer(&c2->constant, &v));
+    ck_assert_int_eq(v, 42);
+    ast_node_destroy(c2);
+} END_TEST
+
+START_TEST(test_lexer_interns_identifiers) {
+    static const struct RFstring s = RF_STRING_STATIC_INIT("foo bar foo");
+    front_testdriver_new_main_source(&s);
+    ck_assert_lexer_scan("Scanning failed");
+
+    struct lexer *lex = front_testdriver_lexer();
+    struct token *foo1 = lexer_lookahead(lex, 1);
+    struct token *bar = lexer_lookahead(lex, 2);
+    struct token *foo2 = lexer_lookahead(lex, 3);
+    ck_assert(foo1 && bar && foo2);
+    ck_assert_uint_eq(foo1->value_idx, foo2->value_idx);
+    ck_assert_uint_ne(foo1->value_idx, bar->value_idx);
+    ck_assert_rf_str_eq_cstr(
+        string_interner_str(lex->identifiers, foo1->value_idx), "foo");
+    ck_assert_rf_str_eq_cstr(
+        string_interner_str(lex->identifiers, bar->value_idx), "bar");
+
+    struct ast_node *id = lexer_token_get_value(lex, foo2);
+    ck_assert(id);
+    ck_assert_uint_eq(ast_identifier_id(id), foo1->value_idx);
+    ck_assert_uint_eq(ast_identifier_hash(id),
+                      string_interner_hash(lex->identifiers, foo1->value_idx));
+    ast_node_destroy(id);
+} END_TEST
+
+#define INTERNER_KNOWN_STRINGS 64
+#define INTERNER_ADDED_STRINGS 20000
+#define INTERNER_READERS 4
+struct interner_reader_ctx {
+    struct string_interner *in;
+    const uint32_t *known_ids;
+    bool *done;
+    bool success;
+};
+
+static void *interner_reader(void *arg)
+{
+    struct interner_reader_ctx *ctx = arg;
+    char buff[32];
+    struct RFstring s;
+    unsigned int i;
+    ctx->success = true;
+    while (!__atomic_load_n(ctx->done, __ATOMIC_ACQUIRE)) {
+        for (i = 0; i < INTERNER_KNOWN_STRINGS; ++i) {
+            RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "known%u", i));
+            if (string_interner_get_id(ctx->in, &s) != ctx->known_ids[i]) {
+                ctx->success = false;
+            }
+        }
+    }
+    return NULL;
+}
+
+START_TEST(test_string_interner_lookups_while_growing) {
+    struct string_interner in;
+    uint32_t known_ids[INTERNER_KNOWN_STRINGS];
+    struct interner_reader_ctx readers[INTERNER_READERS];
+    pthread_t threads[INTERNER_READERS];
+    bool done = false;
+    char buff[32];
+    struct RFstring s;
+    unsigned int i;
+
+    ck_assert(string_interner_init(&in));
+    for (i = 0; i < INTERNER_KNOWN_STRINGS; ++i) {
+        RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "known%u", i));
+        known_ids[i] = string_interner_add(&in, &s);
+        ck_assert_uint_ne(known_ids[i], STRING_INTERNER_INVALID_ID);
+    }
+    for (i = 0; i < INTERNER_READERS; ++i) {
+        readers[i].in = &in;
+        readers[i].known_ids = known_ids;
+        readers[i].done = &done;
+        ck_assert(0 == pthread_create(&threads[i], NULL, interner_reader, &readers[i]));
+    }
+    // the lookup table is replaced several times while the readers run
+    for (i = 0; i < INTERNER_ADDED_STRINGS; ++i) {
+        RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "added%u", i));
+        ck_assert_uint_eq(string_interner_add(&in, &s), INTERNER_KNOWN_STRINGS + i);
+    }
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    for (i = 0; i < INTERNER_READERS; ++i) {
+        pthread_join(threads[i], NULL);
+        ck_assert(readers[i].success);
+    }
+
+    ck_assert_uint_eq(string_interner_size(&in),
+                      INTERNER_KNOWN_STRINGS + INTERNER_ADDED_STRINGS);
+    for (i = 0; i < INTERNER_ADDED_STRINGS; ++i) {
+        RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "added%u", i));
+        ck_assert_uint_eq(string_interner_get_id(&in, &s), INTERNER_KNOWN_STRINGS + i);
+    }
+    RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "never_added"));
+    ck_assert_uint_eq(string_interner_get_id(&in, &s), STRING_INTERNER_INVALID_ID);
+    string_interner_deinit(&in);
+} END_TEST
+
+START_TEST(test_string_interner_clear) {
+    struct string_interner in;
+    char buff[32];
+    struct RFstring s;
+    unsigned int i;
+
+    ck_assert(string_interner_init(&in));
+    for (i = 0; i < INTERNER_ADDED_STRINGS; ++i) {
+        RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "added%u", i));
+        ck_assert_uint_ne(string_interner_add(&in, &s), STRING_INTERNER_INVALID_ID);
+    }
+    string_interner_clear(&in);
+    ck_assert_uint_eq(string_interner_size(&in), 0);
+    RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "added0"));
+    ck_assert_uint_eq(string_interner_get_id(&in, &s), STRING_INTERNER_INVALID_ID);
+
+    // IDs start again from zero
+    RF_STRING_SHALLOW_INIT(&s, buff, sprintf(buff, "after_clear"));
+    ck_assert_uint_eq(string_interner_add(&in, &s), 0);
+    ck_assert_uint_eq(string_interner_get_id(&in, &s), 0);
+    string_interner_deinit(&in);
+} END_TEST
+
 START_TEST(test_lexer_many_push_rollback) {
 
     static const struct RFstring s = RF_STRING_STATIC_INIT("if a < 2 { }");
     front_testdriver_new_main_source(&s);
     struct inpfile *f = front_testdriver_file();
-    struct token expected[] = {
+    struct testlex_token expected[] = {
         {
             .type=TOKEN_KW_IF,
             .location=LOC_INIT(f, 0, 0, 0, 1)
@@ -650,6 +878,7 @@ Suite *lexer_suite_create(void)
     tcase_add_test(scan, test_lexer_scan_tokens_1);
     tcase_add_test(scan, test_lexer_scan_tokens_2);
     tcase_add_test(scan, test_lexer_scan_tokens_crammed);
+    tcase_add_test(scan, test_lexer_scan_tokens_longest_match);
     tcase_add_test(scan, test_lexer_scan_constant_numbers);
     tcase_add_test(scan, test_lexer_scan_string_literals);
     tcase_add_test(scan, test_lexer_scan_with_comments);
@@ -659,6 +888,7 @@ Suite *lexer_suite_create(void)
                               setup_front_tests,
                               teardown_front_tests);
     tcase_add_test(scan_edge, test_lexer_scan_identifier_at_end);
+    tcase_add_test(scan_edge, test_lexer_scan_comment_at_eof_without_newline);
     tcase_add_test(scan_edge, test_lexer_scan_problematic_typeclass);
     tcase_add_test(scan_edge, test_lexer_scan_constant_int_at_end);
     tcase_add_test(scan_edge, test_lexer_scan_constant_float_at_end);
@@ -675,6 +905,10 @@ Suite *lexer_suite_create(void)
     tcase_add_test(lexer_utils, test_lexer_push_pop);
     tcase_add_test(lexer_utils, test_lexer_push_rollback);
     tcase_add_test(lexer_utils, test_lexer_many_push_rollback);
+    tcase_add_test(lexer_utils, test_lexer_token_value_after_rollback);
+    tcase_add_test(lexer_utils, test_lexer_interns_identifiers);
+    tcase_add_test(lexer_utils, test_string_interner_lookups_while_growing);
+    tcase_add_test(lexer_utils, test_string_interner_clear);
     
 
     suite_add_tcase(s, scan);
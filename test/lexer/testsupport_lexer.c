@@ -5,13 +5,15 @@
 #include <ast/constants.h>
 #include <ast/string_literal.h>
 
-bool test_tokens_cmp(struct token *expected,
+bool test_tokens_cmp(struct testlex_token *expected,
                      struct token *got,
                      unsigned int index,
-                     struct inpfile *f,
+                     struct lexer *l,
                      const char *filename,
                      unsigned int line)
 {
+    struct ast_node *got_value;
+    struct inpfile *f = l->file;
 
     if (expected->type != got->type) {
         ck_lexer_abort(filename, line, "Expected the %d token to be of type "
@@ -21,34 +23,40 @@ bool test_tokens_cmp(struct token *expected,
         return false;
     }
 
-    if (!inplocation_equal(token_get_loc(expected), token_get_loc(got))) {
+    if (!inplocation_equal(&expected->location, token_get_loc(got))) {
         ck_lexer_abort(filename, line,
                        "Expected token %d to have location:\n"
                        INPLOCATION_FMT2"\nbut it has location:\n"
                        INPLOCATION_FMT2, index,
-                       INPLOCATION_ARG2(f, token_get_loc(expected)),
+                       INPLOCATION_ARG2(f, &expected->location),
                        INPLOCATION_ARG2(f, token_get_loc(got)));
         return false;
     }
 
+    if (!token_has_value(got)) {
+        return true;
+    }
+    // value nodes are created lazily, so create one just for the comparison
+    got_value = lexer_token_get_value(l, got);
+    ck_assert_msg(got_value, "Could not create the value of token %d", index);
 
     if (expected->type == TOKEN_IDENTIFIER &&
         !rf_string_equal(
-            ast_identifier_str(expected->value.v),
-            ast_identifier_str(got->value.v))) {
+            ast_identifier_str(expected->value),
+            ast_identifier_str(got_value))) {
         ck_lexer_abort(
             filename, line,
             "Expected the %d token to have value:\n"
             RF_STR_PF_FMT"\nbut it has value:\n"
             RF_STR_PF_FMT, index,
-            RF_STR_PF_ARG(ast_identifier_str(expected->value.v)),
-            RF_STR_PF_ARG(ast_identifier_str(got->value.v)));
+            RF_STR_PF_ARG(ast_identifier_str(expected->value)),
+            RF_STR_PF_ARG(ast_identifier_str(got_value)));
         return false;
     } else if (expected->type == TOKEN_CONSTANT_INTEGER) {
         int64_t expect_v;
         int64_t got_v;
-        ck_assert(ast_constant_get_integer(&expected->value.v->constant, &expect_v));
-        ck_assert(ast_constant_get_integer(&got->value.v->constant, &got_v));
+        ck_assert(ast_constant_get_integer(&expected->value->constant, &expect_v));
+        ck_assert(ast_constant_get_integer(&got_value->constant, &got_v));
         if (expect_v != got_v) {
                 ck_lexer_abort(
                     filename, line,
@@ -60,8 +68,8 @@ bool test_tokens_cmp(struct token *expected,
     } else if (expected->type == TOKEN_CONSTANT_FLOAT) {
         double expect_v;
         double got_v;
-        ck_assert(ast_constant_get_float(&expected->value.v->constant, &expect_v));
-        ck_assert(ast_constant_get_float(&got->value.v->constant, &got_v));
+        ck_assert(ast_constant_get_float(&expected->value->constant, &expect_v));
+        ck_assert(ast_constant_get_float(&got_value->constant, &got_v));
         if (!DBLCMP_EQ(expect_v, got_v)) {
                 ck_lexer_abort(
                     filename, line,
@@ -72,24 +80,25 @@ bool test_tokens_cmp(struct token *expected,
         }
     } else if (expected->type == TOKEN_STRING_LITERAL &&
                !rf_string_equal(
-                   ast_string_literal_get_str(expected->value.v),
-                   ast_string_literal_get_str(got->value.v))) {
+                   ast_string_literal_get_str(expected->value),
+                   ast_string_literal_get_str(got_value))) {
 
         ck_lexer_abort(
             filename, line,
             "Expected the %d string literal token to have value:\n"
             "\""RF_STR_PF_FMT"\"\nbut it has value:\n"
             "\""RF_STR_PF_FMT"\"", index,
-            RF_STR_PF_ARG(ast_string_literal_get_str(expected->value.v)),
-            RF_STR_PF_ARG(ast_string_literal_get_str(got->value.v)));
+            RF_STR_PF_ARG(ast_string_literal_get_str(expected->value)),
+            RF_STR_PF_ARG(ast_string_literal_get_str(got_value)));
     }
 
+    ast_node_destroy(got_value);
     return true;
 }
 
 
 void check_lexer_tokens_impl(struct lexer *l,
-                             struct token *tokens,
+                             struct testlex_token *tokens,
                              unsigned num,
                              const char *filename,
                              unsigned int line)
@@ -103,7 +112,7 @@ void check_lexer_tokens_impl(struct lexer *l,
 
 
     darray_foreach(t, l->tokens) {
-        test_tokens_cmp(&tokens[i], t, i, l->file, filename, line);
+        test_tokens_cmp(&tokens[i], t, i, l, filename, line);
         i ++;
     }
 }
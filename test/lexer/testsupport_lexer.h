@@ -5,11 +5,20 @@
 #include <stdbool.h>
 #include <check.h>
 
+/**
+ * An expected token along with the value node it should produce, if any
+ */
+struct testlex_token {
+    enum token_type type;
+    struct inplocation location;
+    struct ast_node *value;
+};
+
 #define TESTLEX_IDENTIFIER_INIT(sl_, sc_, el_, ec_,  val_)              \
     {                                                                   \
         .type=TOKEN_IDENTIFIER,                                         \
         .location=LOC_INIT(front_testdriver_file(), sl_, sc_, el_, ec_), \
-        .value.v=                                                       \
+        .value=                                                         \
         front_testdriver_generate_identifier(sl_, sc_, el_, ec_, val_)  \
     }
 
@@ -17,7 +26,7 @@
     {                                                                   \
         .type=TOKEN_CONSTANT_INTEGER,                                   \
         .location=LOC_INIT(front_testdriver_file(), sl_, sc_, el_, ec_), \
-        .value.v=                                                       \
+        .value=                                                         \
         front_testdriver_generate_constant_integer(sl_, sc_, el_, ec_, val_) \
     }
 
@@ -25,7 +34,7 @@
     {                                                                   \
         .type=TOKEN_CONSTANT_FLOAT,                                     \
         .location=LOC_INIT(front_testdriver_file(), sl_, sc_, el_, ec_), \
-        .value.v=                                                       \
+        .value=                                                         \
         front_testdriver_generate_constant_float(sl_, sc_, el_, ec_, val_) \
     }
 
@@ -45,10 +54,10 @@
     {                                                                   \
         .type=TOKEN_STRING_LITERAL,                                     \
         .location=LOC_INIT_FULL(                                        \
-            sl_, sc_, el_, ec_,                                         \
+            front_testdriver_file(),                                    \
             inpfile_line_p(front_testdriver_file(), sl_) + sp_,         \
             inpfile_line_p(front_testdriver_file(), el_) + ep_),        \
-        .value.v=                                                       \
+        .value=                                                         \
         front_testdriver_generate_string_literal(sl_, sc_, el_, ec_, sp_, ep_, val_) \
     }
 
@@ -58,11 +67,11 @@
 
 #define testsupport_lexer_check_tokens( tokens_)                    \
     check_lexer_tokens_impl(front_testdriver_lexer(), (tokens_),    \
-                            sizeof(tokens_)/sizeof(struct token),   \
+                            sizeof(tokens_)/sizeof(struct testlex_token), \
                             __FILE__, __LINE__)
 
 void check_lexer_tokens_impl(struct lexer *l,
-                             struct token *tokens,
+                             struct testlex_token *tokens,
                              unsigned num,
                              const char *filename,
                              unsigned int line);
@@ -80,14 +89,14 @@ void check_lexer_tokens_impl(struct lexer *l,
         }                                                               \
     } while(0)
 
-bool test_tokens_cmp(struct token *expected,
+bool test_tokens_cmp(struct testlex_token *expected,
                      struct token *got,
                      unsigned int index,
-                     struct inpfile *f,
+                     struct lexer *l,
                      const char *filename,
                      unsigned int line);
 
 #define ck_assert_tokens_eq(lexer_, expected_, got_, index_)            \
-    test_tokens_cmp((expected_), (got_), index_, (lexer_)->file, __FILE__, __LINE__)
+    test_tokens_cmp((expected_), (got_), index_, (lexer_), __FILE__, __LINE__)
 
 #endif
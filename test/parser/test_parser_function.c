@@ -1,4 +1,5 @@
 #include <check.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -601,6 +602,34 @@ START_TEST (test_acc_fnimpl_no_braces) {
     ast_node_destroy(fim);
 } END_TEST
 
+#define FAILED_FNCALL_ATTEMPTS 1000
+START_TEST(test_acc_fncall_failed_attempts_do_not_leak) {
+    int64_t before;
+    unsigned int i;
+    // an identifier that is not followed by '(' is how most expression
+    // factors fail to be function calls
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "foo + bar");
+    front_testdriver_new_main_source(&s);
+    struct parser *p = front_testdriver_parser();
+    struct lexer *l = front_testdriver_lexer();
+
+    ck_assert(lexer_scan(l));
+    ck_assert(!parser_acc_fncall(p, false));
+    ck_assert_uint_eq(lexer_curr_index(l), 0);
+
+    // every node created by a failed attempt should also be destroyed
+    before = ast_nodes_live();
+    for (i = 0; i < FAILED_FNCALL_ATTEMPTS; ++i) {
+        ck_assert(!parser_acc_fncall(p, false));
+    }
+    ck_assert(!parser_has_syntax_error(p));
+    ck_assert_msg(ast_nodes_live() == before,
+                  "%d failed function call attempts leaked %" PRId64 " ast nodes",
+                  FAILED_FNCALL_ATTEMPTS,
+                  ast_nodes_live() - before);
+}END_TEST
+
 Suite *parser_function_suite_create(void)
 {
     Suite *s = suite_create("parser_function");
@@ -631,6 +660,7 @@ Suite *parser_function_suite_create(void)
     tcase_add_checked_fixture(fcall_f, setup_front_tests, teardown_front_tests);
     tcase_add_test(fcall_f, test_acc_fncall_err1);
     tcase_add_test(fcall_f, test_acc_fncall_err2);
+    tcase_add_test(fcall_f, test_acc_fncall_failed_attempts_do_not_leak);
 
     TCase *fimpl = tcase_create("parser_function_implementation");
     tcase_add_checked_fixture(fimpl, setup_front_tests, teardown_front_tests);
@@ -161,6 +161,54 @@ START_TEST (test_acc_import_statements_fail2) {
 
 } END_TEST
 
+START_TEST (test_parse_allocates_nodes_from_arena) {
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "fn foo() -> i32 { return 1 }\n");
+    front_testdriver_new_main_source(&s);
+    struct front_ctx *front = get_front_testdriver()->current_front;
+
+    ck_assert(front_ctx_parse(front));
+    ck_assert(front->root->in_arena);
+    ck_assert(ast_node_get_child(front->root, 0)->in_arena);
+    ck_assert(arena_allocations(&front->ast_arena) > 1);
+    ck_assert(arena_chunks(&front->ast_arena) >= 1);
+
+    // outside of parsing nodes are allocated as before
+    struct ast_node *id = testsupport_parser_identifier_create(0, 3, 0, 5);
+    ck_assert(!id->in_arena);
+    ast_node_destroy(id);
+} END_TEST
+
+START_TEST (test_ast_node_children_array) {
+    static const struct RFstring s = RF_STRING_STATIC_INIT("{ }");
+    front_testdriver_new_main_source(&s);
+    struct ast_node *children[100];
+    struct ast_node *child;
+    unsigned int i;
+
+    testsupport_parser_block_create(bnode, 0, 0, 0, 2);
+    for (i = 0; i < 100; ++i) {
+        children[i] = testsupport_parser_identifier_create(0, 0, 0, 0);
+        ast_node_add_child(bnode, children[i]);
+        ck_assert_uint_eq(ast_node_get_children_number(bnode), i + 1);
+    }
+    for (i = 0; i < 100; ++i) {
+        ck_assert(ast_node_get_child(bnode, i) == children[i]);
+    }
+    ck_assert(ast_node_get_child(bnode, 100) == NULL);
+    i = 0;
+    ast_node_foreach_child(bnode, child) {
+        ck_assert(child == children[i++]);
+    }
+    ck_assert_uint_eq(i, 100);
+
+    // leaf nodes only take the space they need
+    ck_assert(ast_node_size(AST_IDENTIFIER) < sizeof(struct ast_node));
+    ck_assert(ast_node_size(AST_CONSTANT) < sizeof(struct ast_node));
+
+    ast_node_destroy(bnode);
+} END_TEST
+
 Suite *parser_misc_suite_create(void)
 {
     Suite *s = suite_create("parser_misc");
@@ -173,6 +221,8 @@ Suite *parser_misc_suite_create(void)
 
     tcase_add_test(tc1, test_acc_import_statements_fail1);
     tcase_add_test(tc1, test_acc_import_statements_fail2);
+    tcase_add_test(tc1, test_parse_allocates_nodes_from_arena);
+    tcase_add_test(tc1, test_ast_node_children_array);
 
     suite_add_tcase(s, tc1);
     return s;
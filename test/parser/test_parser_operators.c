@@ -411,6 +411,36 @@ START_TEST(test_acc_operator_precedence_3) {
     ast_node_destroy(bop3);
 }END_TEST
 
+START_TEST(test_acc_operator_precedence_4) {
+    struct ast_node *n;
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "a - b - c * d == e");
+    front_testdriver_new_main_source(&s);
+
+    // a - b
+    struct ast_node *id_a = testsupport_parser_identifier_create(0, 0, 0, 0);
+    struct ast_node *id_b = testsupport_parser_identifier_create(0, 4, 0, 4);
+    testsupport_parser_node_create(bop1, binaryop, 0, 0, 0, 4,
+                                   BINARYOP_SUB, id_a, id_b);
+    // c * d
+    struct ast_node *id_c = testsupport_parser_identifier_create(0, 8, 0, 8);
+    struct ast_node *id_d = testsupport_parser_identifier_create(0, 12, 0, 12);
+    testsupport_parser_node_create(bop2, binaryop, 0, 8, 0, 12,
+                                   BINARYOP_MUL, id_c, id_d);
+    // a - b - c * d
+    testsupport_parser_node_create(bop3, binaryop, 0, 0, 0, 12,
+                                   BINARYOP_SUB, bop1, bop2);
+    // a - b - c * d == e
+    struct ast_node *id_e = testsupport_parser_identifier_create(0, 17, 0, 17);
+    testsupport_parser_node_create(bop4, binaryop, 0, 0, 0, 17,
+                                   BINARYOP_CMP_EQ, bop3, id_e);
+
+    ck_test_parse_as(n, expression, "binary operator", bop4);
+
+    ast_node_destroy(n);
+    ast_node_destroy(bop4);
+}END_TEST
+
 START_TEST(test_acc_subtract_negative_constant_literal) {
     struct ast_node *n;
     static const struct RFstring s = RF_STRING_STATIC_INIT(
@@ -447,6 +477,17 @@ START_TEST(test_acc_assign_negative_constant_literal) {
     ast_node_destroy(bop);
 }END_TEST
 
+START_TEST(test_binaryop_precedence_covers_all_operators) {
+    int op;
+    for (op = BINARYOP_ADD; op <= BINARYOP_COMMA; ++op) {
+        ck_assert_uint_ne(ast_binaryop_precedence(op), 0);
+    }
+    ck_assert_uint_lt(ast_binaryop_precedence(BINARYOP_ADD),
+                      ast_binaryop_precedence(BINARYOP_MUL));
+    ck_assert_uint_lt(ast_binaryop_precedence(BINARYOP_ASSIGN),
+                      ast_binaryop_precedence(BINARYOP_LOGIC_OR));
+}END_TEST
+
 Suite *parser_operators_suite_create(void)
 {
     Suite *s = suite_create("parser_operators");
@@ -476,8 +517,10 @@ Suite *parser_operators_suite_create(void)
     tcase_add_test(op_predence, test_acc_operator_precedence_1);
     tcase_add_test(op_predence, test_acc_operator_precedence_2);
     tcase_add_test(op_predence, test_acc_operator_precedence_3);
+    tcase_add_test(op_predence, test_acc_operator_precedence_4);
     tcase_add_test(op_predence, test_acc_subtract_negative_constant_literal);
     tcase_add_test(op_predence, test_acc_assign_negative_constant_literal);
+    tcase_add_test(op_predence, test_binaryop_precedence_covers_all_operators);
 
     suite_add_tcase(s, sbop);
     suite_add_tcase(s, cbop);
@@ -10,6 +10,7 @@
 #include <ast/type.h>
 #include <lexer/lexer.h>
 #include <info/msg.h>
+#include <utils/arena.h>
 
 #include "../testsupport_front.h"
 #include "testsupport_parser.h"
@@ -263,6 +264,48 @@ START_TEST(test_acc_typedesc_complex_right) {
     ast_node_destroy(t1);
 }END_TEST
 
+START_TEST(test_acc_typedesc_memoized) {
+    struct ast_node *n1;
+    struct ast_node *n2;
+    struct arena arena;
+    struct arena *prev_arena;
+    unsigned int end;
+    size_t allocations;
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "(a:i16 | b:(c:u8 -> f32)) )");
+    front_testdriver_new_main_source(&s);
+    struct parser *p = front_testdriver_parser();
+    struct lexer *l = front_testdriver_lexer();
+
+    // memoization is only allowed while nodes come from an arena
+    arena_init(&arena, 0);
+    prev_arena = ast_arena_set(&arena);
+    ck_assert(lexer_scan(l));
+    ck_assert(parser_memo_enable(p));
+
+    n1 = parser_acc_typedesc(p);
+    ck_assert(n1);
+    end = lexer_curr_index(l);
+    allocations = arena_allocations(&arena);
+
+    // parsing again at the same position gives the same subtree for free
+    lexer_set_index(l, 0);
+    n2 = parser_acc_typedesc(p);
+    ck_assert(n2 == n1);
+    ck_assert_uint_eq(lexer_curr_index(l), end);
+    ck_assert_uint_eq(arena_allocations(&arena), allocations);
+
+    // and failures are remembered too
+    ck_assert(!parser_acc_typedesc(p));
+    ck_assert(!parser_has_syntax_error(p));
+    ck_assert(!parser_acc_typedesc(p));
+    ck_assert_uint_eq(lexer_curr_index(l), end);
+
+    parser_memo_disable(p);
+    ast_arena_set(prev_arena);
+    arena_deinit(&arena);
+}END_TEST
+
 Suite *parser_typedesc_suite_create(void)
 {
     Suite *s = suite_create("parser_type_description");
@@ -290,6 +333,7 @@ Suite *parser_typedesc_suite_create(void)
     tcase_add_test(complex, test_acc_typedesc_sum_associativity);
     tcase_add_test(complex, test_acc_typedesc_sum_impl_associativity);
     tcase_add_test(complex, test_acc_typedesc_complex_right);
+    tcase_add_test(complex, test_acc_typedesc_memoized);
 
     suite_add_tcase(s, simple);
     suite_add_tcase(s, ops);
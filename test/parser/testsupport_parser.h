@@ -100,7 +100,7 @@ struct front_testdriver;
     struct ast_node *node_;                                             \
     do {                                                                \
         struct inplocation temp_location_ = LOC_INIT(get_front_testdriver()->current_front->file, sl_, sc_, el_, ec_); \
-        node_ = ast_string_literal_create(&temp_location_);             \
+        node_ = ast_string_literal_create(&temp_location_, get_front_testdriver()->current_front->file); \
         node_->state = AST_NODE_STATE_AFTER_PARSING;                    \
     } while (0)
 
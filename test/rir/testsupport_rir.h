@@ -27,7 +27,7 @@ void teardown_rir_tests();
 #define ck_assert_createrir_ok()                                        \
     do {                                                                \
         ck_assert_typecheck_ok();                                       \
-        if (!compiler_create_rir()) {                                   \
+        if (!compiler_create_rir(get_front_testdriver()->compiler)) { \
             testsupport_show_front_errors("Creating the RIR failed");   \
         }                                                               \
     } while(0)
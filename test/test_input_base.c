@@ -4,7 +4,9 @@
 #include <string.h>
 
 #include <String/rf_str_core.h>
+#include <System/rf_system.h>
 #include <ast/ast.h>
+#include <inpskip.h>
 
 #include "testsupport_front.h"
 
@@ -96,6 +98,148 @@ START_TEST(test_acc_ws_none_empty) {
     ck_assert_rf_str_eq_cstr(str, "");
 } END_TEST
 
+START_TEST(test_acc_ws_comments) {
+    struct inpfile *f;
+    struct front_ctx *front;
+    struct inpoffset *off;
+    struct RFstringx *str;
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        " // a comment\n\t//\n  // another\r\n/ asd");
+    front = front_testdriver_new_main_source(&s);
+    f = front->file;
+    ck_assert_msg(f, "Failed to assign string to file ");
+
+    inpfile_acc_ws_comments(f);
+    off = inpfile_offset(f);
+    ck_assert_inpoffset_eq(off, 32, 32, 3);
+    str = inpfile_str(f);
+    ck_assert_rf_str_eq_cstr(str, "/ asd");
+} END_TEST
+
+START_TEST(test_acc_ws_comment_at_eof) {
+    struct inpfile *f;
+    struct front_ctx *front;
+    struct inpoffset *off;
+    struct RFstringx *str;
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "\n  // no newline at the end");
+    front = front_testdriver_new_main_source(&s);
+    f = front->file;
+    ck_assert_msg(f, "Failed to assign string to file ");
+
+    inpfile_acc_ws_comments(f);
+    off = inpfile_offset(f);
+    ck_assert_inpoffset_eq(off, 27, 27, 1);
+    str = inpfile_str(f);
+    ck_assert_rf_str_eq_cstr(str, "");
+} END_TEST
+
+START_TEST(test_inpskip_matches_scalar) {
+    static const char alphabet[] = " \t\n\r//a";
+    char buff[256];
+    unsigned int i;
+    unsigned int n;
+    unsigned int round;
+    unsigned int lines;
+    unsigned int scalar_lines;
+    bool comments;
+    srand(42);
+    for (round = 0; round < 5000; ++round) {
+        n = rand() % sizeof(buff);
+        for (i = 0; i < n; ++i) {
+            buff[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+        }
+        for (i = 0; i < 2; ++i) {
+            comments = i == 1;
+            lines = scalar_lines = 0;
+            ck_assert(inpskip_ws(buff, buff + n, comments, &lines) ==
+                      inpskip_ws_scalar(buff, buff + n, comments, &scalar_lines));
+            ck_assert_uint_eq(lines, scalar_lines);
+        }
+        ck_assert_uint_eq(inpskip_count_newlines(buff, buff + n),
+                          inpskip_count_newlines_scalar(buff, buff + n));
+    }
+} END_TEST
+
+START_TEST(test_inpfile_mapped) {
+    struct inpfile *f;
+    struct RFstring line_str;
+    FILE *fp;
+    static const char *contents = "fn main()\n{\n    a = 1\n}\n";
+    static const struct RFstring name = RF_STRING_STATIC_INIT("test_mapped_input.rf");
+
+    fp = fopen("test_mapped_input.rf", "wb");
+    ck_assert_msg(fp, "Failed to create the test input file");
+    ck_assert_uint_eq(fwrite(contents, 1, strlen(contents), fp), strlen(contents));
+    fclose(fp);
+
+    f = inpfile_create_mapped(&name);
+    ck_assert_msg(f, "Failed to create a memory mapped input file");
+    ck_assert_msg(f->str.mapped_size == strlen(contents),
+                  "Input file was not memory mapped");
+    ck_assert_rf_str_eq_cstr(inpfile_str(f), contents);
+
+    // same line indexing as for input created from a string
+    ck_assert_uint_eq(f->str.lines_num, 5);
+    ck_assert_uint_eq(f->str.lines[0], 0);
+    ck_assert_uint_eq(f->str.lines[1], 10);
+    ck_assert_uint_eq(f->str.lines[2], 12);
+    ck_assert_uint_eq(f->str.lines[3], 22);
+    ck_assert_uint_eq(f->str.lines[4], 24);
+    ck_assert(inpfile_line(f, 2, &line_str));
+    ck_assert_rf_str_eq_cstr(&line_str, "    a = 1\n");
+
+    inpfile_acc_ws(f);
+    ck_assert_inpoffset_eq(inpfile_offset(f), 0, 0, 0);
+    inpfile_move(f, 10, 10);
+    inpfile_acc_ws(f);
+    ck_assert_inpoffset_eq(inpfile_offset(f), 10, 10, 1);
+    ck_assert_rf_str_eq_cstr(inpfile_str(f), "{\n    a = 1\n}\n");
+
+    inpfile_destroy(f);
+    rf_system_delete_file(&name);
+} END_TEST
+START_TEST(test_inpstr_ptr_to_linecol) {
+    struct inpfile *f;
+    struct front_ctx *front;
+    unsigned int line;
+    unsigned int col;
+    char *beg;
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "ab\n"
+        "\n"
+        "cdef\n"
+        "g");
+    front = front_testdriver_new_main_source(&s);
+    f = front->file;
+    ck_assert_msg(f, "Failed to assign string to file ");
+    beg = inpfile_sp(f);
+
+    ck_assert(inpstr_ptr_to_linecol(&f->str, beg, &line, &col));
+    ck_assert_uint_eq(line, 0);
+    ck_assert_uint_eq(col, 0);
+    ck_assert(inpstr_ptr_to_linecol(&f->str, beg + 2, &line, &col));
+    ck_assert_uint_eq(line, 0);
+    ck_assert_uint_eq(col, 2);
+    ck_assert(inpstr_ptr_to_linecol(&f->str, beg + 3, &line, &col));
+    ck_assert_uint_eq(line, 1);
+    ck_assert_uint_eq(col, 0);
+    ck_assert(inpstr_ptr_to_linecol(&f->str, beg + 4, &line, &col));
+    ck_assert_uint_eq(line, 2);
+    ck_assert_uint_eq(col, 0);
+    ck_assert(inpstr_ptr_to_linecol(&f->str, beg + 7, &line, &col));
+    ck_assert_uint_eq(line, 2);
+    ck_assert_uint_eq(col, 3);
+    // last line, including the position right after the last byte
+    ck_assert(inpstr_ptr_to_linecol(&f->str, beg + 9, &line, &col));
+    ck_assert_uint_eq(line, 3);
+    ck_assert_uint_eq(col, 0);
+    ck_assert(inpstr_ptr_to_linecol(&f->str, beg + 10, &line, &col));
+    ck_assert_uint_eq(line, 3);
+    ck_assert_uint_eq(col, 1);
+    // out of bounds
+    ck_assert(!inpstr_ptr_to_linecol(&f->str, beg + 11, &line, &col));
+} END_TEST
 
 Suite *frontend_input_suite_create(void)
 {
@@ -110,8 +254,25 @@ Suite *frontend_input_suite_create(void)
     tcase_add_test(whitespace, test_acc_ws_full);
     tcase_add_test(whitespace, test_acc_ws_none);
     tcase_add_test(whitespace, test_acc_ws_none_empty);
+    tcase_add_test(whitespace, test_acc_ws_comments);
+    tcase_add_test(whitespace, test_acc_ws_comment_at_eof);
+    tcase_add_test(whitespace, test_inpskip_matches_scalar);
+
+    TCase *linecol = tcase_create("inpstr_linecol");
+    tcase_add_checked_fixture(linecol,
+                              setup_front_tests,
+                              teardown_front_tests);
+    tcase_add_test(linecol, test_inpstr_ptr_to_linecol);
+
+    TCase *mapped = tcase_create("inpfile_mapped");
+    tcase_add_checked_fixture(mapped,
+                              setup_front_tests,
+                              teardown_front_tests);
+    tcase_add_test(mapped, test_inpfile_mapped);
 
     suite_add_tcase(s, whitespace);
+    suite_add_tcase(s, linecol);
+    suite_add_tcase(s, mapped);
     return s;
 }
 
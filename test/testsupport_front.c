@@ -168,7 +168,7 @@ struct front_ctx *front_testdriver_new_main_source(const struct RFstring *s)
     struct front_ctx *front = compiler_new_front_from_source(d->compiler, &name, s);
 
     ck_assert_msg(front, "Could not add a new file to the driver");
-    front->is_main = true; // this will trigger special behaviour in front parser finalization
+    front->is_main = true; // this will trigger special behaviour in front module registration
     // set new front as current
     d->current_front = front;
     return front;
@@ -217,11 +217,18 @@ struct ast_node *front_testdriver_generate_string_literal(
 {
     struct ast_node *ret;
     struct front_testdriver *d = get_front_testdriver();
+    struct inpfile *f = d->current_front->file;
     struct inplocation temp_loc = LOC_INIT_FULL(
-        sl, sc, el, ec,
-        inpfile_line_p(d->current_front->file, sl) + sl_byte_off,
-        inpfile_line_p(d->current_front->file, el) + el_byte_off);
-    ret = ast_string_literal_create(&temp_loc);
+        f,
+        inpfile_line_p(f, sl) + sl_byte_off,
+        inpfile_line_p(f, el) + el_byte_off);
+    // lines and columns are no longer stored in locations so make sure they
+    // resolve to what the test expects
+    ck_assert_uint_eq(inplocation_mark_line(&temp_loc.start, f), sl);
+    ck_assert_uint_eq(inplocation_mark_col(&temp_loc.start, f), sc);
+    ck_assert_uint_eq(inplocation_mark_line(&temp_loc.end, f), el);
+    ck_assert_uint_eq(inplocation_mark_col(&temp_loc.end, f), ec);
+    ret = ast_string_literal_create(&temp_loc, f);
     if (!ret) {
         return NULL;
     }
@@ -269,7 +276,7 @@ void front_testdriver_node_remove_children_from_array(struct front_testdriver *d
     struct ast_node *child;
     struct ast_node **arr_n;
     unsigned int i;
-    rf_ilist_for_each(&n->children, child, lh) {
+    ast_node_foreach_child(n, child) {
 
         front_testdriver_node_remove_children_from_array(d, child);
 
@@ -415,10 +422,10 @@ static bool check_nodes(struct ast_node *got, struct ast_node *expect,
         return false;
     }
 
-    rf_ilist_for_each(&got->children, child, lh) {
+    ast_node_foreach_child(got, child) {
         got_children ++;
     }
-    rf_ilist_for_each(&expect->children, child, lh) {
+    ast_node_foreach_child(expect, child) {
         expect_children ++;
     }
 
@@ -591,10 +598,10 @@ bool check_ast_match_impl(struct ast_node *got,
         return false;
     }
 
-    rf_ilist_for_each(&got->children, got_child, lh) {
+    ast_node_foreach_child(got, got_child) {
 
         j = 0;
-        rf_ilist_for_each(&expect->children, expect_child, lh) {
+        ast_node_foreach_child(expect, expect_child) {
             if (i == j &&
                 !check_ast_match_impl(got_child, expect_child, ifile, file, line)) {
                 return false;
@@ -132,10 +132,11 @@ void teardown_front_tests();
 #define ck_assert_ast_node_loc(i_node_, i_sline_, i_scol_, i_eline_, i_ecol_) \
     do {                                                                \
         struct inplocation *loc = &(i_node_)->location;                 \
-        ck_assert_uint_eq(loc->start.ine, (i_sline_));                  \
-        ck_assert_uint_eq(loc->start.col, (i_scol_));                   \
-        ck_assert_uint_eq(loc->end.line, (i_eline_));                   \
-        ck_assert_uint_eq(loc->end.col, (i_ecol_));                     \
+        struct inpfile *f_ = front_testdriver_file();                   \
+        ck_assert_uint_eq(inplocation_mark_line(&loc->start, f_), (i_sline_)); \
+        ck_assert_uint_eq(inplocation_mark_col(&loc->start, f_), (i_scol_)); \
+        ck_assert_uint_eq(inplocation_mark_line(&loc->end, f_), (i_eline_)); \
+        ck_assert_uint_eq(inplocation_mark_col(&loc->end, f_), (i_ecol_)); \
     } while(0)
 
 
@@ -168,7 +169,8 @@ bool check_ast_match_impl(struct ast_node *got,
     {                                                                   \
         .s = RF_STRING_STATIC_INIT(msg_),                               \
             .type = type_,                                              \
-            .start_mark = LOCMARK_INIT(get_front_testdriver()->current_front->file, sl_, sc_) \
+            .start_mark = LOCMARK_INIT(get_front_testdriver()->current_front->file, sl_, sc_), \
+            .end_mark = LOCMARK_INIT_ZERO()                             \
             }
 
 
@@ -1,5 +1,6 @@
 #include <check.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -244,6 +245,67 @@ START_TEST(test_types_set_has_uid2) {
     ck_assert(type_objset_has_uid(front_testdriver_module()->types_set, uid));
 } END_TEST
 
+START_TEST(test_types_set_extended_operator_has_uid) {
+    static const struct RFstring s = RF_STRING_STATIC_INIT(
+        "type foo { a:i8, b:string }\n"
+    );
+    front_testdriver_new_main_source(&s);
+    ck_assert_typecheck_ok();
+    struct module *m = front_testdriver_module();
+
+    struct type *t_i8 = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_INT_8, false);
+    struct type *t_string = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_STRING, false);
+    struct type *t_f32 = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_FLOAT_32, false);
+    struct type *t_ab = testsupport_analyzer_type_create_operator(TYPEOP_PRODUCT,
+                                                                  t_i8,
+                                                                  t_string);
+    struct type *t_abc = testsupport_analyzer_type_create_operator(TYPEOP_PRODUCT,
+                                                                   t_i8,
+                                                                   t_string,
+                                                                   t_f32);
+    size_t ab_uid = type_get_uid(t_ab);
+    size_t abc_uid = type_get_uid(t_abc);
+
+    // a,b is in the set and extending it in place should move it to the
+    // bucket of a,b,c
+    struct type *t = type_objset_has_uid(m->types_set, ab_uid);
+    ck_assert(t);
+    ck_assert(t == type_create_from_operation(TYPEOP_PRODUCT, t, t_f32, m));
+    ck_assert_uint_eq(type_get_uid(t), abc_uid);
+    ck_assert(type_objset_has_uid(m->types_set, abc_uid) == t);
+    ck_assert(type_objset_has_uid(m->types_set, ab_uid) != t);
+} END_TEST
+
+START_TEST(test_type_uid_is_structural) {
+    struct type *t_i8 = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_INT_8, false);
+    struct type *t_string = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_STRING, false);
+    struct type *t_f32 = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_FLOAT_32, false);
+    struct type *t_prod1 = testsupport_analyzer_type_create_operator(TYPEOP_PRODUCT,
+                                                                     t_i8,
+                                                                     t_string);
+    struct type *t_prod2 = testsupport_analyzer_type_create_operator(TYPEOP_PRODUCT,
+                                                                     t_i8,
+                                                                     t_string);
+    struct type *t_sum = testsupport_analyzer_type_create_operator(TYPEOP_SUM,
+                                                                   t_i8,
+                                                                   t_string);
+    struct type *t_prod3 = testsupport_analyzer_type_create_operator(TYPEOP_PRODUCT,
+                                                                     t_string,
+                                                                     t_i8);
+
+    // same structure, same uid
+    ck_assert_uint_eq(type_get_uid(t_prod1), type_get_uid(t_prod2));
+    ck_assert_uint_eq(type_get_uid(t_prod1),
+                      type_op_create_uid(t_i8, t_string, TYPEOP_PRODUCT));
+    // caching does not change the uid
+    type_cache_uid(t_prod2);
+    ck_assert_uint_eq(type_get_uid(t_prod1), type_get_uid(t_prod2));
+    // different operator or operand order, different uid
+    ck_assert_uint_ne(type_get_uid(t_prod1), type_get_uid(t_sum));
+    ck_assert_uint_ne(type_get_uid(t_prod1), type_get_uid(t_prod3));
+    ck_assert_uint_ne(type_get_uid(t_i8), type_get_uid(t_f32));
+} END_TEST
+
 START_TEST(test_types_set_has_string) {
     static const struct RFstring s = RF_STRING_STATIC_INIT(
         "type foo { a:i8, b:string | c:f32, d:u64, e:u8 }\n"
@@ -257,6 +319,37 @@ START_TEST(test_types_set_has_string) {
     ck_assert(!type_objset_has_string(front_testdriver_module()->types_set, &s2));
 } END_TEST
 
+#define MANY_TYPES_NUM 2048
+START_TEST(test_types_set_many_typedecls) {
+    // every type refers to the previous one so none of them share operands
+    static char buff[MANY_TYPES_NUM * 48 + 128];
+    struct RFstring s;
+    struct type *t;
+    struct rf_objset_iter it;
+    unsigned int i;
+    unsigned int found = 0;
+    size_t len = 0;
+    len += sprintf(buff + len, "type t0 { a:i32, b:f32 }\n");
+    for (i = 1; i < MANY_TYPES_NUM; ++i) {
+        len += sprintf(buff + len, "type t%u { a:i32, b:f32, c:t%u }\n", i, i - 1);
+    }
+    // same structure as t0, so it should reuse its anonymous type
+    len += sprintf(buff + len, "type u { x:i32, y:f32 }\n");
+    RF_STRING_SHALLOW_INIT(&s, buff, len);
+    front_testdriver_new_main_source(&s);
+    ck_assert_typecheck_ok();
+
+    struct type *t_i32 = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_INT_32, false);
+    struct type *t_f32 = testsupport_analyzer_type_create_elementary(ELEMENTARY_TYPE_FLOAT_32, false);
+    size_t uid = type_op_create_uid(t_i32, t_f32, TYPEOP_PRODUCT);
+    rf_objset_foreach(front_testdriver_module()->types_set, &it, t) {
+        if (type_get_uid(t) == uid) {
+            ++found;
+        }
+    }
+    ck_assert_uint_eq(found, 1);
+} END_TEST
+
 Suite *type_set_suite_create(void)
 {
     Suite *s = suite_create("type_set");
@@ -272,13 +365,23 @@ Suite *type_set_suite_create(void)
     tcase_add_checked_fixture(st2, setup_analyzer_tests, teardown_analyzer_tests);
     tcase_add_test(st2, test_types_set_has_uid1);
     tcase_add_test(st2, test_types_set_has_uid2);
+    tcase_add_test(st2, test_types_set_extended_operator_has_uid);
+    tcase_add_test(st2, test_type_uid_is_structural);
 
     TCase *st3 = tcase_create("types_set_has_string");
     tcase_add_checked_fixture(st3, setup_analyzer_tests, teardown_analyzer_tests);
     tcase_add_test(st3, test_types_set_has_string);
 
+    TCase *st4 = tcase_create("types_set_many_typedecls");
+    tcase_add_checked_fixture(st4, setup_analyzer_tests, teardown_analyzer_tests);
+    // analyzing MANY_TYPES_NUM typedecls takes longer than check's default
+    // 4 second timeout on slow or instrumented builds
+    tcase_set_timeout(st4, 30);
+    tcase_add_test(st4, test_types_set_many_typedecls);
+
     suite_add_tcase(s, st1);
     suite_add_tcase(s, st2);
     suite_add_tcase(s, st3);
+    suite_add_tcase(s, st4);
     return s;
 }